@@ -2,6 +2,12 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <cassert>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "ad/cppgtfs/gtfs/Feed.h"
 #include "gtfs2graph/builder/Builder.h"
 #include "gtfs2graph/graph/BuildGraph.h"
@@ -10,6 +16,11 @@
 #include "util/geo/Geo.h"
 #include "util/geo/Grid.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 
 using namespace gtfs2graph;
 using namespace graph;
@@ -27,6 +38,7 @@ using graph::Edge;
 using graph::Node;
 
 using ad::cppgtfs::gtfs::Feed;
+using ad::cppgtfs::gtfs::Route;
 using ad::cppgtfs::gtfs::Shape;
 using ad::cppgtfs::gtfs::Stop;
 using ad::cppgtfs::gtfs::StopTime;
@@ -42,29 +54,85 @@ void Builder::consume(const Feed& f, BuildGraph* g) {
 
   NodeGrid ngrid(2000, 2000, graphBox);
 
-  size_t i = 0;
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+
+  // trips of the same route with the same shape and stop sequence have the
+  // same geometries and the same effect on the graph, they are only added
+  // once per such pattern, together with the number of trips they stand for
+  std::vector<Trip*> pats;
+  std::vector<size_t> patTrips;
+  std::map<std::tuple<const Route*, const Shape*, std::vector<const Stop*>>,
+           size_t>
+      patIds;
+  size_t numTrips = 0;
 
   for (auto t = f.getTrips().begin(); t != f.getTrips().end(); ++t) {
-    i++;
     // ignore trips with only one stop
     if (t->second->getStopTimes().size() < 2) continue;
     if (!_cfg->useMots.count(t->second->getRoute()->getType())) continue;
 
-    auto st = t->second->getStopTimes().begin();
+    std::vector<const Stop*> stops;
+    for (const auto& st : t->second->getStopTimes()) {
+      stops.push_back(st.getStop());
+    }
+
+    auto key = std::make_tuple(t->second->getRoute(), t->second->getShape(),
+                               std::move(stops));
+
+    auto pat = patIds.insert({std::move(key), pats.size()});
+    if (pat.second) {
+      pats.push_back(t->second);
+      patTrips.push_back(0);
+    }
+
+    patTrips[pat.first->second]++;
+    numTrips++;
+  }
 
-    auto prev = *st;
+  LOGTO(DEBUG, std::cerr) << numTrips << " trips, " << pats.size()
+                          << " patterns";
+
+  projectShapes(pats, threads);
+
+  // geometries between the consecutive distinct stops of each pattern
+  std::vector<std::vector<PolyLine<double>>> patGeoms(pats.size());
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+  for (size_t i = 0; i < pats.size(); i++) {
+    const auto& sts = pats[i]->getStopTimes();
+    auto prev = sts.begin();
+    for (auto st = std::next(sts.begin()); st != sts.end(); ++st) {
+      if (st->getStop() == prev->getStop()) continue;
+      patGeoms[i].push_back(getSubPolyLine(prev->getStop(), st->getStop(),
+                                           pats[i],
+                                           prev->getShapeDistanceTravelled(),
+                                           st->getShapeDistanceTravelled())
+                                .second);
+      prev = st;
+    }
+  }
+
+  for (size_t i = 0; i < pats.size(); i++) {
+    auto t = pats[i];
+    const auto& geoms = patGeoms[i];
+
+    auto st = t->getStopTimes().begin();
+
+    const Stop* prev = st->getStop();
     const Edge* prevEdge = 0;
-    addStop(prev.getStop(), g, &ngrid);
+    addStop(prev, g, &ngrid);
     ++st;
 
     if (i % 100 == 0)
-      LOGTO(DEBUG, std::cerr) << "@ trip " << i << "/" << f.getTrips().size();
+      LOGTO(DEBUG, std::cerr) << "@ pattern " << i << "/" << pats.size();
+
+    size_t j = 0;
 
-    for (; st != t->second->getStopTimes().end(); ++st) {
-      const auto& cur = *st;
+    for (; st != t->getStopTimes().end(); ++st) {
+      const Stop* cur = st->getStop();
 
-      Node* fromNode = getNodeByStop(g, prev.getStop());
-      Node* toNode = addStop(cur.getStop(), g, &ngrid);
+      Node* fromNode = getNodeByStop(g, prev);
+      Node* toNode = addStop(cur, g, &ngrid);
 
       // TODO: we should also allow this, for round-trips
       if (fromNode == toNode) continue;
@@ -78,16 +146,11 @@ void Builder::consume(const Feed& f, BuildGraph* g) {
 
       Node* directionNode = toNode;
 
-      std::pair<bool, PolyLine<double>> edgeGeom;
-      edgeGeom = getSubPolyLine(prev.getStop(), cur.getStop(), t->second,
-                                prev.getShapeDistanceTravelled(),
-                                cur.getShapeDistanceTravelled());
-
       if (prevEdge) {
-        fromNode->pl().connOccurs(t->second->getRoute(), prevEdge, exE);
+        fromNode->pl().connOccurs(t->getRoute(), prevEdge, exE);
       }
 
-      exE->pl().addTrip(t->second, edgeGeom.second, directionNode);
+      exE->pl().addTrip(t, geoms[j++], directionNode, patTrips[i]);
 
       prev = cur;
       prevEdge = exE;
@@ -95,6 +158,27 @@ void Builder::consume(const Feed& f, BuildGraph* g) {
   }
 }
 
+// _____________________________________________________________________________
+void Builder::projectShapes(const std::vector<Trip*>& trips, size_t threads) {
+  std::vector<Shape*> shapes;
+
+  // insert the (empty) polylines first, the projection below then only
+  // writes to existing values and can run in parallel
+  for (auto t : trips) {
+    if (!t->getShape() || _polyLines.count(t->getShape())) continue;
+    _polyLines[t->getShape()];
+    shapes.push_back(t->getShape());
+  }
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+  for (size_t i = 0; i < shapes.size(); i++) {
+    auto& pl = _polyLines.find(shapes[i])->second;
+    for (const auto& sp : shapes[i]->getPoints()) {
+      pl << getProjP(sp.lat, sp.lng);
+    }
+  }
+}
+
 // _____________________________________________________________________________
 DPoint Builder::getProjP(double lat, double lng) const {
   return util::geo::latLngToWebMerc<double>(lat, lng);
@@ -110,7 +194,7 @@ void Builder::simplify(BuildGraph* g) {
       if (e->getFrom() != n) continue;
       for (auto& etg : *e->pl().getEdgeTripGeoms()) {
         for (auto& r : *etg.getTripsUnordered()) {
-          avg += r.trips.size();
+          avg += r.numTrips;
           c++;
         }
       }
@@ -141,10 +225,9 @@ void Builder::simplify(BuildGraph* g) {
 }
 
 // _____________________________________________________________________________
-std::pair<bool, PolyLine<double>> Builder::getSubPolyLine(const Stop* a,
-                                                          const Stop* b,
-                                                          Trip* t, double distA,
-                                                          double distB) {
+std::pair<bool, PolyLine<double>> Builder::getSubPolyLine(
+    const Stop* a, const Stop* b, Trip* t, double distA,
+    double distB) const {
   UNUSED(distA);
   UNUSED(distB);
   DPoint ap = getProjP(a->getLat(), a->getLng());
@@ -154,18 +237,9 @@ std::pair<bool, PolyLine<double>> Builder::getSubPolyLine(const Stop* a,
     return std::pair<bool, PolyLine<double>>(false, PolyLine<double>(ap, bp));
   }
 
+  // the shape has been projected in projectShapes()
   auto pl = _polyLines.find(t->getShape());
-  if (pl == _polyLines.end()) {
-    // generate polyline for this shape
-    pl = _polyLines
-             .insert(std::pair<Shape*, PolyLine<double>>(t->getShape(),
-                                                         PolyLine<double>()))
-             .first;
-
-    for (const auto& sp : t->getShape()->getPoints()) {
-      pl->second << getProjP(sp.lat, sp.lng);
-    }
-  }
+  assert(pl != _polyLines.end());
 
   PolyLine<double> p;
 
@@ -196,13 +270,9 @@ Node* Builder::addStop(const Stop* curStop, BuildGraph* g, NodeGrid* grid) {
 
 // _____________________________________________________________________________
 Node* Builder::getNodeByStop(const BuildGraph* g, const gtfs::Stop* s) const {
-  if (_stopNodes.find(s) != _stopNodes.end()) return _stopNodes.find(s)->second;
-
-  for (const auto n : g->getNds()) {
-    if (n->pl().getStops().find(const_cast<gtfs::Stop*>(s)) !=
-        n->pl().getStops().end()) {
-      return n;
-    }
-  }
+  UNUSED(g);
+  // every stop node is created in addStop(), which indexes it in _stopNodes
+  auto n = _stopNodes.find(s);
+  if (n != _stopNodes.end()) return n->second;
   return 0;
 }
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include <vector>
 #include "ad/cppgtfs/gtfs/Feed.h"
 #include "gtfs2graph/config/GraphBuilderConfig.h"
 #include "gtfs2graph/graph/BuildGraph.h"
@@ -53,9 +54,13 @@ class Builder {
 
   DPoint getProjP(double lat, double lng) const;
 
+  // project the shapes of trips into _polyLines
+  void projectShapes(const std::vector<ad::cppgtfs::gtfs::Trip*>& trips,
+                     size_t threads);
+
   std::pair<bool, PolyLine<double>> getSubPolyLine(
       const ad::cppgtfs::gtfs::Stop* a, const ad::cppgtfs::gtfs::Stop* b,
-      ad::cppgtfs::gtfs::Trip* t, double distA, double distB);
+      ad::cppgtfs::gtfs::Trip* t, double distA, double distB) const;
 
   Node* addStop(const ad::cppgtfs::gtfs::Stop* curStop, BuildGraph* g,
                 NodeGrid* grid);
@@ -52,8 +52,13 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(35) << " "
             << "  funicular, coach} or as GTFS mot codes\n"
             << std::setw(35) << "  -p [ --prune-threshold ] arg (=0.0)"
-            << "Threshold for pruning of seldomly occuring lines, between 0 and 1"
-;
+            << "Threshold for pruning of seldomly occuring lines,\n"
+            << std::setw(35) << " "
+            << "between 0 and 1\n"
+            << std::setw(35) << "  --threads arg (=0)"
+            << "Number of threads used for the trip geometries,\n"
+            << std::setw(35) << " "
+            << "0 means all available cores\n";
 }
 
 // _____________________________________________________________________________
@@ -65,6 +70,7 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"help", no_argument, 0, 'h'},
                          {"mots", required_argument, 0, 'm'},
                          {"prune-threshold", required_argument, 0, 'p'},
+                         {"threads", required_argument, 0, 1},
                          {0, 0, 0, 0}};
 
   char c;
@@ -82,6 +88,9 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 'p':
         pruneThreshold = atof(optarg);
         break;
+      case 1:
+        cfg->threads = atoi(optarg);
+        break;
       case ':':
         std::cerr << argv[optind - 1];
         std::cerr << " requires an argument" << std::endl;
@@ -17,6 +17,9 @@ struct Config {
   double pruneThreshold;
 
   std::set<ad::cppgtfs::gtfs::flat::Route::TYPE> useMots;
+
+  // number of threads used for the trip geometries, 0 means all available
+  size_t threads = 0;
 };
 
 }  // namespace config
@@ -27,12 +27,13 @@ EdgePL::EdgePL() : _e(0) {}
 void EdgePL::setEdge(const Edge* e) { _e = e; }
 
 // _____________________________________________________________________________
-bool EdgePL::addTrip(gtfs::Trip* t, PolyLine<double> pl, Node* toNode) {
+bool EdgePL::addTrip(gtfs::Trip* t, PolyLine<double> pl, Node* toNode,
+                     size_t n) {
   assert(toNode == _e->getFrom() || toNode == _e->getTo());
   bool inserted = false;
   for (auto& e : _tripsContained) {
     if (e.getGeom().equals(pl, 10)) {
-      e.addTrip(t, toNode, pl);
+      e.addTrip(t, toNode, pl, n);
       inserted = true;
       break;
     }
@@ -40,7 +41,7 @@ bool EdgePL::addTrip(gtfs::Trip* t, PolyLine<double> pl, Node* toNode) {
 
   if (!inserted) {
     EdgeTripGeom etg(pl, toNode);
-    etg.addTrip(t, toNode);
+    etg.addTrip(t, toNode, n);
     addEdgeTripGeom(etg);
   }
 
@@ -92,7 +93,7 @@ void EdgePL::simplify(double pruneThreshold) {
     auto etg = *eit;
     auto it = etg.getTripsUnordered()->begin();
     while (it != etg.getTripsUnordered()->end()) {
-      if (it->trips.size() < pruneThreshold) {
+      if (it->numTrips < pruneThreshold) {
         it = etg.getTripsUnordered()->erase(it);
       } else {
         it++;
@@ -130,11 +131,7 @@ void EdgePL::averageCombineGeom() {
   EdgeTripGeom combined(pl, _e->getTo());
 
   for (auto& et : _tripsContained) {
-    for (auto& r : *et.getTripsUnordered()) {
-      for (auto& t : r.trips) {
-        combined.addTrip(t, r.direction);
-      }
-    }
+    for (auto& r : *et.getTripsUnordered()) combined.addRouteOcc(r);
   }
 
   _tripsContained.clear();
@@ -154,9 +151,7 @@ void EdgePL::combineIncludedGeoms() {
           toCheckAgainst.getGeom().contains(et->getGeom(), 50) &&
           !et->getGeom().contains(toCheckAgainst.getGeom(), 50)) {
         for (auto& r : *et->getTripsUnordered()) {
-          for (auto& t : r.trips) {
-            toCheckAgainst.addTrip(t, r.direction);
-          }
+          toCheckAgainst.addRouteOcc(r);
         }
         combined = true;
         break;
@@ -189,6 +184,7 @@ util::json::Dict EdgePL::getAttrs() const {
     route["id"] = util::toString(r.route);
     route["label"] = r.route->getShortName();
     route["color"] = r.route->getColorString();
+    route["trips"] = r.numTrips;
 
     if (r.direction != 0) {
       route["direction"] = util::toString(r.direction);
@@ -25,7 +25,9 @@ class EdgePL : public util::geograph::GeoEdgePL<double> {
   EdgePL(const Edge* e);
   EdgePL();
 
-  bool addTrip(gtfs::Trip* t, util::geo::PolyLine<double> pl, Node* toNode);
+  // add trip t standing for n trips with the same pattern
+  bool addTrip(gtfs::Trip* t, util::geo::PolyLine<double> pl, Node* toNode,
+               size_t n);
 
   void setEdge(const Edge* e);
 
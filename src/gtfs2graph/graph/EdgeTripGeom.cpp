@@ -21,23 +21,45 @@ EdgeTripGeom::EdgeTripGeom(PolyLine<double> geom, const Node* geomDir)
 
 // _____________________________________________________________________________
 void EdgeTripGeom::addTrip(gtfs::Trip* t, const Node* dirNode,
-                           PolyLine<double>& pl) {
+                           PolyLine<double>& pl, size_t n) {
   if (dirNode != _geomDir) pl.reverse();
 
   // TODO: only do this if they are equal within some threshold!
-  setGeom(PolyLine<double>::average({&_geom, &pl}));
+  // weight both geometries by the number of trips they stand for, which
+  // gives the mean geometry of all trips added so far
+  double w = getTripCardinality();
+  setGeom(PolyLine<double>::average({&_geom, &pl},
+                                    {w, static_cast<double>(n)}));
 
-  addTrip(t, dirNode);
+  addTrip(t, dirNode, n);
 }
 
 // _____________________________________________________________________________
-void EdgeTripGeom::addTrip(gtfs::Trip* t, const Node* dirNode) {
+void EdgeTripGeom::addTrip(gtfs::Trip* t, const Node* dirNode, size_t n) {
   RouteOccurance* to = getRouteOcc(t->getRoute());
   if (!to) {
     _routeOccs.push_back(RouteOccurance(t->getRoute()));
     to = &_routeOccs.back();
   }
-  to->addTrip(t, dirNode);
+  to->addTrip(t, dirNode, n);
+}
+
+// _____________________________________________________________________________
+void EdgeTripGeom::addRouteOcc(const RouteOccurance& r) {
+  RouteOccurance* to = getRouteOcc(r.route);
+  if (!to) {
+    _routeOccs.push_back(RouteOccurance(r.route));
+    to = &_routeOccs.back();
+  }
+
+  if (to->trips.size() == 0) {
+    to->direction = r.direction;
+  } else {
+    if (to->direction && to->direction != r.direction) to->direction = 0;
+  }
+
+  to->trips.insert(to->trips.end(), r.trips.begin(), r.trips.end());
+  to->numTrips += r.numTrips;
 }
 
 // _____________________________________________________________________________
@@ -74,7 +96,7 @@ bool EdgeTripGeom::containsRoute(gtfs::Route* r) const {
 size_t EdgeTripGeom::getTripCardinality() const {
   size_t ret = 0;
 
-  for (auto& t : _routeOccs) ret += t.trips.size();
+  for (auto& t : _routeOccs) ret += t.numTrips;
 
   return ret;
 }
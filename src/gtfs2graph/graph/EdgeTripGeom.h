@@ -15,17 +15,25 @@ namespace gtfs2graph {
 namespace graph {
 
 struct RouteOccurance {
-  RouteOccurance(ad::cppgtfs::gtfs::Route* r) : route(r), direction(0) {}
-  void addTrip(ad::cppgtfs::gtfs::Trip* t, const Node* dirNode) {
+  RouteOccurance(ad::cppgtfs::gtfs::Route* r)
+      : route(r), numTrips(0), direction(0) {}
+  void addTrip(ad::cppgtfs::gtfs::Trip* t, const Node* dirNode, size_t n) {
     if (trips.size() == 0) {
       direction = dirNode;
     } else {
       if (direction && direction != dirNode) direction = 0;
     }
     trips.push_back(t);
+    numTrips += n;
   }
   ad::cppgtfs::gtfs::Route* route;
+
+  // one representative trip per trip pattern, each standing for one or more
+  // trips of the feed
   std::vector<ad::cppgtfs::gtfs::Trip*> trips;
+
+  // the total number of trips of this route
+  size_t numTrips;
   const Node* direction;  // 0 if in both directions
 };
 
@@ -35,9 +43,13 @@ class EdgeTripGeom {
  public:
   EdgeTripGeom(util::geo::PolyLine<double> pl, const Node* geomDir);
 
+  // add trip t standing for n trips with the same pattern
   void addTrip(ad::cppgtfs::gtfs::Trip* t, const Node* dirNode,
-               util::geo::PolyLine<double>& pl);
-  void addTrip(ad::cppgtfs::gtfs::Trip* t, const Node* dirNode);
+               util::geo::PolyLine<double>& pl, size_t n);
+  void addTrip(ad::cppgtfs::gtfs::Trip* t, const Node* dirNode, size_t n);
+
+  // add all trips of route occurance r
+  void addRouteOcc(const RouteOccurance& r);
 
   const std::vector<RouteOccurance>& getTripsUnordered() const;
   std::vector<RouteOccurance>* getTripsUnordered();
@@ -0,0 +1,184 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include "ad/cppgtfs/Parser.h"
+#include "gtfs2graph/builder/Builder.h"
+#include "gtfs2graph/config/GraphBuilderConfig.h"
+#include "gtfs2graph/graph/BuildGraph.h"
+#include "gtfs2graph/graph/EdgePL.h"
+#include "gtfs2graph/graph/NodePL.h"
+#include "gtfs2graph/tests/BuilderTest.h"
+#include "util/Misc.h"
+#include "util/geo/Geo.h"
+
+using gtfs2graph::Builder;
+using gtfs2graph::graph::BuildGraph;
+using gtfs2graph::graph::Edge;
+using gtfs2graph::graph::Node;
+using gtfs2graph::graph::RouteOccurance;
+using util::geo::DPoint;
+
+namespace {
+
+// _____________________________________________________________________________
+void writeFile(const std::string& dir, const std::string& name,
+               const std::string& content) {
+  std::ofstream f(dir + "/" + name);
+  f << content;
+}
+
+// _____________________________________________________________________________
+const Edge* getEdge(const BuildGraph& g, const std::string& a,
+                    const std::string& b) {
+  for (auto n : g.getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      auto from = (*e->getFrom()->pl().getStops().begin())->getId();
+      auto to = (*e->getTo()->pl().getStops().begin())->getId();
+      if ((from == a && to == b) || (from == b && to == a)) return e;
+    }
+  }
+  return 0;
+}
+
+// _____________________________________________________________________________
+const RouteOccurance* getRouteOcc(const Edge* e, const std::string& route) {
+  for (const auto& etg : e->pl().getEdgeTripGeoms()) {
+    for (const auto& r : etg.getTripsUnordered()) {
+      if (r.route->getId() == route) return &r;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+// _____________________________________________________________________________
+void BuilderTest::run() {
+  {
+    /*
+     *     A (3 trips, shape sa), A (1 trip, shape sb)    B (2 trips)
+     *  s1 ------------------------------------------ s2 ----------- s3
+     */
+    std::string dir = util::getTmpDir() + "/gtfs2graphTest.XXXXXX";
+    TEST(mkdtemp(&dir[0]));
+
+    writeFile(dir, "agency.txt",
+              "agency_name,agency_url,agency_timezone\n"
+              "test,http://example.com,Europe/Berlin\n");
+    writeFile(dir, "stops.txt",
+              "stop_id,stop_name,stop_lat,stop_lon\n"
+              "s1,S1,48.0,7.8\n"
+              "s2,S2,48.0,7.81\n"
+              "s3,S3,48.0,7.82\n");
+    writeFile(dir, "routes.txt",
+              "route_id,route_short_name,route_long_name,route_type\n"
+              "A,A,,3\n"
+              "B,B,,3\n");
+    writeFile(dir, "calendar.txt",
+              "service_id,monday,tuesday,wednesday,thursday,friday,saturday,"
+              "sunday,start_date,end_date\n"
+              "all,1,1,1,1,1,1,1,20200101,20201231\n");
+
+    // two slightly different shapes between s1 and s2, 3.3m north and south
+    // of the straight line
+    writeFile(dir, "shapes.txt",
+              "shape_id,shape_pt_lat,shape_pt_lon,shape_pt_sequence\n"
+              "sa,48.0,7.8,1\n"
+              "sa,48.00002,7.805,2\n"
+              "sa,48.0,7.81,3\n"
+              "sb,48.0,7.8,1\n"
+              "sb,47.99998,7.805,2\n"
+              "sb,48.0,7.81,3\n");
+    writeFile(dir, "trips.txt",
+              "route_id,service_id,trip_id,shape_id\n"
+              "A,all,a1,sa\n"
+              "A,all,a2,sa\n"
+              "A,all,a3,sa\n"
+              "A,all,a4,sb\n"
+              "B,all,b1,\n"
+              "B,all,b2,\n");
+    writeFile(dir, "stop_times.txt",
+              "trip_id,arrival_time,departure_time,stop_id,stop_sequence\n"
+              "a1,10:00:00,10:00:00,s1,1\n"
+              "a1,10:05:00,10:05:00,s2,2\n"
+              "a2,11:00:00,11:00:00,s1,1\n"
+              "a2,11:05:00,11:05:00,s2,2\n"
+              "a3,12:00:00,12:00:00,s1,1\n"
+              "a3,12:05:00,12:05:00,s2,2\n"
+              "a4,13:00:00,13:00:00,s1,1\n"
+              "a4,13:05:00,13:05:00,s2,2\n"
+              "b1,10:00:00,10:00:00,s2,1\n"
+              "b1,10:05:00,10:05:00,s3,2\n"
+              "b2,11:00:00,11:00:00,s3,1\n"
+              "b2,11:05:00,11:05:00,s2,2\n");
+
+    ad::cppgtfs::Parser parser;
+    ad::cppgtfs::gtfs::Feed feed;
+    parser.parse(&feed, dir);
+
+    gtfs2graph::config::Config cfg;
+    cfg.pruneThreshold = 0;
+    for (auto mot : ad::cppgtfs::gtfs::flat::Route::getTypesFromString("bus")) {
+      cfg.useMots.insert(mot);
+    }
+
+    BuildGraph g;
+    Builder b(&cfg);
+    b.consume(feed, &g);
+
+    TEST(g.getNds().size(), ==, 3);
+
+    auto e12 = getEdge(g, "s1", "s2");
+    auto e23 = getEdge(g, "s2", "s3");
+    TEST(e12);
+    TEST(e23);
+
+    // both shapes of route A are close enough to be merged
+    TEST(e12->pl().getEdgeTripGeoms().size(), ==, 1);
+
+    auto a = getRouteOcc(e12, "A");
+    TEST(a);
+    TEST(a->numTrips, ==, 4);
+
+    // one representative trip per pattern
+    TEST(a->trips.size(), ==, 2);
+    TEST(a->direction);
+
+    auto bo = getRouteOcc(e23, "B");
+    TEST(bo);
+    TEST(bo->numTrips, ==, 2);
+    TEST(!bo->direction);
+
+    auto attrs = e12->pl().getAttrs();
+    TEST(attrs["lines"].arr.size(), ==, 1);
+    TEST(attrs["lines"].arr[0].dict["trips"].ui, ==, 4);
+
+    attrs = e23->pl().getAttrs();
+    TEST(attrs["lines"].arr.size(), ==, 1);
+    TEST(attrs["lines"].arr[0].dict["trips"].ui, ==, 2);
+    TEST(!attrs["lines"].arr[0].dict.count("direction"));
+
+    // the merged geometry is weighted by the number of trips of each
+    // pattern, and lies 3/4 of the way from shape sb towards shape sa
+    auto mid = e12->pl().getEdgeTripGeoms()[0].getGeom().getPointAt(0.5).p;
+    DPoint sa = util::geo::latLngToWebMerc<double>(48.00002, 7.805);
+    DPoint sb = util::geo::latLngToWebMerc<double>(47.99998, 7.805);
+    double exp = sb.getY() + (sa.getY() - sb.getY()) * 0.75;
+    TEST(fabs(mid.getY() - exp), <, 0.5);
+
+    unlink((dir + "/agency.txt").c_str());
+    unlink((dir + "/stops.txt").c_str());
+    unlink((dir + "/routes.txt").c_str());
+    unlink((dir + "/calendar.txt").c_str());
+    unlink((dir + "/shapes.txt").c_str());
+    unlink((dir + "/trips.txt").c_str());
+    unlink((dir + "/stop_times.txt").c_str());
+    rmdir(dir.c_str());
+  }
+}
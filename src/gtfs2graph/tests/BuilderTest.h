@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef GTFS2GRAPH_TEST_BUILDERTEST_H_
+#define GTFS2GRAPH_TEST_BUILDERTEST_H_
+
+class BuilderTest {
+  public:
+    void run();
+};
+
+#endif
@@ -1,12 +1,15 @@
 // Copyright 2016
 // Author: Patrick Brosi
 
+#include "gtfs2graph/tests/BuilderTest.h"
+
 #include "util/Misc.h"
 
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
+  BuilderTest bt;
 
-  return 0;
+  bt.run();
 }
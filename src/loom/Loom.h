@@ -0,0 +1,23 @@
+// Copyright 2016
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#ifndef LOOM_LOOM_H_
+#define LOOM_LOOM_H_
+
+#include "loom/config/LoomConfig.h"
+#include "shared/rendergraph/RenderGraph.h"
+#include "util/json/Writer.h"
+
+namespace loom {
+
+// Optimizes the line orderings of g with the method set in
+// cfg->optimMethod. Used by the loom tool and by loomserver. The returned
+// statistics are only set if cfg->outputStats is set. Throws a
+// std::runtime_error on an unknown optimization method.
+util::json::Dict run(const config::Config* cfg,
+                     shared::rendergraph::RenderGraph* g);
+
+}  // namespace loom
+
+#endif  // LOOM_LOOM_H_
@@ -49,6 +49,14 @@ void ConfigReader::help(const char* bin) const {
             << " comb, exhaust, hillc, hillc-random, anneal,\n"
             << std::setw(41) << " "
             << " anneal-random, greedy, greedy-lookahead, null\n"
+            << std::setw(41) << "  --exhaust-max-sol-space arg (=1e20)"
+            << "Max solution space size of components\n"
+            << std::setw(41) << " "
+            << " optimized by exhaust\n"
+            << std::setw(41) << "  --comb-exhaust-sol-space arg (=1e7)"
+            << "Max solution space size of components\n"
+            << std::setw(41) << " "
+            << " optimized by exhaust in comb\n"
             << std::setw(41) << "  --same-seg-cross-pen arg (=4)"
             << "Penalty for same-segment crossings\n"
             << std::setw(41) << "  --diff-seg-cross-pen arg (=1)"
@@ -66,10 +74,20 @@ void ConfigReader::help(const char* bin) const {
             << "input is in dot format\n"
             << std::setw(41) << "  --output-stats"
             << "Print stats to output\n"
+            << std::setw(41) << "  --format arg (=geojson)"
+            << "Output format, 'geojson' or 'binary'\n"
             << std::setw(41) << "  --ilp-solver arg (=gurobi)"
             << "Preferred ILP solver, either glpk, cbc, or gurobi.\n"
             << std::setw(41) << " "
             << "Will fall back if not available.\n"
+            << std::setw(41) << "  --threads arg (=0)"
+            << "Number of threads used to optimize components\n"
+            << std::setw(41) << " "
+            << " in parallel, 0 means all available cores\n"
+            << std::setw(41) << "  --seed arg (=0)"
+            << "Random seed for randomized optimizers,\n"
+            << std::setw(41) << " "
+            << " 0 means random\n"
             << std::setw(41) << "  --ilp-num-threads arg (=0)"
             << "Number of threads to use by ILP solver,\n"
             << std::setw(41) << " "
@@ -104,6 +122,11 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       {"optim-runs", required_argument, 0, 13},
       {"dbg-output-path", required_argument, 0, 14},
       {"output-optgraph", required_argument, 0, 15},
+      {"threads", required_argument, 0, 16},
+      {"seed", required_argument, 0, 17},
+      {"format", required_argument, 0, 18},
+      {"exhaust-max-sol-space", required_argument, 0, 19},
+      {"comb-exhaust-sol-space", required_argument, 0, 20},
       {0, 0, 0, 0}};
 
   char c;
@@ -152,7 +175,7 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
         cfg->ilpTimeLimit = atof(optarg);
         break;
       case 12:
-        cfg->ilpSolver = atof(optarg);
+        cfg->ilpSolver = optarg;
         break;
       case 13:
         cfg->optimRuns = atoi(optarg);
@@ -163,6 +186,21 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 15:
         cfg->outOptGraph = true;
         break;
+      case 16:
+        cfg->threads = atoi(optarg);
+        break;
+      case 17:
+        cfg->seed = atol(optarg);
+        break;
+      case 18:
+        cfg->outFormat = optarg;
+        break;
+      case 19:
+        cfg->exhaustMaxSolSpace = atof(optarg);
+        break;
+      case 20:
+        cfg->combExhaustMaxSolSpace = atof(optarg);
+        break;
       case 'D':
         cfg->fromDot = true;
         break;
@@ -181,4 +219,10 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
         break;
     }
   }
+
+  if (cfg->outFormat != "geojson" && cfg->outFormat != "binary") {
+    std::cerr << "Unknown output format " << cfg->outFormat
+              << ", must be one of {geojson, binary}" << std::endl;
+    exit(1);
+  }
 }
@@ -20,6 +20,21 @@ struct Config {
 
   size_t optimRuns = 1;
 
+  // number of threads used to optimize independent components, 0 means
+  // all available cores
+  size_t threads = 0;
+
+  // base seed for randomized optimizers, 0 means random
+  size_t seed = 0;
+
+  // the exhaustive optimizer refuses components with a larger solution
+  // space
+  double exhaustMaxSolSpace = 1e20;
+
+  // the comb optimizer searches components up to this solution space size
+  // exhaustively
+  double combExhaustMaxSolSpace = 1e7;
+
   bool outOptGraph = false;
 
   bool outputStats = false;
@@ -27,6 +42,7 @@ struct Config {
 
   bool untangleGraph = true;
   bool fromDot = false;
+  std::string outFormat = "geojson";
 
   int ilpTimeLimit = -1;
   int ilpNumThreads = 0;
@@ -40,7 +56,7 @@ struct Config {
 
   std::string worldFilePath;
 
-  std::string ilpSolver;
+  std::string ilpSolver = "gurobi";
 };
 
 }  // namespace config
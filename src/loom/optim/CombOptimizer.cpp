@@ -32,7 +32,7 @@ double CombOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
 
   if (maxC == 1) {
     return _nullOpt.optimizeComp(og, g, hc, depth + 1, stats);
-  } else if (solSp < 500) {
+  } else if (solSp <= _cfg->combExhaustMaxSolSpace) {
     return _exhausOpt.optimizeComp(og, g, hc, depth + 1, stats);
   } else {
 #if defined GUROBI_FOUND || defined GLPK_FOUND || defined CBC_FOUND
@@ -0,0 +1,522 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include "loom/optim/DeltaScorer.h"
+#include "shared/linegraph/Line.h"
+
+using loom::optim::DeltaScorer;
+using loom::optim::OptEdge;
+using loom::optim::OptGraph;
+using loom::optim::OptLO;
+using loom::optim::OptNode;
+using loom::optim::OptOrderCfg;
+
+// _____________________________________________________________________________
+DeltaScorer::DeltaScorer(const OptGraphScorer* scorer,
+                         const std::set<OptNode*>& g, const OptOrderCfg& c,
+                         bool sep)
+    : _scorer(scorer), _sep(sep) {
+  for (auto n : g) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      _edgIdx[e] = _edgs.size();
+      _edgs.push_back(e);
+      _card.push_back(e->pl().getCardinality());
+      _off.push_back(_pos.size());
+
+      const auto& lines = e->pl().getLines();
+      const auto& order = c.at(e);
+
+      _pos.resize(_pos.size() + order.size());
+      _at.resize(_at.size() + order.size());
+
+      for (size_t p = 0; p < order.size(); p++) {
+        size_t l = std::find(lines.begin(), lines.end(), order[p]) -
+                   lines.begin();
+        _pos[_off.back() + l] = p;
+        _at[_off.back() + p] = l;
+      }
+    }
+  }
+
+  _ends.resize(_edgs.size() * 2);
+  _fixed.resize(_edgs.size(), 0);
+
+  for (auto n : g) {
+    Nd nd;
+    nd.nd = n;
+    nd.deg = n->getAdjList().size();
+    nd.adjOff = _adj.size();
+    nd.pairOff = _pairs.size();
+    nd.diffSeg = n->getDeg() > 2;
+    nd.penSameSeg = nd.penDiffSeg = nd.penSep = 0;
+
+    if (n->pl().node) {
+      nd.penSameSeg = _scorer->getCrossingPenSameSeg(n);
+      nd.penDiffSeg = _scorer->getCrossingPenDiffSeg(n);
+      nd.penSep = _scorer->getSeparationPen(n);
+    }
+
+    const auto& adj = n->getAdjList();
+
+    for (size_t a = 0; a < adj.size(); a++) {
+      auto e = adj[a];
+      size_t ei = _edgIdx.find(e)->second;
+      bool rev = (e->getFrom() != n) ^ e->pl().lnEdgParts.front().dir;
+      _adj.push_back({ei, rev});
+      _ends[2 * ei + (e->getFrom() == n ? 0 : 1)] = {_nds.size(), a};
+    }
+
+    for (size_t a = 0; a < adj.size(); a++) {
+      const auto& clockw = OptGraph::clockwEdges(adj[a], n);
+
+      for (size_t b = 0; b < adj.size(); b++) {
+        Pair p{_ctd.size(), _ctd.size(), -1};
+        if (a == b) {
+          _pairs.push_back(p);
+          continue;
+        }
+
+        auto ea = adj[a];
+        auto eb = adj[b];
+        const auto& linesA = ea->pl().getLines();
+        const auto& linesB = eb->pl().getLines();
+
+        auto cw = std::find(clockw.begin(), clockw.end(), eb);
+        if (cw != clockw.end()) p.cwRank = cw - clockw.begin();
+
+        _ctd.resize(_ctd.size() + linesA.size() + linesB.size(), -1);
+        p.invOff = p.fwdOff + linesA.size();
+
+        // nodes without an original node never contribute to the score
+        if (!n->pl().node) {
+          _pairs.push_back(p);
+          continue;
+        }
+
+        const auto* lnNd = n->pl().node;
+
+        for (size_t i = 0; i < linesA.size(); i++) {
+          const auto* eaLo = &linesA[i];
+          const auto* ebLo = eb->pl().getLineOcc(eaLo->line);
+          if (!ebLo) continue;
+
+          // same connection condition as in OptGraphScorer
+          if ((eaLo->dir == 0 || ebLo->dir == 0 ||
+               (eaLo->dir == lnNd && ebLo->dir != lnNd) ||
+               (eaLo->dir != lnNd && ebLo->dir == lnNd)) &&
+              lnNd->pl().connOccurs(eaLo->line, OptGraph::getAdjEdg(ea, n),
+                                    OptGraph::getAdjEdg(eb, n))) {
+            int j = ebLo - &linesB[0];
+            _ctd[p.fwdOff + i] = j;
+            _ctd[p.invOff + j] = i;
+          }
+        }
+
+        _pairs.push_back(p);
+      }
+    }
+
+    _nds.push_back(nd);
+    _nds.back().cnt = count(_nds.back());
+    _nds.back().fixCnt = {0, 0, 0};
+  }
+}
+
+// _____________________________________________________________________________
+size_t DeltaScorer::q(const Slot& s, size_t l) const {
+  return s.rev ? _card[s.edg] - 1 - pos(s.edg, l) : pos(s.edg, l);
+}
+
+// _____________________________________________________________________________
+bool DeltaScorer::crosses(const Nd& n, size_t a, size_t b, size_t x,
+                          size_t y) const {
+  const auto& p = pair(n, a, b);
+  const auto& sa = _adj[n.adjOff + a];
+  const auto& sb = _adj[n.adjOff + b];
+  size_t xb = _ctd[p.fwdOff + x];
+  size_t yb = _ctd[p.fwdOff + y];
+
+  return (q(sa, x) < q(sa, y)) == (q(sb, xb) < q(sb, yb));
+}
+
+// _____________________________________________________________________________
+bool DeltaScorer::separates(const Nd& n, size_t a, size_t b, size_t i) const {
+  // separation between the lines at positions i - 1 and i in b
+  const auto& p = pair(n, a, b);
+  size_t ea = _adj[n.adjOff + a].edg;
+  size_t eb = _adj[n.adjOff + b].edg;
+
+  int u = _ctd[p.invOff + at(eb, i - 1)];
+  int v = _ctd[p.invOff + at(eb, i)];
+
+  if (u < 0 || v < 0) return false;
+
+  size_t pu = pos(ea, u);
+  size_t pv = pos(ea, v);
+
+  return (pu > pv ? pu - pv : pv - pu) > 1;
+}
+
+// _____________________________________________________________________________
+size_t DeltaScorer::diffSegCrossings(const Nd& n, size_t a, size_t x,
+                                     size_t y) const {
+  const auto& sa = _adj[n.adjOff + a];
+  if (q(sa, x) < q(sa, y)) std::swap(x, y);
+
+  // x is now further right, it crosses y for each pair of continuations
+  // where x continues into an edge clockwise before y's edge
+  size_t ret = 0;
+  for (size_t b = 0; b < n.deg; b++) {
+    const auto& pb = pair(n, a, b);
+    if (b == a || pb.cwRank < 0 || _ctd[pb.fwdOff + x] < 0) continue;
+    for (size_t bb = 0; bb < n.deg; bb++) {
+      const auto& pbb = pair(n, a, bb);
+      if (bb == a || pbb.cwRank <= pb.cwRank || _ctd[pbb.fwdOff + y] < 0)
+        continue;
+      ret++;
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+DeltaScorer::Counts DeltaScorer::count(const Nd& n) const {
+  Counts ret{0, 0, 0};
+
+  for (size_t a = 0; a < n.deg; a++) {
+    size_t ea = _adj[n.adjOff + a].edg;
+    for (size_t b = 0; b < n.deg; b++) {
+      if (a == b) continue;
+      const auto& p = pair(n, a, b);
+      size_t eb = _adj[n.adjOff + b].edg;
+
+      for (size_t x = 0; x < _card[ea]; x++) {
+        if (_ctd[p.fwdOff + x] < 0) continue;
+        for (size_t y = x + 1; y < _card[ea]; y++) {
+          if (_ctd[p.fwdOff + y] < 0) continue;
+          if (crosses(n, a, b, x, y)) ret.sameSegCrossTwice++;
+        }
+      }
+
+      for (size_t i = 1; i < _card[eb]; i++) {
+        if (separates(n, a, b, i)) ret.seps++;
+      }
+    }
+
+    if (!n.diffSeg) continue;
+
+    for (size_t x = 0; x < _card[ea]; x++) {
+      for (size_t y = x + 1; y < _card[ea]; y++) {
+        ret.diffSegCross += diffSegCrossings(n, a, x, y);
+      }
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+DeltaScorer::Counts DeltaScorer::countSwap(const Nd& n, size_t s, size_t p1,
+                                           size_t p2) const {
+  // only count the terms which may change if the lines at p1 and p2 in s are
+  // switched: pairs of lines which change their relative order, and
+  // separations adjacent to the switched lines
+  Counts ret{0, 0, 0};
+
+  size_t e = _adj[n.adjOff + s].edg;
+  size_t l1 = at(e, p1);
+  size_t l2 = at(e, p2);
+
+  std::vector<std::pair<size_t, size_t>> lPairs;
+  for (size_t p = p1 + 1; p <= p2; p++) lPairs.push_back({l1, at(e, p)});
+  for (size_t p = p1 + 1; p < p2; p++) lPairs.push_back({l2, at(e, p)});
+
+  std::vector<size_t> adjs;
+
+  for (size_t b = 0; b < n.deg; b++) {
+    if (b == s) continue;
+    const auto& fwd = pair(n, s, b);
+    const auto& inv = pair(n, b, s);
+    size_t eb = _adj[n.adjOff + b].edg;
+
+    for (const auto& lp : lPairs) {
+      if (_ctd[fwd.fwdOff + lp.first] >= 0 &&
+          _ctd[fwd.fwdOff + lp.second] >= 0 &&
+          crosses(n, s, b, lp.first, lp.second))
+        ret.sameSegCrossTwice++;
+
+      int xb = _ctd[inv.invOff + lp.first];
+      int yb = _ctd[inv.invOff + lp.second];
+      if (xb >= 0 && yb >= 0 && crosses(n, b, s, xb, yb))
+        ret.sameSegCrossTwice++;
+    }
+
+    // separations in b, measured against the positions in s
+    adjs.clear();
+    for (size_t l : {l1, l2}) {
+      int lb = _ctd[fwd.fwdOff + l];
+      if (lb < 0) continue;
+      size_t pb = pos(eb, lb);
+      if (pb > 0) adjs.push_back(pb);
+      if (pb + 1 < _card[eb]) adjs.push_back(pb + 1);
+    }
+    std::sort(adjs.begin(), adjs.end());
+    adjs.erase(std::unique(adjs.begin(), adjs.end()), adjs.end());
+    for (size_t i : adjs) ret.seps += separates(n, s, b, i);
+
+    // separations in s, measured against the positions in b
+    adjs.clear();
+    for (size_t p : {p1, p1 + 1, p2, p2 + 1}) {
+      if (p > 0 && p < _card[e]) adjs.push_back(p);
+    }
+    std::sort(adjs.begin(), adjs.end());
+    adjs.erase(std::unique(adjs.begin(), adjs.end()), adjs.end());
+    for (size_t i : adjs) ret.seps += separates(n, b, s, i);
+  }
+
+  if (n.diffSeg) {
+    for (const auto& lp : lPairs)
+      ret.diffSegCross += diffSegCrossings(n, s, lp.first, lp.second);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+DeltaScorer::Counts DeltaScorer::countFixed(const Nd& n, size_t s) const {
+  // all terms between slot s and the slots of fixed edges, plus the
+  // different segment crossings, which only depend on the ordering of s
+  Counts ret{0, 0, 0};
+
+  size_t e = _adj[n.adjOff + s].edg;
+
+  for (size_t b = 0; b < n.deg; b++) {
+    size_t eb = _adj[n.adjOff + b].edg;
+    if (b == s || !_fixed[eb]) continue;
+    const auto& fwd = pair(n, s, b);
+    const auto& inv = pair(n, b, s);
+
+    for (size_t x = 0; x < _card[e]; x++) {
+      if (_ctd[fwd.fwdOff + x] < 0) continue;
+      for (size_t y = x + 1; y < _card[e]; y++) {
+        if (_ctd[fwd.fwdOff + y] < 0) continue;
+        if (crosses(n, s, b, x, y)) ret.sameSegCrossTwice++;
+      }
+    }
+
+    for (size_t x = 0; x < _card[eb]; x++) {
+      if (_ctd[inv.fwdOff + x] < 0) continue;
+      for (size_t y = x + 1; y < _card[eb]; y++) {
+        if (_ctd[inv.fwdOff + y] < 0) continue;
+        if (crosses(n, b, s, x, y)) ret.sameSegCrossTwice++;
+      }
+    }
+
+    for (size_t i = 1; i < _card[eb]; i++) ret.seps += separates(n, s, b, i);
+    for (size_t i = 1; i < _card[e]; i++) ret.seps += separates(n, b, s, i);
+  }
+
+  if (n.diffSeg) {
+    for (size_t x = 0; x < _card[e]; x++) {
+      for (size_t y = x + 1; y < _card[e]; y++) {
+        ret.diffSegCross += diffSegCrossings(n, s, x, y);
+      }
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+double DeltaScorer::score(const Nd& n, const Counts& c) const {
+  double ret = n.penSameSeg * (c.sameSegCrossTwice / 2) +
+               n.penDiffSeg * c.diffSegCross;
+  if (_sep) ret += n.penSep * c.seps;
+  return ret;
+}
+
+// _____________________________________________________________________________
+double DeltaScorer::getScore() const {
+  double ret = 0;
+  for (const auto& n : _nds) ret += score(n, n.cnt);
+  return ret;
+}
+
+// _____________________________________________________________________________
+double DeltaScorer::getScore(const OptEdge* e) const {
+  size_t ei = _edgIdx.find(e)->second;
+  const auto& a = _nds[_ends[2 * ei].first];
+  const auto& b = _nds[_ends[2 * ei + 1].first];
+  return score(a, a.cnt) + score(b, b.cnt);
+}
+
+// _____________________________________________________________________________
+double DeltaScorer::getSwapDelta(const OptEdge* e, size_t p1, size_t p2) {
+  if (p1 == p2) return 0;
+  if (p1 > p2) std::swap(p1, p2);
+
+  size_t ei = _edgIdx.find(e)->second;
+
+  Counts before[2], after[2];
+  for (size_t i = 0; i < 2; i++) {
+    const auto& end = _ends[2 * ei + i];
+    before[i] = countSwap(_nds[end.first], end.second, p1, p2);
+  }
+
+  swapPos(ei, p1, p2);
+
+  for (size_t i = 0; i < 2; i++) {
+    const auto& end = _ends[2 * ei + i];
+    after[i] = countSwap(_nds[end.first], end.second, p1, p2);
+  }
+
+  swapPos(ei, p1, p2);
+
+  double ret = 0;
+
+  for (size_t i = 0; i < 2; i++) {
+    const auto& n = _nds[_ends[2 * ei + i].first];
+    Counts c = n.cnt;
+    c.sameSegCrossTwice += after[i].sameSegCrossTwice;
+    c.sameSegCrossTwice -= before[i].sameSegCrossTwice;
+    c.diffSegCross += after[i].diffSegCross;
+    c.diffSegCross -= before[i].diffSegCross;
+    c.seps += after[i].seps;
+    c.seps -= before[i].seps;
+    ret += score(n, c) - score(n, n.cnt);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::swap(const OptEdge* e, size_t p1, size_t p2) {
+  if (p1 == p2) return;
+  if (p1 > p2) std::swap(p1, p2);
+
+  size_t ei = _edgIdx.find(e)->second;
+
+  for (size_t i = 0; i < 2; i++) {
+    const auto& end = _ends[2 * ei + i];
+    auto& n = _nds[end.first];
+    Counts c = countSwap(n, end.second, p1, p2);
+    n.cnt.sameSegCrossTwice -= c.sameSegCrossTwice;
+    n.cnt.diffSegCross -= c.diffSegCross;
+    n.cnt.seps -= c.seps;
+  }
+
+  swapPos(ei, p1, p2);
+
+  for (size_t i = 0; i < 2; i++) {
+    const auto& end = _ends[2 * ei + i];
+    auto& n = _nds[end.first];
+    Counts c = countSwap(n, end.second, p1, p2);
+    n.cnt.sameSegCrossTwice += c.sameSegCrossTwice;
+    n.cnt.diffSegCross += c.diffSegCross;
+    n.cnt.seps += c.seps;
+  }
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::swapPos(size_t e, size_t p1, size_t p2) {
+  size_t l1 = at(e, p1);
+  size_t l2 = at(e, p2);
+  _at[_off[e] + p1] = l2;
+  _at[_off[e] + p2] = l1;
+  _pos[_off[e] + l1] = p2;
+  _pos[_off[e] + l2] = p1;
+}
+
+// _____________________________________________________________________________
+size_t DeltaScorer::getCardinality(const OptEdge* e) const {
+  return _card[_edgIdx.find(e)->second];
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::getOrderCfg(OptOrderCfg* c) const {
+  for (size_t e = 0; e < _edgs.size(); e++) {
+    const auto& lines = _edgs[e]->pl().getLines();
+    auto& order = (*c)[_edgs[e]];
+    order.resize(_card[e]);
+    for (size_t p = 0; p < _card[e]; p++) order[p] = lines[at(e, p)].line;
+  }
+}
+
+// _____________________________________________________________________________
+double DeltaScorer::fix(const OptEdge* e) {
+  size_t ei = _edgIdx.find(e)->second;
+  double ret = 0;
+
+  for (size_t i = 0; i < 2; i++) {
+    const auto& end = _ends[2 * ei + i];
+    auto& n = _nds[end.first];
+    Counts c = countFixed(n, end.second);
+    double before = score(n, n.fixCnt);
+    n.fixCnt.sameSegCrossTwice += c.sameSegCrossTwice;
+    n.fixCnt.diffSegCross += c.diffSegCross;
+    n.fixCnt.seps += c.seps;
+    ret += score(n, n.fixCnt) - before;
+  }
+
+  _fixed[ei] = 1;
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::unfix(const OptEdge* e) {
+  size_t ei = _edgIdx.find(e)->second;
+  _fixed[ei] = 0;
+
+  for (size_t i = 0; i < 2; i++) {
+    const auto& end = _ends[2 * ei + i];
+    auto& n = _nds[end.first];
+    Counts c = countFixed(n, end.second);
+    n.fixCnt.sameSegCrossTwice -= c.sameSegCrossTwice;
+    n.fixCnt.diffSegCross -= c.diffSegCross;
+    n.fixCnt.seps -= c.seps;
+  }
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::resetOrder(const OptEdge* e) {
+  size_t ei = _edgIdx.find(e)->second;
+  for (size_t p = 0; p < _card[ei]; p++) {
+    _at[_off[ei] + p] = p;
+    _pos[_off[ei] + p] = p;
+  }
+}
+
+// _____________________________________________________________________________
+bool DeltaScorer::nextPermutation(const OptEdge* e) {
+  size_t ei = _edgIdx.find(e)->second;
+  auto begin = _at.begin() + _off[ei];
+  bool ret = std::next_permutation(begin, begin + _card[ei]);
+  for (size_t p = 0; p < _card[ei]; p++) _pos[_off[ei] + at(ei, p)] = p;
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::vector<size_t> DeltaScorer::getOrder(const OptEdge* e) const {
+  size_t ei = _edgIdx.find(e)->second;
+  auto begin = _at.begin() + _off[ei];
+  return std::vector<size_t>(begin, begin + _card[ei]);
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::setOrder(const OptEdge* e, const std::vector<size_t>& order) {
+  size_t ei = _edgIdx.find(e)->second;
+  for (size_t p = 0; p < _card[ei]; p++) {
+    _at[_off[ei] + p] = order[p];
+    _pos[_off[ei] + order[p]] = p;
+  }
+}
+
+// _____________________________________________________________________________
+void DeltaScorer::recount() {
+  for (auto& n : _nds) n.cnt = count(n);
+}
@@ -0,0 +1,147 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOM_OPTIM_DELTASCORER_H_
+#define LOOM_OPTIM_DELTASCORER_H_
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "loom/optim/OptGraph.h"
+#include "loom/optim/OptGraphScorer.h"
+
+namespace loom {
+namespace optim {
+
+// Incremental scorer for the orderings of a single optimization graph
+// component. The line orderings are held in flat position arrays, and the
+// crossing / separation counts are maintained per node, so that the score
+// change of switching two positions on an edge can be computed by only
+// looking at the line pairs whose relative order actually changes.
+//
+// Scores are identical to the ones obtained by OptGraphScorer.
+class DeltaScorer {
+ public:
+  DeltaScorer(const OptGraphScorer* scorer, const std::set<OptNode*>& g,
+              const OptOrderCfg& c, bool sep);
+
+  // total score of the component
+  double getScore() const;
+
+  // score of both nodes adjacent to e, see OptGraphScorer::getTotalScore()
+  double getScore(const OptEdge* e) const;
+
+  // score change if positions p1 and p2 were switched on e
+  double getSwapDelta(const OptEdge* e, size_t p1, size_t p2);
+
+  // switch positions p1 and p2 on e
+  void swap(const OptEdge* e, size_t p1, size_t p2);
+
+  size_t getCardinality(const OptEdge* e) const;
+
+  void getOrderCfg(OptOrderCfg* c) const;
+
+  // Partial orderings, used by the branch and bound search. Only the terms
+  // between fixed edges are counted in the partial score. Fixing more edges
+  // can only increase it, so it is a lower bound for every completion.
+
+  // fix the current ordering of e, returns the increase of the partial score
+  double fix(const OptEdge* e);
+  void unfix(const OptEdge* e);
+
+  // set e to its first (sorted) ordering
+  void resetOrder(const OptEdge* e);
+
+  // advance e to its lexicographically next ordering, returns false (and
+  // leaves e at its first ordering) after the last one. Only the partial
+  // counts are maintained, call recount() before using the full scores again
+  bool nextPermutation(const OptEdge* e);
+
+  // line indices (into e->pl().getLines()) at each position of e
+  std::vector<size_t> getOrder(const OptEdge* e) const;
+  void setOrder(const OptEdge* e, const std::vector<size_t>& order);
+
+  void recount();
+
+ private:
+  struct Counts {
+    // same segment crossings are counted twice
+    size_t sameSegCrossTwice;
+    size_t diffSegCross;
+    size_t seps;
+  };
+
+  struct Nd {
+    const OptNode* nd;
+    double penSameSeg, penDiffSeg, penSep;
+    bool diffSeg;
+
+    // adjacent edge slots are _adj[adjOff] to _adj[adjOff + deg - 1], ordered
+    // edge slot pairs (a, b) are at _pairs[pairOff + a * deg + b]
+    size_t adjOff, deg, pairOff;
+
+    Counts cnt;
+
+    // counts restricted to fixed edges
+    Counts fixCnt;
+  };
+
+  struct Slot {
+    size_t edg;
+    bool rev;
+  };
+
+  struct Pair {
+    // maps lines of slot a to their continuation in slot b (or -1), and
+    // vice versa
+    size_t fwdOff, invOff;
+
+    // position of slot b in the clockwise ordering starting at slot a
+    int cwRank;
+  };
+
+  const OptGraphScorer* _scorer;
+  bool _sep;
+
+  std::unordered_map<const OptEdge*, size_t> _edgIdx;
+  std::vector<const OptEdge*> _edgs;
+  std::vector<size_t> _card, _off;
+
+  // for each edge, the two (node, slot) pairs of its end nodes
+  std::vector<std::pair<size_t, size_t>> _ends;
+
+  // line index -> position, position -> line index
+  std::vector<size_t> _pos, _at;
+
+  std::vector<char> _fixed;
+
+  std::vector<Nd> _nds;
+  std::vector<Slot> _adj;
+  std::vector<Pair> _pairs;
+  std::vector<int> _ctd;
+
+  size_t pos(size_t e, size_t l) const { return _pos[_off[e] + l]; }
+  size_t at(size_t e, size_t p) const { return _at[_off[e] + p]; }
+  size_t q(const Slot& s, size_t l) const;
+
+  const Pair& pair(const Nd& n, size_t a, size_t b) const {
+    return _pairs[n.pairOff + a * n.deg + b];
+  }
+
+  double score(const Nd& n, const Counts& c) const;
+
+  Counts count(const Nd& n) const;
+  Counts countSwap(const Nd& n, size_t s, size_t p1, size_t p2) const;
+  Counts countFixed(const Nd& n, size_t s) const;
+
+  bool crosses(const Nd& n, size_t a, size_t b, size_t x, size_t y) const;
+  bool separates(const Nd& n, size_t a, size_t b, size_t i) const;
+  size_t diffSegCrossings(const Nd& n, size_t a, size_t x, size_t y) const;
+
+  void swapPos(size_t e, size_t p1, size_t p2);
+};
+}  // namespace optim
+}  // namespace loom
+
+#endif  // LOOM_OPTIM_DELTASCORER_H_
@@ -3,17 +3,112 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <sstream>
+#include <stdexcept>
 #include <unordered_map>
+#include "loom/optim/DeltaScorer.h"
 #include "loom/optim/ExhaustiveOptimizer.h"
+#include "loom/optim/GreedyOptimizer.h"
 #include "shared/linegraph/Line.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 
 using namespace loom;
 using namespace optim;
+using loom::optim::DeltaScorer;
 using loom::optim::ExhaustiveOptimizer;
+using loom::optim::GreedyOptimizer;
 using shared::linegraph::Line;
 using shared::rendergraph::HierarOrderCfg;
 
+namespace {
+
+// best score found so far, and the index of the work item it was found in
+struct Bound {
+  double score;
+  size_t item;
+};
+
+struct Search {
+  DeltaScorer ds;
+  const std::vector<const OptEdge*>* edges;
+
+  // shared between all threads, and a possibly outdated local copy of it
+  Bound* shared;
+  Bound glob;
+
+  size_t item;
+  double best;
+  bool found;
+  OptOrderCfg bestCfg;
+  size_t nodes;
+};
+
+// _____________________________________________________________________________
+bool prune(const Search& s, double lb) {
+  // subtrees with a lower bound equal to the global best are only pruned if
+  // the best was found in an earlier item, so the result does not depend on
+  // the order in which the items are processed
+  return lb >= s.best || lb > s.glob.score ||
+         (lb == s.glob.score && s.item > s.glob.item);
+}
+
+// _____________________________________________________________________________
+void branch(Search* s, size_t depth, double lb) {
+  if (++s->nodes % 1024 == 0) {
+#pragma omp critical(loom_exhaust_bound)
+    s->glob = *s->shared;
+  }
+
+  if (depth == s->edges->size()) {
+    // not pruned, so this is an improvement
+    s->best = lb;
+    s->found = true;
+    s->ds.getOrderCfg(&s->bestCfg);
+
+#pragma omp critical(loom_exhaust_bound)
+    {
+      if (lb < s->shared->score ||
+          (lb == s->shared->score && s->item < s->shared->item)) {
+        *s->shared = {lb, s->item};
+      }
+      s->glob = *s->shared;
+    }
+    return;
+  }
+
+  const auto* e = (*s->edges)[depth];
+  s->ds.resetOrder(e);
+
+  do {
+    double inc = s->ds.fix(e);
+    if (!prune(*s, lb + inc)) branch(s, depth + 1, lb + inc);
+    s->ds.unfix(e);
+  } while (s->ds.nextPermutation(e));
+}
+
+// _____________________________________________________________________________
+double applyPrefix(DeltaScorer* ds, const std::vector<const OptEdge*>& edges,
+                   const std::vector<std::vector<size_t>>& prefix) {
+  double lb = 0;
+  for (size_t i = 0; i < prefix.size(); i++) {
+    ds->setOrder(edges[i], prefix[i]);
+    lb += ds->fix(edges[i]);
+  }
+  return lb;
+}
+
+// _____________________________________________________________________________
+void removePrefix(DeltaScorer* ds, const std::vector<const OptEdge*>& edges,
+                  const std::vector<std::vector<size_t>>& prefix) {
+  for (size_t i = prefix.size(); i > 0; i--) ds->unfix(edges[i - 1]);
+}
+}  // namespace
+
 // _____________________________________________________________________________
 double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
                                          const std::set<OptNode*>& g,
@@ -25,93 +120,154 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
                           << "(ExhaustiveOptimizer) Optimizing component with "
                           << g.size() << " nodes.";
 
+  double solSp = solutionSpaceSize(g);
+
+  // don't try if it is pointless. The bound prunes most of the search tree,
+  // but its size still grows with the solution space
+  if (solSp > _cfg->exhaustMaxSolSpace) {
+    std::stringstream ss;
+    ss << "Exhaustive search would take too long, solution space size "
+       << solSp << " exceeds " << _cfg->exhaustMaxSolSpace
+       << " (see --exhaust-max-sol-space)";
+    throw std::runtime_error(ss.str());
+  }
+
   T_START(1);
 
-  OptOrderCfg best, cur, null;
-  double bestScore = DBL_MAX;
+  // branch and bound: the edges are fixed one after the other, and the score
+  // of the terms between already fixed edges is used as a lower bound for
+  // the subtree. Subtrees which cannot beat the best solution are pruned.
 
-  // fixed order list of optim graph edges
-  std::vector<OptEdge*> edges;
+  // the edge order: start with the edge with the most lines, then always fix
+  // the edge with the most already fixed neighbors, so the lower bound gets
+  // tight early
+  std::vector<const OptEdge*> edges, free;
 
   for (auto n : g)
     for (auto e : n->getAdjList())
-      if (n == e->getFrom()) edges.push_back(e);
-
-  // this guarantees that all the orderings are sorted, which we need for
-  // std::next_permutation below!
-  initialConfig(g, &null, true);
-  cur = null;
+      if (n == e->getFrom()) free.push_back(e);
 
-  double iters = 0;
-  double last = 0;
-  bool running = true;
+  std::set<const OptEdge*> fixed;
 
-  double curScore = _optScorer.getCrossingScore(g, cur);
-  if (_optScorer.optimizeSep())
-    curScore += _optScorer.getSeparationScore(g, cur);
+  while (free.size()) {
+    size_t cand = 0;
+    size_t bestNeighs = 0;
+    for (size_t i = 0; i < free.size(); i++) {
+      size_t neighs = 0;
+      for (auto n : {free[i]->getFrom(), free[i]->getTo()})
+        for (auto e : n->getAdjList()) neighs += fixed.count(e);
+      if (neighs > bestNeighs ||
+          (neighs == bestNeighs && free[i]->pl().getCardinality() >
+                                       free[cand]->pl().getCardinality())) {
+        cand = i;
+        bestNeighs = neighs;
+      }
+    }
+    edges.push_back(free[cand]);
+    fixed.insert(free[cand]);
+    free.erase(free.begin() + cand);
+  }
 
-  bestScore = curScore;
-  best = cur;
+  // initial upper bound: the greedy lookahead solution, improved by swaps
+  OptOrderCfg best;
+  GreedyOptimizer(_cfg, _optScorer.getPens(), true).getFlatConfig(g, &best);
 
-  double solSp = solutionSpaceSize(g);
+  DeltaScorer ds(&_optScorer, g, best, _optScorer.optimizeSep());
 
-  // don't try if it is pointless, assuming we can make 100.000
-  // iterations per second
-  if ((solSp / 50000) > (60 * 60 * 6)) {
-    std::stringstream ss;
-    ss << "Exhaustive search would take too long (over "
-       << ((solSp / 50000) / (60 * 60))
-       << " hours even assuming we can check 50.000 configurations per second";
-    throw std::runtime_error(ss.str());
+  bool improved = true;
+  while (improved) {
+    improved = false;
+    for (auto e : edges) {
+      for (size_t p1 = 0; p1 < ds.getCardinality(e); p1++) {
+        for (size_t p2 = p1 + 1; p2 < ds.getCardinality(e); p2++) {
+          if (ds.getSwapDelta(e, p1, p2) < 0) {
+            ds.swap(e, p1, p2);
+            improved = true;
+          }
+        }
+      }
+    }
   }
 
-  double itTime = 0;
+  double bestScore = ds.getScore();
+  ds.getOrderCfg(&best);
 
-  while (true) {
-    T_START(iter);
-    if (bestScore == 0) {
-      LOGTO(DEBUG, std::cerr)
-          << prefix(depth) << "Found optimal score 0 prematurely after "
-          << iters << " iterations!";
-      writeHierarch(&best, hc);
-      return 0;
-    }
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+
+  // split the search tree into work items by enumerating the orderings of the
+  // first edges, dropping prefixes which are already pruned
+  std::vector<std::vector<std::vector<size_t>>> items(1);
+  size_t k = 0;
 
-    iters++;
+  while (bestScore > 0 && k < edges.size() && items.size() < 32 * threads) {
+    double sp = items.size();
+    for (size_t i = 2; i <= edges[k]->pl().getCardinality(); i++) sp *= i;
+    if (sp > 100000) break;
 
-    if (fabs((iters - last) - 10000) < 1) {
-      LOGTO(DEBUG, std::cerr)
-          << prefix(depth) << "@ " << iters << "/" << solSp << " ("
-          << int(((1.0 * iters) / (1.0 * solSp)) * 100) << "%, "
-          << (10000 / (itTime / 1000)) << " its/s)";
-      last = iters;
-      itTime = 0;
+    std::vector<std::vector<std::vector<size_t>>> next;
+
+    for (const auto& item : items) {
+      double lb = applyPrefix(&ds, edges, item);
+      ds.resetOrder(edges[k]);
+      do {
+        if (lb + ds.fix(edges[k]) < bestScore) {
+          next.push_back(item);
+          next.back().push_back(ds.getOrder(edges[k]));
+        }
+        ds.unfix(edges[k]);
+      } while (ds.nextPermutation(edges[k]));
+      removePrefix(&ds, edges, item);
     }
 
-    for (size_t i = 0; i < edges.size(); i++) {
-      if (std::next_permutation(cur[edges[i]].begin(), cur[edges[i]].end())) {
-        break;
-      } else if (i == edges.size() - 1) {
-        running = false;
+    items = next;
+    k++;
+  }
+
+  if (bestScore == 0) items.clear();
+
+  Bound shared{bestScore, items.size()};
+
+  std::vector<double> itemScores(items.size(), bestScore);
+  std::vector<OptOrderCfg> itemCfgs(items.size());
+  std::vector<char> itemFound(items.size(), 0);
+  size_t nodes = 0;
+
+#pragma omp parallel num_threads(threads) reduction(+ : nodes)
+  {
+    Bound init{bestScore, items.size()};
+    Search s{ds, &edges, &shared, init, 0, 0, false, {}, 0};
+
+#pragma omp for schedule(dynamic, 1)
+    for (size_t i = 0; i < items.size(); i++) {
+      s.item = i;
+      s.best = bestScore;
+      s.found = false;
+
+      double lb = applyPrefix(&s.ds, edges, items[i]);
+      if (!prune(s, lb)) branch(&s, k, lb);
+      removePrefix(&s.ds, edges, items[i]);
+
+      if (s.found) {
+        itemScores[i] = s.best;
+        itemCfgs[i] = s.bestCfg;
+        itemFound[i] = 1;
       }
     }
 
-    if (!running) break;
-
-    if (_optScorer.optimizeSep())
-      curScore = _optScorer.getTotalScore(g, cur);
-    else
-      curScore = _optScorer.getCrossingScore(g, cur);
+    nodes = s.nodes;
+  }
 
-    if (curScore < bestScore) {
-      bestScore = curScore;
-      best = cur;
+  // take the best solution from the first item it was found in
+  for (size_t i = 0; i < items.size(); i++) {
+    if (itemFound[i] && itemScores[i] < bestScore) {
+      bestScore = itemScores[i];
+      best = itemCfgs[i];
     }
-    itTime += T_STOP(iter);
   }
 
   LOGTO(DEBUG, std::cerr) << prefix(depth) << "Found optimal score "
-                          << bestScore << " after " << iters << " iterations!";
+                          << bestScore << " after visiting " << nodes
+                          << " search nodes!";
 
   writeHierarch(&best, hc);
 
@@ -140,7 +296,7 @@ void ExhaustiveOptimizer::initialConfig(const std::set<OptNode*>& g,
       if (sorted) {
         std::sort((*cfg)[e].begin(), (*cfg)[e].end());
       } else {
-        std::random_shuffle((*cfg)[e].begin(), (*cfg)[e].end());
+        std::shuffle((*cfg)[e].begin(), (*cfg)[e].end(), rng());
       }
     }
   }
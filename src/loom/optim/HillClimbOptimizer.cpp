@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include "loom/optim/DeltaScorer.h"
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/HillClimbOptimizer.h"
 #include "shared/linegraph/Line.h"
@@ -20,6 +21,7 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
                                      HierarOrderCfg* hc, size_t depth,
                                      OptResStats& stats) const {
   UNUSED(stats);
+  UNUSED(og);
   UNUSED(depth);
   T_START(1);
   OptOrderCfg cur;
@@ -40,6 +42,9 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
     greedy.getFlatConfig(g, &cur);
   }
 
+  // score changes are computed incrementally on a flat copy of cur
+  DeltaScorer scorer(&_optScorer, g, cur, _optScorer.optimizeSep());
+
   size_t iters = 0;
 
   while (true) {
@@ -47,46 +52,32 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
 
     double bestChange = 0;
     OptEdge* bestEdge = 0;
-    std::vector<const Line*> bestOrder;
+    size_t bestP1 = 0, bestP2 = 0;
 
     for (size_t i = 0; i < edges.size(); i++) {
-      double oldScore = getScore(og, edges[i], cur);
-
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
-          // switch p1 and p2
-          auto tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
-
-          double s = getScore(og, edges[i], cur);
-          if (s < oldScore && oldScore - s > bestChange) {
-            bestChange = oldScore - s;
+      size_t card = scorer.getCardinality(edges[i]);
+
+      for (size_t p1 = 0; p1 < card; p1++) {
+        for (size_t p2 = p1 + 1; p2 < card; p2++) {
+          // score change if p1 and p2 were switched
+          double delta = scorer.getSwapDelta(edges[i], p1, p2);
+          if (-delta > bestChange) {
+            bestChange = -delta;
             bestEdge = edges[i];
-            bestOrder = cur[edges[i]];
+            bestP1 = p1;
+            bestP2 = p2;
           }
-
-          // switch back
-          tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
         }
       }
     }
 
     if (bestEdge == 0) break;
 
-    cur[bestEdge] = bestOrder;
+    scorer.swap(bestEdge, bestP1, bestP2);
   }
 
+  scorer.getOrderCfg(&cur);
+
   writeHierarch(&cur, hc);
   return T_STOP(1);
 }
-
-// _____________________________________________________________________________
-double HillClimbOptimizer::getScore(OptGraph* og, OptEdge* e,
-                                    OptOrderCfg& cur) const {
-  UNUSED(og);
-  if (_optScorer.optimizeSep()) return _optScorer.getTotalScore(e, cur);
-  return _optScorer.getCrossingScore(e, cur);
-}
@@ -25,18 +25,20 @@ class ILPEdgeOrderOptimizer : public ILPOptimizer {
       : ILPOptimizer(cfg, pens){};
 
  private:
-  virtual shared::optim::ILPSolver* createProblem(
-      OptGraph* og, const std::set<OptNode*>& g) const;
+  virtual void createProblem(OptGraph* og, const std::set<OptNode*>& g,
+                             shared::optim::ILPModel* m, ILPVars* vars) const;
 
   virtual void getConfigurationFromSolution(
-      shared::optim::ILPSolver* lp, shared::rendergraph::HierarOrderCfg* c,
+      shared::optim::ILPSolver* lp, const ILPVars& vars,
+      shared::rendergraph::HierarOrderCfg* c,
       const std::set<OptNode*>& g) const;
 
-  void writeCrossingOracle(const std::set<OptNode*>& g,
-                           shared::optim::ILPSolver* lp) const;
+  void writeCrossingOracle(const std::set<OptNode*>& g, ILPVars* vars,
+                           shared::optim::ILPModel* m) const;
 
   void writeDiffSegConstraintsImpr(const std::set<OptNode*>& g,
-                                   shared::optim::ILPSolver* lp) const;
+                                   const ILPVars& vars,
+                                   shared::optim::ILPModel* m) const;
 };
 }  // namespace optim
 }  // namespace loom
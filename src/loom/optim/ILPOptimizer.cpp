@@ -18,6 +18,7 @@
 using namespace loom;
 using namespace optim;
 using shared::linegraph::Line;
+using shared::optim::ILPModel;
 using shared::optim::ILPSolver;
 using shared::rendergraph::HierarOrderCfg;
 
@@ -31,47 +32,61 @@ double ILPOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
     return _exhausOpt.optimizeComp(og, g, hc, depth + 1, stats);
   }
 
-  LOGTO(DEBUG, std::cerr) << "Creating ILP problem... ";
-  T_START(build);
-  auto lp = createProblem(og, g);
-  double buildT = T_STOP(build);
-  LOGTO(DEBUG, std::cerr) << " .. done";
+  double solveT = 0;
 
-  if (lp->getNumVars() > static_cast<int>(stats.maxNumColsPerComp))
-    stats.maxNumColsPerComp = lp->getNumVars();
-  if (lp->getNumConstrs() > static_cast<int>(stats.maxNumRowsPerComp))
-    stats.maxNumRowsPerComp = lp->getNumConstrs();
+  // the solver backends are not guaranteed to be thread-safe (GLPK keeps a
+  // global environment), so only build and solve one ILP at a time
+#pragma omp critical(loom_ilp)
+  {
+    LOGTO(DEBUG, std::cerr) << "Creating ILP problem... ";
+    T_START(build);
 
-  if (_cfg->MPSOutputPath.size()) {
-    lp->writeMps(_cfg->MPSOutputPath);
-  }
+    // names are only needed for the MPS output
+    ILPModel m(_cfg->MPSOutputPath.size());
+    ILPVars vars;
+    createProblem(og, g, &m, &vars);
+
+    auto lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN);
+    lp->load(m);
+    double buildT = T_STOP(build);
+    LOGTO(DEBUG, std::cerr) << " .. done";
 
-  if (_cfg->ilpTimeLimit >= 0) lp->setTimeLim(_cfg->ilpTimeLimit);
-  if (_cfg->ilpNumThreads != 0) lp->setNumThreads(_cfg->ilpNumThreads);
+    if (m.getNumCols() > stats.maxNumColsPerComp)
+      stats.maxNumColsPerComp = m.getNumCols();
+    if (m.getNumRows() > stats.maxNumRowsPerComp)
+      stats.maxNumRowsPerComp = m.getNumRows();
 
-  LOGTO(DEBUG, std::cerr) << "Solving ILP problem...";
+    if (_cfg->MPSOutputPath.size()) {
+      lp->writeMps(_cfg->MPSOutputPath);
+    }
 
-  T_START(solve);
+    if (_cfg->ilpTimeLimit >= 0) lp->setTimeLim(_cfg->ilpTimeLimit);
+    if (_cfg->ilpNumThreads != 0) lp->setNumThreads(_cfg->ilpNumThreads);
 
-  auto status = lp->solve();
+    LOGTO(DEBUG, std::cerr) << "Solving ILP problem...";
 
-  double solveT = T_STOP(solve);
+    T_START(solve);
 
-  if (status == shared::optim::SolveType::INF) {
-    LOG(WARN)
-        << "No solution found for ILP problem (most likely because of a time "
-           "limit)!";
-  } else {
-    LOGTO(INFO, std::cerr) << "(stats) ILP obj = " << lp->getObjVal();
-    LOGTO(INFO, std::cerr) << "(stats) ILP build time = " << buildT << " ms";
-    LOGTO(INFO, std::cerr) << "(stats) ILP solve time = " << solveT << " ms";
-    if (status == shared::optim::SolveType::OPTIM)
-      LOGTO(INFO, std::cerr) << "(stats) (which is optimal)";
+    auto status = lp->solve();
 
-    getConfigurationFromSolution(lp, hc, g);
-  }
+    solveT = T_STOP(solve);
+
+    if (status == shared::optim::SolveType::INF) {
+      LOG(WARN)
+          << "No solution found for ILP problem (most likely because of a time "
+             "limit)!";
+    } else {
+      LOGTO(INFO, std::cerr) << "(stats) ILP obj = " << lp->getObjVal();
+      LOGTO(INFO, std::cerr) << "(stats) ILP build time = " << buildT << " ms";
+      LOGTO(INFO, std::cerr) << "(stats) ILP solve time = " << solveT << " ms";
+      if (status == shared::optim::SolveType::OPTIM)
+        LOGTO(INFO, std::cerr) << "(stats) (which is optimal)";
+
+      getConfigurationFromSolution(lp, vars, hc, g);
+    }
 
-  delete lp;
+    delete lp;
+  }
 
   return solveT;
 }
@@ -94,9 +109,8 @@ int ILPOptimizer::getSeparationPenalty(const OptNode* n) const {
 
 // _____________________________________________________________________________
 void ILPOptimizer::getConfigurationFromSolution(
-    ILPSolver* lp, HierarOrderCfg* hc, const std::set<OptNode*>& g) const {
-  // build name index for faster lookup
-
+    ILPSolver* lp, const ILPVars& vars, HierarOrderCfg* hc,
+    const std::set<OptNode*>& g) const {
   for (OptNode* n : g) {
     for (OptEdge* e : n->getAdjList()) {
       if (e->getFrom() != n) continue;
@@ -105,9 +119,7 @@ void ILPOptimizer::getConfigurationFromSolution(
         for (size_t tp = 0; tp < e->pl().getCardinality(); tp++) {
           bool found = false;
           for (auto lo : e->pl().getLines()) {
-            std::string varName = getILPVarName(e, lo.line, tp);
-
-            double val = lp->getVarVal(varName);
+            double val = lp->getVarVal(vars.getPos(e, lo.line, tp));
 
             if (val > 0.5) {
               for (auto rel : lo.relatives) {
@@ -134,58 +146,51 @@ void ILPOptimizer::getConfigurationFromSolution(
 }
 
 // _____________________________________________________________________________
-ILPSolver* ILPOptimizer::createProblem(OptGraph* og,
-                                       const std::set<OptNode*>& g) const {
-  ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN);
-
+void ILPOptimizer::createProblem(OptGraph* og, const std::set<OptNode*>& g,
+                                 ILPModel* m, ILPVars* vars) const {
   // for every segment s, we define |L(s)|^2 decision variables x_slp
   for (OptNode* n : g) {
     for (OptEdge* e : n->getAdjList()) {
       if (e->getFrom() != n) continue;
       // get string repr of lineedge part
 
-      size_t i = 0;
-      int rowA = lp->getNumConstrs();
+      int rowA = m->getNumRows();
 
       for (size_t p = 0; p < e->pl().getCardinality(); p++) {
-        std::stringstream rowName;
-
-        rowName << "sum(" << e->pl().getStrRepr() << ",p=" << p << ")";
-        lp->addRow(rowName.str(), 1, shared::optim::FIX);
+        m->addRow(1, shared::optim::FIX,
+                  m->name("sum(", e->pl().getStrRepr(), ",p=", p, ")"));
       }
 
       for (auto l : e->pl().getLines()) {
         // constraint: the sum of all x_slp over p must be 1 for equal sl
-        std::stringstream rowName;
-        rowName << "sum(" << e->pl().getStrRepr() << ",l=" << l.line << ")";
+        int row = m->addRow(
+            1, shared::optim::FIX,
+            m->name("sum(", e->pl().getStrRepr(), ",l=", l.line, ")"));
 
-        int row = lp->addRow(rowName.str(), 1, shared::optim::FIX);
+        // the position variables of a line are consecutive columns
+        vars->pos[{e, l.line}] = m->getNumCols();
 
         for (size_t p = 0; p < e->pl().getCardinality(); p++) {
-          std::string varName = getILPVarName(e, l.line, p);
-          int curCol = lp->addCol(varName, shared::optim::BIN, 0);
-
-          lp->addColToRow(row, curCol, 1);
-          lp->addColToRow(rowA + p, curCol, 1);
+          int curCol = m->addCol(
+              shared::optim::BIN, 0,
+              m->hasNames() ? getILPVarName(e, l.line, p) : "");
 
-          i++;
+          m->addColToRow(row, curCol, 1);
+          m->addColToRow(rowA + p, curCol, 1);
         }
       }
     }
   }
 
-  lp->update();
-
-  writeSameSegConstraints(og, g, lp);
-  writeDiffSegConstraints(og, g, lp);
-
-  return lp;
+  writeSameSegConstraints(og, g, *vars, m);
+  writeDiffSegConstraints(og, g, *vars, m);
 }
 
 // _____________________________________________________________________________
 void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
                                            const std::set<OptNode*>& g,
-                                           ILPSolver* lp) const {
+                                           const ILPVars& vars,
+                                           ILPModel* m) const {
   UNUSED(og);
   // go into nodes and build crossing constraints for adjacent
   for (OptNode* node : g) {
@@ -203,97 +208,92 @@ void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
           // try all position combinations
 
           // introduce dec var
-          std::stringstream ss;
-          ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
-             << segmentB->pl().getStrRepr() << "," << linepair.first.line << "("
-             << linepair.first.line->id() << ")," << linepair.second.line << "("
-             << linepair.second.line->id() << ")," << node << ")";
-
-          int decisionVar = lp->addCol(
-              ss.str(), shared::optim::BIN,
+          int decisionVar = m->addCol(
+              shared::optim::BIN,
               getCrossingPenaltySameSeg(node)
                   // multiply the penalty with the number of collapsed lines!
                   * (linepair.first.relatives.size()) *
-                  (linepair.second.relatives.size()));
+                  (linepair.second.relatives.size()),
+              m->name("x_dec(", segmentA->pl().getStrRepr(), ",",
+                      segmentB->pl().getStrRepr(), ",", linepair.first.line,
+                      "(", linepair.first.line->id(), "),",
+                      linepair.second.line, "(", linepair.second.line->id(),
+                      "),", node, ")"));
 
           // introduce dec var for sep
-          std::stringstream sss;
-          sss << "x||_dec(" << segmentA->pl().getStrRepr() << ","
-              << segmentB->pl().getStrRepr() << "," << linepair.first.line
-              << "(" << linepair.first.line->id() << "),"
-              << linepair.second.line << "(" << linepair.second.line->id()
-              << ")," << node << ")";
-
           int decisionVarSep = 0;
           if (separationOpt()) {
-            decisionVarSep = lp->addCol(sss.str(), shared::optim::BIN,
-                                        getSeparationPenalty(node));
+            decisionVarSep = m->addCol(
+                shared::optim::BIN, getSeparationPenalty(node),
+                m->name("x||_dec(", segmentA->pl().getStrRepr(), ",",
+                        segmentB->pl().getStrRepr(), ",", linepair.first.line,
+                        "(", linepair.first.line->id(), "),",
+                        linepair.second.line, "(",
+                        linepair.second.line->id(), "),", node, ")"));
           }
 
           for (PosComPair poscomb :
                getPositionCombinations(segmentA, segmentB)) {
             if (crosses(node, segmentA, segmentB, poscomb)) {
-              int lineAinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.first.line, poscomb.first.first));
-              int lineBinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.second.line, poscomb.second.first));
-              int lineAinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.first.line, poscomb.first.second));
-              int lineBinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.second.line, poscomb.second.second));
+              int lineAinAatP = vars.getPos(segmentA, linepair.first.line,
+                                            poscomb.first.first);
+              int lineBinAatP = vars.getPos(segmentA, linepair.second.line,
+                                            poscomb.second.first);
+              int lineAinBatP = vars.getPos(segmentB, linepair.first.line,
+                                            poscomb.first.second);
+              int lineBinBatP = vars.getPos(segmentB, linepair.second.line,
+                                            poscomb.second.second);
 
               assert(lineAinAatP > -1);
               assert(lineAinBatP > -1);
               assert(lineBinAatP > -1);
               assert(lineBinBatP > -1);
 
-              std::stringstream ss;
-              ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
-                 << segmentB->pl().getStrRepr() << "," << linepair.first.line
-                 << "," << linepair.second.line << "pa=" << poscomb.first.first
-                 << ",pb=" << poscomb.second.first
-                 << ",pa'=" << poscomb.first.second
-                 << ",pb'=" << poscomb.second.second << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 3, shared::optim::UP);
-
-              lp->addColToRow(row, lineAinAatP, 1);
-              lp->addColToRow(row, lineBinAatP, 1);
-              lp->addColToRow(row, lineAinBatP, 1);
-              lp->addColToRow(row, lineBinBatP, 1);
-              lp->addColToRow(row, decisionVar, -1);
+              int row = m->addRow(
+                  3, shared::optim::UP,
+                  m->name("dec_sum(", segmentA->pl().getStrRepr(), ",",
+                          segmentB->pl().getStrRepr(), ",",
+                          linepair.first.line, ",", linepair.second.line,
+                          "pa=", poscomb.first.first, ",pb=",
+                          poscomb.second.first, ",pa'=", poscomb.first.second,
+                          ",pb'=", poscomb.second.second, ",n=", node, ")"));
+
+              m->addColToRow(row, lineAinAatP, 1);
+              m->addColToRow(row, lineBinAatP, 1);
+              m->addColToRow(row, lineAinBatP, 1);
+              m->addColToRow(row, lineBinBatP, 1);
+              m->addColToRow(row, decisionVar, -1);
             }
 
             if (separationOpt() && separates(poscomb)) {
-              int lineAinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.first.line, poscomb.first.first));
-              int lineBinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.second.line, poscomb.second.first));
-              int lineAinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.first.line, poscomb.first.second));
-              int lineBinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.second.line, poscomb.second.second));
+              int lineAinAatP = vars.getPos(segmentA, linepair.first.line,
+                                            poscomb.first.first);
+              int lineBinAatP = vars.getPos(segmentA, linepair.second.line,
+                                            poscomb.second.first);
+              int lineAinBatP = vars.getPos(segmentB, linepair.first.line,
+                                            poscomb.first.second);
+              int lineBinBatP = vars.getPos(segmentB, linepair.second.line,
+                                            poscomb.second.second);
 
               assert(lineAinAatP > -1);
               assert(lineAinBatP > -1);
               assert(lineBinAatP > -1);
               assert(lineBinBatP > -1);
 
-              std::stringstream ss;
-              ss << "dec_sum_sep(" << segmentA->pl().getStrRepr() << ","
-                 << segmentB->pl().getStrRepr() << "," << linepair.first.line
-                 << "," << linepair.second.line << "pa=" << poscomb.first.first
-                 << ",pb=" << poscomb.second.first
-                 << ",pa'=" << poscomb.first.second
-                 << ",pb'=" << poscomb.second.second << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 3, shared::optim::UP);
-
-              lp->addColToRow(row, lineAinAatP, 1);
-              lp->addColToRow(row, lineBinAatP, 1);
-              lp->addColToRow(row, lineAinBatP, 1);
-              lp->addColToRow(row, lineBinBatP, 1);
-              lp->addColToRow(row, decisionVarSep, -1);
+              int row = m->addRow(
+                  3, shared::optim::UP,
+                  m->name("dec_sum_sep(", segmentA->pl().getStrRepr(), ",",
+                          segmentB->pl().getStrRepr(), ",",
+                          linepair.first.line, ",", linepair.second.line,
+                          "pa=", poscomb.first.first, ",pb=",
+                          poscomb.second.first, ",pa'=", poscomb.first.second,
+                          ",pb'=", poscomb.second.second, ",n=", node, ")"));
+
+              m->addColToRow(row, lineAinAatP, 1);
+              m->addColToRow(row, lineBinAatP, 1);
+              m->addColToRow(row, lineAinBatP, 1);
+              m->addColToRow(row, lineBinBatP, 1);
+              m->addColToRow(row, decisionVarSep, -1);
             }
           }
         }
@@ -305,7 +305,8 @@ void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
 // _____________________________________________________________________________
 void ILPOptimizer::writeDiffSegConstraints(OptGraph* og,
                                            const std::set<OptNode*>& g,
-                                           ILPSolver* lp) const {
+                                           const ILPVars& vars,
+                                           ILPModel* m) const {
   UNUSED(og);
   // go into nodes and build crossing constraints for adjacent
   for (OptNode* node : g) {
@@ -319,43 +320,41 @@ void ILPOptimizer::writeDiffSegConstraints(OptGraph* og,
           // try all position combinations
 
           // introduce dec var
-          std::stringstream ss;
-          ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
-             << segments.first->pl().getStrRepr()
-             << segments.second->pl().getStrRepr() << "," << linepair.first.line
-             << "(" << linepair.first.line->id() << ")," << linepair.second.line
-             << "(" << linepair.second.line->id() << ")," << node << ")";
-
-          int decisionVar = lp->addCol(
-              ss.str(), shared::optim::BIN,
+          int decisionVar = m->addCol(
+              shared::optim::BIN,
               getCrossingPenaltyDiffSeg(node)
                   // multiply the penalty with the number of collapsed lines!
                   * (linepair.first.relatives.size()) *
-                  (linepair.second.relatives.size()));
+                  (linepair.second.relatives.size()),
+              m->name("x_dec(", segmentA->pl().getStrRepr(), ",",
+                      segments.first->pl().getStrRepr(),
+                      segments.second->pl().getStrRepr(), ",",
+                      linepair.first.line, "(", linepair.first.line->id(),
+                      "),", linepair.second.line, "(",
+                      linepair.second.line->id(), "),", node, ")"));
 
           for (PosCom poscomb : getPositionCombinations(segmentA)) {
             if (crosses(node, segmentA, segments, poscomb)) {
-              int lineAinAatP = lp->getVarByName(
-                  getILPVarName(segmentA, linepair.first.line, poscomb.first));
-              int lineBinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.second.line, poscomb.second));
+              int lineAinAatP =
+                  vars.getPos(segmentA, linepair.first.line, poscomb.first);
+              int lineBinAatP =
+                  vars.getPos(segmentA, linepair.second.line, poscomb.second);
 
               assert(lineAinAatP > -1);
               assert(lineBinAatP > -1);
 
-              std::stringstream ss;
-              ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
-                 << segments.first->pl().getStrRepr()
-                 << segments.second->pl().getStrRepr() << ","
-                 << linepair.first.line << "," << linepair.second.line
-                 << "pa=" << poscomb.first << ",pb=" << poscomb.second
-                 << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 1, shared::optim::UP);
-
-              lp->addColToRow(row, lineAinAatP, 1);
-              lp->addColToRow(row, lineBinAatP, 1);
-              lp->addColToRow(row, decisionVar, -1);
+              int row = m->addRow(
+                  1, shared::optim::UP,
+                  m->name("dec_sum(", segmentA->pl().getStrRepr(), ",",
+                          segments.first->pl().getStrRepr(),
+                          segments.second->pl().getStrRepr(), ",",
+                          linepair.first.line, ",", linepair.second.line,
+                          "pa=", poscomb.first, ",pb=", poscomb.second,
+                          ",n=", node, ")"));
+
+              m->addColToRow(row, lineAinAatP, 1);
+              m->addColToRow(row, lineBinAatP, 1);
+              m->addColToRow(row, decisionVar, -1);
             }
           }
         }
@@ -414,3 +413,24 @@ std::string ILPOptimizer::getILPVarName(OptEdge* seg, const Line* r,
 
 // _____________________________________________________________________________
 bool ILPOptimizer::separationOpt() const { return _scorer.optimizeSep(); }
+
+// _____________________________________________________________________________
+int ILPVars::getPos(const OptEdge* e, const Line* l, size_t p) const {
+  auto i = pos.find({e, l});
+  if (i == pos.end() || p >= e->pl().getCardinality()) return -1;
+  return i->second + p;
+}
+
+// _____________________________________________________________________________
+int ILPVars::getSmaller(const OptEdge* e, const Line* a, const Line* b) const {
+  auto i = smaller.find(EdgeLinePair(e, a, b));
+  if (i == smaller.end()) return -1;
+  return i->second;
+}
+
+// _____________________________________________________________________________
+int ILPVars::getNear(const OptEdge* e, const Line* a, const Line* b) const {
+  auto i = near.find(EdgeLinePair(e, a, b));
+  if (i == near.end()) return -1;
+  return i->second;
+}
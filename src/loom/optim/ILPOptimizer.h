@@ -5,17 +5,46 @@
 #ifndef LOOM_OPTIM_ILPOPTIMIZER_H_
 #define LOOM_OPTIM_ILPOPTIMIZER_H_
 
+#include <map>
+#include <tuple>
+#include <utility>
 #include "loom/optim/ExhaustiveOptimizer.h"
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/Optimizer.h"
 #include "shared/linegraph/Line.h"
+#include "shared/optim/ILPModel.h"
 #include "shared/optim/ILPSolver.h"
 #include "shared/rendergraph/OrderCfg.h"
 
 namespace loom {
 namespace optim {
 
+typedef std::tuple<const OptEdge*, const shared::linegraph::Line*,
+                   const shared::linegraph::Line*>
+    EdgeLinePair;
+
+// column ids of the ILP variables
+struct ILPVars {
+  // first of the consecutive position variables of a line in an edge
+  std::map<std::pair<const OptEdge*, const shared::linegraph::Line*>, int>
+      pos;
+
+  // line A before line B in an edge
+  std::map<EdgeLinePair, int> smaller;
+
+  // lines A and B next to each other in an edge
+  std::map<EdgeLinePair, int> near;
+
+  // -1 if there is no such variable
+  int getPos(const OptEdge* e, const shared::linegraph::Line* l,
+             size_t p) const;
+  int getSmaller(const OptEdge* e, const shared::linegraph::Line* a,
+                 const shared::linegraph::Line* b) const;
+  int getNear(const OptEdge* e, const shared::linegraph::Line* a,
+              const shared::linegraph::Line* b) const;
+};
+
 class ILPOptimizer : public Optimizer {
  public:
   ILPOptimizer(const config::Config* cfg,
@@ -28,21 +57,24 @@ class ILPOptimizer : public Optimizer {
 
  protected:
   const loom::optim::ExhaustiveOptimizer _exhausOpt;
-  virtual shared::optim::ILPSolver* createProblem(
-      OptGraph* og, const std::set<OptNode*>& g) const;
+  virtual void createProblem(OptGraph* og, const std::set<OptNode*>& g,
+                             shared::optim::ILPModel* m, ILPVars* vars) const;
 
   virtual void getConfigurationFromSolution(
-      shared::optim::ILPSolver* lp, shared::rendergraph::HierarOrderCfg* c,
+      shared::optim::ILPSolver* lp, const ILPVars& vars,
+      shared::rendergraph::HierarOrderCfg* c,
       const std::set<OptNode*>& g) const;
 
   std::string getILPVarName(OptEdge* e, const shared::linegraph::Line* r,
                             size_t p) const;
 
   void writeSameSegConstraints(OptGraph* og, const std::set<OptNode*>& g,
-                               shared::optim::ILPSolver* lp) const;
+                               const ILPVars& vars,
+                               shared::optim::ILPModel* m) const;
 
   void writeDiffSegConstraints(OptGraph* og, const std::set<OptNode*>& g,
-                               shared::optim::ILPSolver* lp) const;
+                               const ILPVars& vars,
+                               shared::optim::ILPModel* m) const;
 
   std::vector<PosComPair> getPositionCombinations(OptEdge* a, OptEdge* b) const;
   std::vector<PosCom> getPositionCombinations(OptEdge* a) const;
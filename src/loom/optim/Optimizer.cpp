@@ -2,6 +2,8 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <exception>
 #include <fstream>
 #include <numeric>
 #include "loom/optim/NullOptimizer.h"
@@ -12,6 +14,13 @@
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/Algorithm.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_thread_num() 0
+#define omp_get_max_threads() 1
+#define omp_set_max_active_levels(n)
+#endif
 
 using loom::optim::EdgePair;
 using loom::optim::LinePair;
@@ -140,136 +149,167 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
   }
 
   size_t runs = _cfg->optimRuns;
-  double tSum = 0;
-  double scoreSum = 0;
-  double crossSum = 0;
-  double crossSumSame = 0;
-  double crossSumDiff = 0;
-  double sepSum = 0;
-
-  // for trivial cases
-  const NullOptimizer nullOpt(_cfg, _scorer.getPens());
-
-  double bestScore = std::numeric_limits<double>::infinity();
-  OrderCfg bestCfg;
 
-  for (size_t run = 0; run < runs; run++) {
-    OrderCfg c;
-    HierarOrderCfg hc;
-
-    double t = 0;
-    double maxCompSolSpace = 0;
-    size_t maxCompC = 0;
-    size_t maxNumNodes = 0;
-    size_t maxNumEdges = 0;
-    size_t numM1Comps = 0;
-
-    optResStats.maxNumRowsPerComp = 0;
-    optResStats.maxNumColsPerComp = 0;
-
-    for (const auto& nds : comps) {
-      if (_cfg->outputStats) {
-        size_t maxC = maxCard(nds);
-        double solSp = solutionSpaceSize(nds);
-
-        // skip trivial components
-        if (nds.size() > 2) {
-          if (maxC > maxCompC) maxCompC = maxC;
-          if (solSp > maxCompSolSpace) maxCompSolSpace = solSp;
-          if (solSp == 1) numM1Comps++;
-          if (nds.size() > maxNumNodes) maxNumNodes = nds.size();
-          if (numEdges(nds) > maxNumEdges) maxNumEdges = numEdges(nds);
-
-          LOGTO(INFO, std::cerr)
-              << " (stats) Optimizing subgraph of size " << nds.size()
-              << " with max cardinality = " << maxC
-              << " and solution space size = " << solSp;
-        }
-      }
+  double maxCompSolSpace = 0;
+  size_t maxCompC = 0;
+  size_t maxNumNodes = 0;
+  size_t maxNumEdges = 0;
+  size_t numM1Comps = 0;
 
-      // this is the implementation of the single edge pruning described in the
-      // publication - simple skip such components
-      // we also skip components with only single edges
-      if (maxC > 1 && nds.size() > 2) {
-        t += optimizeComp(&g, nds, &hc, optResStats);
-      } else {
-        t += nullOpt.optimizeComp(&g, nds, &hc, 0, optResStats);
+  for (const auto& nds : comps) {
+    if (_cfg->outputStats) {
+      size_t maxC = maxCard(nds);
+      double solSp = solutionSpaceSize(nds);
+
+      // skip trivial components
+      if (nds.size() > 2) {
+        if (maxC > maxCompC) maxCompC = maxC;
+        if (solSp > maxCompSolSpace) maxCompSolSpace = solSp;
+        if (solSp == 1) numM1Comps++;
+        if (nds.size() > maxNumNodes) maxNumNodes = nds.size();
+        if (numEdges(nds) > maxNumEdges) maxNumEdges = numEdges(nds);
+
+        LOGTO(INFO, std::cerr)
+            << " (stats) Optimizing subgraph of size " << nds.size()
+            << " with max cardinality = " << maxC
+            << " and solution space size = " << solSp;
       }
     }
+  }
 
-    optResStats.nonTrivialComponents = nonTrivialComponents;
-    optResStats.numCompsSolSpaceOne = numM1Comps;
-    optResStats.maxNumNodesPerComp = maxNumNodes;
-    optResStats.maxNumEdgesPerComp = maxNumEdges;
-    optResStats.maxCardPerComp = maxCompC;
-    optResStats.maxCompSolSpace = maxCompSolSpace;
+  optResStats.nonTrivialComponents = nonTrivialComponents;
+  optResStats.numCompsSolSpaceOne = numM1Comps;
+  optResStats.maxNumNodesPerComp = maxNumNodes;
+  optResStats.maxNumEdgesPerComp = maxNumEdges;
+  optResStats.maxCardPerComp = maxCompC;
+  optResStats.maxCompSolSpace = maxCompSolSpace;
+  optResStats.maxNumRowsPerComp = 0;
+  optResStats.maxNumColsPerComp = 0;
 
-    if (_cfg->outputStats) {
-      LOGTO(INFO, std::cerr) << "(stats) Number of nontrivial components: "
-                             << optResStats.nonTrivialComponents;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Number of nontrivial components with sol space size 1: "
-          << optResStats.numCompsSolSpaceOne;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max number of nodes of all nontrivial components: "
-          << optResStats.maxNumNodesPerComp;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max number of edges of all nontrivial components: "
-          << optResStats.maxNumEdgesPerComp;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max cardinality of all nontrivial components: "
-          << optResStats.maxCardPerComp;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max solution space size of all nontrivial components: "
-          << optResStats.maxCompSolSpace;
-    }
+  if (_cfg->outputStats) {
+    LOGTO(INFO, std::cerr) << "(stats) Number of nontrivial components: "
+                           << optResStats.nonTrivialComponents;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Number of nontrivial components with sol space size 1: "
+        << optResStats.numCompsSolSpaceOne;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max number of nodes of all nontrivial components: "
+        << optResStats.maxNumNodesPerComp;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max number of edges of all nontrivial components: "
+        << optResStats.maxNumEdgesPerComp;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max cardinality of all nontrivial components: "
+        << optResStats.maxCardPerComp;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max solution space size of all nontrivial components: "
+        << optResStats.maxCompSolSpace;
+  }
 
-    hc.writeFlatCfg(&c);
-
-    // fill in missing edges (which may have been pruned in the optim graph)
-    // use the input ordering for these edges
-    for (auto n : rg->getNds()) {
-      for (auto e : n->getAdjList()) {
-        if (e->getFrom() != n) continue;
-        if (c.find(e) == c.end()) {
-          Ordering o(e->pl().getLines().size());
-          std::iota(o.begin(), o.end(), 0);
-          c[e] = o;
+  // schedule components with the largest solution space first, so that a
+  // single expensive component does not end up at the tail of the schedule
+  std::vector<double> compSolSp(comps.size());
+  for (size_t i = 0; i < comps.size(); i++)
+    compSolSp[i] = solutionSpaceSize(comps[i]);
+
+  std::vector<size_t> compOrder(comps.size());
+  std::iota(compOrder.begin(), compOrder.end(), 0);
+  std::stable_sort(compOrder.begin(), compOrder.end(),
+                   [&compSolSp](size_t a, size_t b) {
+                     return compSolSp[a] > compSolSp[b];
+                   });
+
+  // the graph used for scoring is only read, build it once for all runs
+  OptGraph gg(&_scorer);
+  auto ndMap = gg.build(rg);
+
+  // every run (and every component in it) gets its own RNG seeded from this
+  size_t seed = _cfg->seed ? _cfg->seed : rand();
+
+  // distribute the available threads over the runs first, the rest is used
+  // for the components inside each run
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+  size_t runThreads = std::max<size_t>(1, std::min(threads, runs));
+  size_t compThreads = std::max<size_t>(1, threads / runThreads);
+  if (runThreads > 1 && compThreads > 1) omp_set_max_active_levels(2);
+
+  std::vector<OrderCfg> cfgs(runs);
+  std::vector<OptResStats> runStats(runs, optResStats);
+  std::vector<double> ts(runs, 0), scores(runs, 0);
+  std::vector<std::pair<size_t, size_t>> crossings(runs);
+  std::vector<size_t> separations(runs, 0);
+  std::exception_ptr err;
+
+#pragma omp parallel for num_threads(runThreads) schedule(dynamic, 1)
+  for (size_t run = 0; run < runs; run++) {
+    try {
+      OrderCfg& c = cfgs[run];
+      ts[run] = optimizeRun(&g, comps, compOrder, maxC, seed, run, compThreads,
+                            &c, runStats[run]);
+
+      // fill in missing edges (which may have been pruned in the optim graph)
+      // use the input ordering for these edges
+      for (auto n : rg->getNds()) {
+        for (auto e : n->getAdjList()) {
+          if (e->getFrom() != n) continue;
+          if (c.find(e) == c.end()) {
+            Ordering o(e->pl().getLines().size());
+            std::iota(o.begin(), o.end(), 0);
+            c[e] = o;
+          }
         }
       }
-    }
-
-    tSum += t;
-
-    OptGraph gg(&_scorer);
-    auto ndMap = gg.build(rg);
 
-    auto optCfg = getOptOrderCfg(c, ndMap, &gg);
+      auto optCfg = getOptOrderCfg(c, ndMap, &gg);
 
-    double score = _scorer.getCrossingScore(&gg, optCfg);
+      scores[run] = _scorer.getCrossingScore(&gg, optCfg);
+      if (_scorer.optimizeSep())
+        scores[run] += _scorer.getSeparationScore(&gg, optCfg);
 
-    if (_scorer.optimizeSep()) score += _scorer.getSeparationScore(&gg, optCfg);
+      crossings[run] = _scorer.getNumCrossings(&gg, optCfg);
+      separations[run] = _scorer.getNumSeparations(&gg, optCfg);
+    } catch (...) {
+#pragma omp critical(loom_optim_err)
+      if (!err) err = std::current_exception();
+    }
+  }
 
-    scoreSum += score;
+  if (err) std::rethrow_exception(err);
 
-    auto crossings = _scorer.getNumCrossings(&gg, optCfg);
-    crossSumSame += crossings.first;
-    crossSumDiff += crossings.second;
-    crossSum += crossings.first + crossings.second;
+  double tSum = 0;
+  double scoreSum = 0;
+  double crossSum = 0;
+  double crossSumSame = 0;
+  double crossSumDiff = 0;
+  double sepSum = 0;
 
-    size_t separations = _scorer.getNumSeparations(&gg, optCfg);
+  // take the first best run, independent of the order the runs finished in
+  size_t best = 0;
 
-    sepSum += separations;
+  for (size_t run = 0; run < runs; run++) {
+    tSum += ts[run];
+    scoreSum += scores[run];
+    crossSumSame += crossings[run].first;
+    crossSumDiff += crossings[run].second;
+    crossSum += crossings[run].first + crossings[run].second;
+    sepSum += separations[run];
+
+    optResStats.maxNumRowsPerComp = std::max(optResStats.maxNumRowsPerComp,
+                                             runStats[run].maxNumRowsPerComp);
+    optResStats.maxNumColsPerComp = std::max(optResStats.maxNumColsPerComp,
+                                             runStats[run].maxNumColsPerComp);
+
+    if (scores[run] < scores[best]) best = run;
+  }
 
-    if (score < bestScore) {
-      bestCfg = c;
-      bestScore = score;
+  OrderCfg bestCfg;
 
-      optResStats.score = score;
-      optResStats.sameSegCrossings = crossings.first;
-      optResStats.diffSegCrossings = crossings.second;
-      optResStats.separations = separations;
-    }
+  if (runs) {
+    bestCfg = cfgs[best];
+    optResStats.score = scores[best];
+    optResStats.sameSegCrossings = crossings[best].first;
+    optResStats.diffSegCrossings = crossings[best].second;
+    optResStats.separations = separations[best];
   }
 
   rg->writePermutation(bestCfg);
@@ -304,6 +344,78 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
   return optResStats;
 }
 
+// _____________________________________________________________________________
+double Optimizer::optimizeRun(OptGraph* g,
+                              const std::vector<std::set<OptNode*>>& comps,
+                              const std::vector<size_t>& compOrder,
+                              size_t maxC, size_t seed, size_t run,
+                              size_t threads, OrderCfg* c,
+                              OptResStats& stats) const {
+  // for trivial cases
+  const NullOptimizer nullOpt(_cfg, _scorer.getPens());
+
+  threads = std::max<size_t>(1, std::min(threads, comps.size()));
+
+  // components are independent, each writes only the orderings of its own
+  // edges, so we optimize them in parallel. Every thread writes into its
+  // own shard, which are merged afterwards.
+  std::vector<HierarOrderCfg> hcs(threads);
+  std::vector<OptResStats> thrStats(threads, stats);
+  std::vector<double> compT(comps.size(), 0);
+  std::exception_ptr err;
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+  for (size_t i = 0; i < compOrder.size(); i++) {
+    size_t thr = omp_get_thread_num();
+    const auto& nds = comps[compOrder[i]];
+
+    // seed per component, so that the result does not depend on which
+    // thread optimizes it
+    std::seed_seq seq{seed, run, compOrder[i]};
+    rng().seed(seq);
+
+    try {
+      // this is the implementation of the single edge pruning described in
+      // the publication - simple skip such components
+      // we also skip components with only single edges
+      if (maxC > 1 && nds.size() > 2) {
+        compT[compOrder[i]] = optimizeComp(g, nds, &hcs[thr], thrStats[thr]);
+      } else {
+        compT[compOrder[i]] =
+            nullOpt.optimizeComp(g, nds, &hcs[thr], 0, thrStats[thr]);
+      }
+    } catch (...) {
+#pragma omp critical(loom_optim_err)
+      if (!err) err = std::current_exception();
+    }
+  }
+
+  if (err) std::rethrow_exception(err);
+
+  HierarOrderCfg hc;
+
+  for (size_t i = 0; i < threads; i++) {
+    hc.merge(hcs[i]);
+    stats.maxNumRowsPerComp =
+        std::max(stats.maxNumRowsPerComp, thrStats[i].maxNumRowsPerComp);
+    stats.maxNumColsPerComp =
+        std::max(stats.maxNumColsPerComp, thrStats[i].maxNumColsPerComp);
+  }
+
+  hc.writeFlatCfg(c);
+
+  double t = 0;
+  for (double compTime : compT) t += compTime;
+
+  return t;
+}
+
+// _____________________________________________________________________________
+std::mt19937& Optimizer::rng() {
+  static thread_local std::mt19937 rng;
+  return rng;
+}
+
 // _____________________________________________________________________________
 std::vector<LinePair> Optimizer::getLinePairs(OptEdge* segment) {
   return getLinePairs(segment, false);
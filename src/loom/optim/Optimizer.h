@@ -2,6 +2,7 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <random>
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -76,7 +77,16 @@ class Optimizer {
 
   static std::string prefix(size_t depth);
 
+  // RNG of the calling thread, re-seeded for every component
+  static std::mt19937& rng();
+
  private:
+  double optimizeRun(OptGraph* g, const std::vector<std::set<OptNode*>>& comps,
+                     const std::vector<size_t>& compOrder, size_t maxC,
+                     size_t seed, size_t run, size_t threads,
+                     shared::rendergraph::OrderCfg* c,
+                     OptResStats& stats) const;
+
   static OptOrderCfg getOptOrderCfg(
       const shared::rendergraph::OrderCfg&,
       const std::map<const shared::linegraph::LineNode*, OptNode*>& ndMap,
@@ -3,7 +3,9 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <random>
 #include <unordered_map>
+#include "loom/optim/DeltaScorer.h"
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/SimulatedAnnealingOptimizer.h"
 #include "util/log/Log.h"
@@ -24,6 +26,7 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
   T_START(1);
   UNUSED(depth);
   UNUSED(stats);
+  UNUSED(og);
   OptOrderCfg cur;
 
   // fixed order list of optim graph edges
@@ -42,45 +45,41 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
     greedy.getFlatConfig(g, &cur);
   }
 
+  // score changes are computed incrementally on a flat copy of cur
+  DeltaScorer scorer(&_optScorer, g, cur, _optScorer.optimizeSep());
+
   size_t iters = 0;
 
   size_t k = 0;
 
   size_t ABORT_AFTER_UNCH = 5;
 
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+
   while (true) {
     iters++;
 
     double temp = 1000.0 / iters;
 
     for (size_t i = 0; i < edges.size(); i++) {
-      double oldScore = getScore(og, edges[i], cur);
+      size_t card = scorer.getCardinality(edges[i]);
 
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
-          // switch p1 and p2
-          auto tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
+      for (size_t p1 = 0; p1 < card; p1++) {
+        for (size_t p2 = p1; p2 < card; p2++) {
+          // score change if p1 and p2 were switched
+          double delta = scorer.getSwapDelta(edges[i], p1, p2);
 
-          double s = getScore(og, edges[i], cur);
+          double r = dist(rng());
+          double e = exp(-delta / temp);
 
-          double r = rand() / (RAND_MAX + 1.0);
-          double e = exp(-(1.0 * (s - oldScore)) / temp);
-
-          if (s < oldScore) {
-            // found a better solution, keep it, update score
-            oldScore = s;
+          if (delta < 0) {
+            // found a better solution, keep it
+            scorer.swap(edges[i], p1, p2);
             k = iters;
-          } else if (s != oldScore && e > r) {
-            // keep solution, despite not bringing any local gain, update score
-            oldScore = s;
+          } else if (delta != 0 && e > r) {
+            // keep solution, despite not bringing any local gain
+            scorer.swap(edges[i], p1, p2);
             k = iters;
-          } else {
-            // switch back
-            tmp = cur[edges[i]][p1];
-            cur[edges[i]][p1] = cur[edges[i]][p2];
-            cur[edges[i]][p2] = tmp;
           }
         }
       }
@@ -89,6 +88,8 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
     if (iters - k > ABORT_AFTER_UNCH) break;
   }
 
+  scorer.getOrderCfg(&cur);
+
   writeHierarch(&cur, hc);
   return T_STOP(1);
 }
@@ -2,9 +2,14 @@
 // Author: Patrick Brosi
 //
 
+#include <fstream>
+#include <random>
+#include <stdexcept>
 #include <vector>
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/CombOptimizer.h"
+#include "loom/optim/DeltaScorer.h"
+#include "util/graph/Algorithm.h"
 #include "shared/rendergraph/RenderGraph.h"
 
 struct FileTest {
@@ -428,6 +433,99 @@ int main(int argc, char** argv) {
 
   shared::rendergraph::Penalties pens{1, 0, 1, 1, 0, 1, 1, 0, false, false};
 
+  // incremental scoring
+  {
+    shared::rendergraph::Penalties pensLoc{3, 2, 4, 1, 3, 12, 3, 9, true, true};
+    loom::optim::OptGraphScorer scorer(pensLoc);
+    std::mt19937 rng(42);
+
+    auto tests = fileTests;
+    tests.push_back({"/home/patrick/repos/loom/src/loom/tests/datasets/"
+                     "freiburg-tram.json",
+                     0, 0, 0, 0, 0, 0});
+
+    for (const auto& test : tests) {
+      for (size_t untangle = 0; untangle < 2; untangle++) {
+        shared::rendergraph::RenderGraph rg(5, 5);
+
+        std::ifstream input;
+        input.open(test.fname);
+        rg.readFromJson(&input, 3);
+
+        loom::optim::OptGraph g(&scorer);
+        g.build(&rg);
+
+        if (untangle) {
+          g.partnerLines();
+          g.untangle();
+          g.contractDeg2Nds();
+          g.splitSingleLineEdgs();
+          g.terminusDetach();
+        }
+
+        for (const auto& comp :
+             util::graph::Algorithm::connectedComponents(g)) {
+          loom::optim::OptOrderCfg cfg;
+          std::vector<loom::optim::OptEdge*> edges;
+
+          for (auto n : comp) {
+            for (auto e : n->getAdjList()) {
+              if (e->getFrom() != n) continue;
+              edges.push_back(e);
+              for (const auto& lo : e->pl().getLines())
+                cfg[e].push_back(lo.line);
+              std::shuffle(cfg[e].begin(), cfg[e].end(), rng);
+            }
+          }
+
+          for (size_t sep = 0; sep < 2; sep++) {
+            auto cur = cfg;
+            loom::optim::DeltaScorer ds(&scorer, comp, cur, sep);
+
+            double score = sep ? scorer.getTotalScore(comp, cur)
+                               : scorer.getCrossingScore(comp, cur);
+            TEST(ds.getScore(), ==, score);
+
+            for (size_t i = 0; i < 200 && edges.size(); i++) {
+              auto e = edges[rng() % edges.size()];
+              if (cur[e].size() < 2) continue;
+              size_t p1 = rng() % cur[e].size();
+              size_t p2 = rng() % cur[e].size();
+
+              double old = sep ? scorer.getTotalScore(e, cur)
+                               : scorer.getCrossingScore(e, cur);
+              TEST(ds.getScore(e), ==, old);
+
+              double delta = ds.getSwapDelta(e, p1, p2);
+              std::swap(cur[e][p1], cur[e][p2]);
+              ds.swap(e, p1, p2);
+
+              double now = sep ? scorer.getTotalScore(e, cur)
+                               : scorer.getCrossingScore(e, cur);
+              TEST(delta, ==, now - old);
+              TEST(ds.getScore(e), ==, now);
+            }
+
+            loom::optim::OptOrderCfg res;
+            ds.getOrderCfg(&res);
+            TEST(res == cur);
+
+            // partial scores are lower bounds, and exact once all is fixed
+            double partial = 0;
+            for (auto e : edges) {
+              double inc = ds.fix(e);
+              TEST(inc, >=, 0);
+              partial += inc;
+              TEST(partial, <=, ds.getScore());
+            }
+            TEST(partial, ==, ds.getScore());
+            for (auto e : edges) ds.unfix(e);
+          }
+        }
+      }
+    }
+  }
+
   // without separation penalty
 
   std::vector<loom::config::Config> configs;
@@ -690,4 +788,28 @@ int main(int argc, char** argv) {
       }
     }
   }
+
+  {
+    // the exhaustive optimizer refuses components with a too large solution
+    // space
+    auto cfg = baseCfg;
+    cfg.exhaustMaxSolSpace = 1;
+    loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
+
+    shared::rendergraph::RenderGraph g(5, 5);
+
+    std::ifstream input;
+    input.open(
+        "/home/patrick/repos/loom/src/loom/tests/datasets/"
+        "freiburg-tram.json");
+    g.readFromJson(&input, 3);
+
+    bool thrown = false;
+    try {
+      exhausOptim.optimize(&g);
+    } catch (const std::runtime_error& e) {
+      thrown = true;
+    }
+    TEST(thrown);
+  }
 }
@@ -0,0 +1,43 @@
+// Copyright 2016
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#include <stdio.h>
+#include <unistd.h>
+#include <iostream>
+#include <string>
+#include "loomserver/config/ConfigReader.h"
+#include "loomserver/config/ServerConfig.h"
+#include "loomserver/server/Pipeline.h"
+#include "loomserver/server/RenderHandler.h"
+#include "util/http/Server.h"
+#include "util/log/Log.h"
+
+using loomserver::server::Pipeline;
+using loomserver::server::RenderHandler;
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  // initialize randomness
+  srand(time(NULL) + rand());
+
+  loomserver::config::Config cfg;
+
+  loomserver::config::ConfigReader cr;
+  cr.read(&cfg, argc, argv);
+
+  Pipeline pipeline(&cfg);
+  RenderHandler handler(&pipeline, cfg.cacheSize);
+
+  LOG(INFO) << "Listening on port " << cfg.port;
+
+  try {
+    util::http::HttpServer serv(cfg.port, &handler, cfg.threads);
+    serv.run();
+  } catch (const std::runtime_error& e) {
+    LOG(ERROR) << e.what();
+    exit(1);
+  }
+
+  return (0);
+}
@@ -0,0 +1,131 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <float.h>
+#include <getopt.h>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "loomserver/_config.h"
+#include "loomserver/config/ConfigReader.h"
+#include "util/String.h"
+#include "util/log/Log.h"
+
+using loomserver::config::ConfigReader;
+
+using std::exception;
+using std::string;
+using std::vector;
+
+static const char* YEAR = &__DATE__[7];
+static const char* COPY =
+    "University of Freiburg - Chair of Algorithms and Data Structures";
+static const char* AUTHORS = "Patrick Brosi <brosi@informatik.uni-freiburg.de>";
+
+// _____________________________________________________________________________
+static std::vector<std::string> splitArgs(const std::string& str) {
+  std::vector<std::string> ret;
+  for (const auto& arg : util::split(str, ' ')) {
+    if (arg.size()) ret.push_back(arg);
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________
+ConfigReader::ConfigReader() {}
+
+// _____________________________________________________________________________
+void ConfigReader::help(const char* bin) const {
+  std::cout << std::setfill(' ') << std::left << "loomserver (part of LOOM) "
+            << VERSION_FULL << "\n(built " << __DATE__ << " " << __TIME__ << ")"
+            << "\n\n(C) " << YEAR << " " << COPY << "\n"
+            << "Authors: " << AUTHORS << "\n\n"
+            << "Usage: " << bin << " [-p <port>]\n\n"
+            << "Renders line graphs POSTed to /render?stages=<stages>, where\n"
+            << "<stages> is a comma separated subsequence of\n"
+            << "topo,loom,octi,transitmap (default: all).\n\n"
+            << "Allowed options:\n\n"
+            << "General:\n"
+            << std::setw(37) << "  -v [ --version ]"
+            << "print version\n"
+            << std::setw(37) << "  -h [ --help ]"
+            << "show this help message\n"
+            << std::setw(37) << "  -p [ --port ] arg (=9090)"
+            << "port to listen on\n"
+            << std::setw(37) << "  --threads arg (=0)"
+            << "HTTP handler threads, 0 for default\n"
+            << std::setw(37) << "  --cache-size arg (=128)"
+            << "max number of cached stage results\n\n"
+            << "Stages:\n"
+            << std::setw(37) << "  --topo-args arg"
+            << "arguments passed to topo\n"
+            << std::setw(37) << "  --loom-args arg"
+            << "arguments passed to loom\n"
+            << std::setw(37) << "  --octi-args arg"
+            << "arguments passed to octi\n"
+            << std::setw(37) << "  --transitmap-args arg"
+            << "arguments passed to transitmap\n";
+}
+
+// _____________________________________________________________________________
+void ConfigReader::read(Config* cfg, int argc, char** argv) const {
+  struct option ops[] = {{"version", no_argument, 0, 'v'},
+                         {"help", no_argument, 0, 'h'},
+                         {"port", required_argument, 0, 'p'},
+                         {"threads", required_argument, 0, 1},
+                         {"cache-size", required_argument, 0, 2},
+                         {"topo-args", required_argument, 0, 3},
+                         {"loom-args", required_argument, 0, 4},
+                         {"octi-args", required_argument, 0, 5},
+                         {"transitmap-args", required_argument, 0, 6},
+                         {0, 0, 0, 0}};
+
+  char c;
+  while ((c = getopt_long(argc, argv, ":hvp:", ops, 0)) != -1) {
+    switch (c) {
+      case 'h':
+        help(argv[0]);
+        exit(0);
+      case 'v':
+        std::cout << "loomserver - (LOOM " << VERSION_FULL << ")"
+                  << std::endl;
+        exit(0);
+      case 'p':
+        cfg->port = atoi(optarg);
+        break;
+      case 1:
+        cfg->threads = atoi(optarg);
+        break;
+      case 2:
+        cfg->cacheSize = atoi(optarg);
+        break;
+      case 3:
+        cfg->topoArgs = splitArgs(optarg);
+        break;
+      case 4:
+        cfg->loomArgs = splitArgs(optarg);
+        break;
+      case 5:
+        cfg->octiArgs = splitArgs(optarg);
+        break;
+      case 6:
+        cfg->transitmapArgs = splitArgs(optarg);
+        break;
+      case ':':
+        std::cerr << argv[optind - 1];
+        std::cerr << " requires an argument" << std::endl;
+        exit(1);
+      case '?':
+        std::cerr << argv[optind - 1];
+        std::cerr << " option unknown" << std::endl;
+        exit(1);
+        break;
+      default:
+        std::cerr << "Error while parsing arguments" << std::endl;
+        exit(1);
+        break;
+    }
+  }
+}
@@ -0,0 +1,24 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOMSERVER_CONFIG_CONFIGREADER_H_
+#define LOOMSERVER_CONFIG_CONFIGREADER_H_
+
+#include <vector>
+#include "loomserver/config/ServerConfig.h"
+
+namespace loomserver {
+namespace config {
+
+class ConfigReader {
+ public:
+  ConfigReader();
+  void read(Config* targetConfig, int argc, char** argv) const;
+
+ private:
+  void help(const char* bin) const;
+};
+}  // namespace config
+}  // namespace loomserver
+#endif  // LOOMSERVER_CONFIG_CONFIGREADER_H_
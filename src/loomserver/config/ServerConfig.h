@@ -0,0 +1,33 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOMSERVER_CONFIG_SERVERCONFIG_H_
+#define LOOMSERVER_CONFIG_SERVERCONFIG_H_
+
+#include <string>
+#include <vector>
+
+namespace loomserver {
+namespace config {
+
+struct Config {
+  int port = 9090;
+
+  // number of HTTP handler threads, 0 for the server default
+  size_t threads = 0;
+
+  // maximum number of cached stage results
+  size_t cacheSize = 128;
+
+  // command line arguments passed to the stages
+  std::vector<std::string> topoArgs;
+  std::vector<std::string> loomArgs;
+  std::vector<std::string> octiArgs;
+  std::vector<std::string> transitmapArgs;
+};
+
+}  // namespace config
+}  // namespace loomserver
+
+#endif  // LOOMSERVER_CONFIG_SERVERCONFIG_H_
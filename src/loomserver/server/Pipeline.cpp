@@ -0,0 +1,284 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <getopt.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "loom/Loom.h"
+#include "loom/config/ConfigReader.h"
+#include "loomserver/server/Pipeline.h"
+#include "octi/Octi.h"
+#include "octi/basegraph/BaseGraph.h"
+#include "octi/config/ConfigReader.h"
+#include "shared/linegraph/BinGraphOutput.h"
+#include "shared/linegraph/LineGraph.h"
+#include "shared/rendergraph/RenderGraph.h"
+#include "topo/Topo.h"
+#include "topo/config/ConfigReader.h"
+#include "transitmap/TransitMap.h"
+#include "transitmap/config/ConfigReader.h"
+#include "util/String.h"
+#include "util/geo/output/GeoGraphJsonOutput.h"
+#include "util/json/Writer.h"
+#include "util/log/Log.h"
+
+using loomserver::server::Pipeline;
+using loomserver::server::Stage;
+using loomserver::server::StageErr;
+using octi::basegraph::BaseGraph;
+using shared::linegraph::LineGraph;
+using shared::rendergraph::RenderGraph;
+
+namespace {
+
+// _____________________________________________________________________________
+template <typename C, typename R>
+void readStageCfg(const std::string& name, const std::vector<std::string>& args,
+                  C* cfg) {
+  std::vector<std::string> strs{name};
+  strs.insert(strs.end(), args.begin(), args.end());
+
+  std::vector<char*> argv;
+  for (auto& s : strs) argv.push_back(&s[0]);
+  argv.push_back(0);
+
+  // the stage config readers use getopt, reset its state
+  optind = 1;
+  R().read(cfg, strs.size(), argv.data());
+}
+
+// _____________________________________________________________________________
+void readGraph(LineGraph* g, std::istream* in, LineGraph* prev,
+               double smooth) {
+  if (!in) {
+    g->readFromGraph(std::move(*prev), smooth);
+  } else if (LineGraph::isBinary(in)) {
+    g->readFromBinary(in, smooth);
+  } else {
+    g->readFromJson(in, smooth);
+  }
+}
+
+// _____________________________________________________________________________
+void printGraph(const LineGraph& g, const std::string& format, bool stats,
+                const util::json::Dict& jsonStats, std::ostream* out) {
+  if (format == "binary") {
+    shared::linegraph::BinGraphOutput binOut;
+    if (stats)
+      binOut.print(g, *out, jsonStats);
+    else
+      binOut.print(g, *out);
+  } else {
+    util::geo::output::GeoGraphJsonOutput jsonOut;
+    if (stats)
+      jsonOut.print(g, *out, jsonStats);
+    else
+      jsonOut.print(g, *out);
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+Pipeline::Pipeline(const config::Config* cfg) {
+  readStageCfg<topo::config::TopoConfig, topo::config::ConfigReader>(
+      "topo", cfg->topoArgs, &_topoCfg);
+  readStageCfg<loom::config::Config, loom::config::ConfigReader>(
+      "loom", cfg->loomArgs, &_loomCfg);
+  readStageCfg<octi::config::Config, octi::config::ConfigReader>(
+      "octi", cfg->octiArgs, &_octiCfg);
+  readStageCfg<transitmapper::config::Config,
+               transitmapper::config::ConfigReader>(
+      "transitmap", cfg->transitmapArgs, &_transitmapCfg);
+
+  if (_loomCfg.fromDot || _octiCfg.fromDot || _transitmapCfg.fromDot) {
+    LOG(WARN) << "Stages never read dot input, ignoring dot input flag.";
+  }
+
+  if (_transitmapCfg.renderMethod != "svg") {
+    LOG(ERROR) << "Unknown render method " << _transitmapCfg.renderMethod;
+    exit(1);
+  }
+
+  if (_octiCfg.obstaclePath.size()) {
+    _octiCfg.obstacles = octi::readObstacleFile(_octiCfg.obstaclePath);
+  }
+}
+
+// _____________________________________________________________________________
+std::string Pipeline::run(const std::vector<Stage>& stages,
+                          const std::string& in) const {
+  std::stringstream ss(in);
+  std::stringstream out;
+
+  // the graph handed over between stages
+  LineGraph g;
+
+  for (size_t i = 0; i < stages.size(); i++) {
+    std::istream* stageIn = i == 0 ? &ss : 0;
+    std::ostream* stageOut = i == stages.size() - 1 ? &out : 0;
+
+    switch (stages[i]) {
+      case TOPO:
+        topo(stageIn, &g, stageOut);
+        break;
+      case LOOM:
+        loom(stageIn, &g, stageOut);
+        break;
+      case OCTI:
+        octi(stageIn, &g, stageOut);
+        break;
+      case TRANSITMAP:
+        transitmap(stageIn, &g, stageOut);
+        break;
+    }
+  }
+
+  return out.str();
+}
+
+// _____________________________________________________________________________
+std::string Pipeline::getContentType(Stage stage) const {
+  std::string format;
+
+  switch (stage) {
+    case TOPO:
+      format = _topoCfg.outFormat;
+      break;
+    case LOOM:
+      format = _loomCfg.outFormat;
+      break;
+    case OCTI:
+      if (_octiCfg.printMode != "gridgraph") format = _octiCfg.outFormat;
+      break;
+    case TRANSITMAP:
+      if (!_transitmapCfg.tileDir.empty()) return "text/plain";
+      return "image/svg+xml";
+  }
+
+  if (format == "binary") return "application/octet-stream";
+  return "application/json";
+}
+
+// _____________________________________________________________________________
+std::string Pipeline::getName(Stage stage) {
+  switch (stage) {
+    case TOPO:
+      return "topo";
+    case LOOM:
+      return "loom";
+    case OCTI:
+      return "octi";
+    case TRANSITMAP:
+      return "transitmap";
+  }
+  return "";
+}
+
+// _____________________________________________________________________________
+bool Pipeline::parseStages(const std::string& str, std::vector<Stage>* ret) {
+  const std::vector<Stage> all{TOPO, LOOM, OCTI, TRANSITMAP};
+  size_t next = 0;
+
+  for (const auto& name : util::split(str, ',')) {
+    size_t i = next;
+    while (i < all.size() && getName(all[i]) != util::trim(name)) i++;
+    if (i == all.size()) return false;
+    ret->push_back(all[i]);
+    next = i + 1;
+  }
+
+  return ret->size() > 0;
+}
+
+// _____________________________________________________________________________
+void Pipeline::topo(std::istream* in, LineGraph* g, std::ostream* out) const {
+  LineGraph tg;
+  readGraph(&tg, in, g, 0);
+
+  util::json::Dict stats;
+  try {
+    stats = ::topo::run(&_topoCfg, &tg);
+  } catch (const std::exception& e) {
+    throw StageErr(e.what());
+  }
+
+  if (out) {
+    printGraph(tg, _topoCfg.outFormat, _topoCfg.outputStats, stats, out);
+  } else {
+    *g = std::move(tg);
+  }
+}
+
+// _____________________________________________________________________________
+void Pipeline::loom(std::istream* in, LineGraph* g, std::ostream* out) const {
+  RenderGraph rg(5, 5);
+  readGraph(&rg, in, g, 3);
+
+  util::json::Dict stats;
+  try {
+    stats = ::loom::run(&_loomCfg, &rg);
+  } catch (const std::exception& e) {
+    throw StageErr(e.what());
+  }
+
+  if (out) {
+    printGraph(rg, _loomCfg.outFormat, _loomCfg.outputStats, stats, out);
+  } else {
+    *g = std::move(rg);
+  }
+}
+
+// _____________________________________________________________________________
+void Pipeline::octi(std::istream* in, LineGraph* g, std::ostream* out) const {
+  LineGraph tg;
+  LineGraph res;
+  BaseGraph* gg = 0;
+  readGraph(&tg, in, g, 0);
+
+  util::json::Dict stats;
+  try {
+    stats = ::octi::run(&_octiCfg, &tg, &res, &gg);
+  } catch (const std::exception& e) {
+    delete gg;
+    throw StageErr(e.what());
+  }
+
+  if (_octiCfg.printMode == "gridgraph") {
+    if (!out) {
+      delete gg;
+      throw StageErr("The gridgraph print mode requires octi to be the "
+                     "last stage.");
+    }
+    util::geo::output::GeoGraphJsonOutput jsonOut;
+    if (_octiCfg.writeStats)
+      jsonOut.print(*gg, *out, stats);
+    else
+      jsonOut.print(*gg, *out);
+  } else if (out) {
+    printGraph(res, _octiCfg.outFormat, _octiCfg.writeStats, stats, out);
+  } else {
+    *g = std::move(res);
+  }
+
+  delete gg;
+}
+
+// _____________________________________________________________________________
+void Pipeline::transitmap(std::istream* in, LineGraph* g,
+                          std::ostream* out) const {
+  RenderGraph rg(_transitmapCfg.lineWidth, _transitmapCfg.lineSpacing);
+  readGraph(&rg, in, g, _transitmapCfg.inputSmoothing);
+
+  try {
+    transitmapper::run(&_transitmapCfg, &rg, out);
+  } catch (const std::exception& e) {
+    throw StageErr(e.what());
+  }
+
+  // tiles are not part of the answer
+  if (!_transitmapCfg.tileDir.empty()) {
+    *out << "Wrote tiles to " << _transitmapCfg.tileDir << "\n";
+  }
+}
@@ -0,0 +1,78 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOMSERVER_SERVER_PIPELINE_H_
+#define LOOMSERVER_SERVER_PIPELINE_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "loom/config/LoomConfig.h"
+#include "loomserver/config/ServerConfig.h"
+#include "octi/config/OctiConfig.h"
+#include "shared/linegraph/LineGraph.h"
+#include "topo/config/TopoConfig.h"
+#include "transitmap/config/TransitMapConfig.h"
+
+namespace loomserver {
+namespace server {
+
+enum Stage { TOPO = 0, LOOM = 1, OCTI = 2, TRANSITMAP = 3 };
+
+struct StageErr : public std::exception {
+  StageErr(const std::string& msg) : _msg(msg) {}
+  const char* what() const throw() { return _msg.c_str(); }
+
+ private:
+  std::string _msg;
+};
+
+// Runs the topo | loom | octi | transitmap pipeline inside a single
+// process, with the same code the command line tools run. The line graph is
+// handed from stage to stage in memory, only the input of the first stage
+// is parsed, and only the output of the last stage is written.
+class Pipeline {
+ public:
+  // the stage configurations are read from the stage arguments in cfg
+  explicit Pipeline(const config::Config* cfg);
+
+  // run stages on the line graph in, as the first tool would read it from
+  // stdin. Returns what the last tool would write to stdout. Throws a
+  // StageErr if a stage fails.
+  std::string run(const std::vector<Stage>& stages,
+                  const std::string& in) const;
+
+  // MIME type of the output if stage is the last stage
+  std::string getContentType(Stage stage) const;
+
+  static std::string getName(Stage stage);
+
+  // parse a comma separated list of stage names. The stages must be given in
+  // pipeline order, each at most once. Returns false on invalid input.
+  static bool parseStages(const std::string& str, std::vector<Stage>* ret);
+
+ private:
+  topo::config::TopoConfig _topoCfg;
+  loom::config::Config _loomCfg;
+  octi::config::Config _octiCfg;
+  transitmapper::config::Config _transitmapCfg;
+
+  // each stage reads its input graph from in if given, otherwise it takes
+  // over g. The result is written to out if given, otherwise it is left
+  // in g for the next stage.
+  void topo(std::istream* in, shared::linegraph::LineGraph* g,
+            std::ostream* out) const;
+  void loom(std::istream* in, shared::linegraph::LineGraph* g,
+            std::ostream* out) const;
+  void octi(std::istream* in, shared::linegraph::LineGraph* g,
+            std::ostream* out) const;
+  void transitmap(std::istream* in, shared::linegraph::LineGraph* g,
+                  std::ostream* out) const;
+};
+
+}  // namespace server
+}  // namespace loomserver
+
+#endif  // LOOMSERVER_SERVER_PIPELINE_H_
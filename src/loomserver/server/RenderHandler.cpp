@@ -0,0 +1,140 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "loomserver/server/RenderHandler.h"
+#include "util/Misc.h"
+#include "util/String.h"
+#include "util/log/Log.h"
+
+using loomserver::server::Pipeline;
+using loomserver::server::RenderHandler;
+using loomserver::server::Result;
+using loomserver::server::Stage;
+using loomserver::server::StageErr;
+using util::http::Answer;
+using util::http::Req;
+
+// _____________________________________________________________________________
+RenderHandler::RenderHandler(const Pipeline* pipeline, size_t cacheSize)
+    : _pipeline(pipeline), _cache(cacheSize) {}
+
+// _____________________________________________________________________________
+Answer RenderHandler::handle(const Req& req, int connection) const {
+  UNUSED(connection);
+
+  std::string path = req.url.substr(0, req.url.find('?'));
+  auto params = getParams(req.url);
+
+  if (path != "/render") return Answer("404 Not Found", "Not found.");
+
+  if (req.cmd != "POST") {
+    return Answer("405 Method Not Allowed", "Only POST is supported.");
+  }
+
+  std::string stagesStr = "topo,loom,octi,transitmap";
+  if (params.count("stages")) stagesStr = params["stages"];
+
+  std::vector<Stage> stages;
+  if (!Pipeline::parseStages(stagesStr, &stages)) {
+    return Answer("400 Bad Request", "Invalid stages '" + stagesStr + "'.");
+  }
+
+  if (req.payload.empty()) return Answer("400 Bad Request", "No input graph.");
+
+  try {
+    T_START(render);
+    auto res = render(stages, req.payload);
+    LOG(INFO) << "Rendered " << stagesStr << " in " << T_STOP(render)
+              << " ms";
+
+    Answer answ("200 OK", *res);
+    answ.params["Content-Type"] = _pipeline->getContentType(stages.back());
+    return answ;
+  } catch (const StageErr& e) {
+    return Answer("422 Unprocessable Entity", e.what());
+  } catch (const std::exception& e) {
+    // most likely an invalid input graph
+    return Answer("400 Bad Request", e.what());
+  }
+}
+
+// _____________________________________________________________________________
+Result RenderHandler::render(const std::vector<Stage>& stages,
+                             const std::string& in) const {
+  auto keys = getKeys(in, stages);
+
+  Result res;
+  if (getCached(keys, &res) == stages.size()) return res;
+
+  std::lock_guard<std::mutex> lock(_runMut);
+
+  // another request may have produced results while we were waiting
+  size_t start = getCached(keys, &res);
+
+  if (start == stages.size()) return res;
+
+  // the remaining stages hand the graph over in memory, so only the final
+  // result is available for caching
+  std::vector<Stage> rest(stages.begin() + start, stages.end());
+  res = std::make_shared<const std::string>(
+      _pipeline->run(rest, start ? *res : in));
+  _cache.add(keys.back(), res);
+
+  return res;
+}
+
+// _____________________________________________________________________________
+size_t RenderHandler::getCached(const std::vector<std::string>& keys,
+                                Result* res) const {
+  for (size_t i = keys.size(); i > 0; i--) {
+    auto cached = _cache.get(keys[i - 1]);
+    if (cached) {
+      *res = cached;
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+// _____________________________________________________________________________
+std::vector<std::string> RenderHandler::getKeys(
+    const std::string& in, const std::vector<Stage>& stages) {
+  std::vector<std::string> ret;
+
+  // the input size makes hash collisions even less likely
+  std::string key = std::to_string(in.size()) + ":" +
+                    std::to_string(std::hash<std::string>()(in));
+
+  for (auto stage : stages) {
+    key += "/" + Pipeline::getName(stage);
+    ret.push_back(key);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::unordered_map<std::string, std::string> RenderHandler::getParams(
+    const std::string& url) {
+  std::unordered_map<std::string, std::string> ret;
+
+  size_t pos = url.find('?');
+  if (pos == std::string::npos) return ret;
+
+  for (const auto& kv : util::split(url.substr(pos + 1), '&')) {
+    size_t eq = kv.find('=');
+    if (eq == std::string::npos) {
+      ret[util::urlDecode(kv)] = "";
+    } else {
+      ret[util::urlDecode(kv.substr(0, eq))] =
+          util::urlDecode(kv.substr(eq + 1));
+    }
+  }
+
+  return ret;
+}
@@ -0,0 +1,58 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOMSERVER_SERVER_RENDERHANDLER_H_
+#define LOOMSERVER_SERVER_RENDERHANDLER_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "loomserver/server/Pipeline.h"
+#include "loomserver/server/ResultCache.h"
+#include "util/http/Server.h"
+
+namespace loomserver {
+namespace server {
+
+// Handles POST /render?stages=<stages> requests. The payload is the input
+// line graph, the answer is the output of the last stage.
+//
+// The result of every request is cached under a key derived from the hash of
+// the input and the stages run, so requests whose stages extend those of an
+// earlier request on the same input only run the remaining stages.
+class RenderHandler : public util::http::Handler {
+ public:
+  RenderHandler(const Pipeline* pipeline, size_t cacheSize);
+
+  virtual util::http::Answer handle(const util::http::Req& request,
+                                    int connection) const;
+
+  // cache keys for the results after each of the stages
+  static std::vector<std::string> getKeys(const std::string& in,
+                                          const std::vector<Stage>& stages);
+
+  static std::unordered_map<std::string, std::string> getParams(
+      const std::string& url);
+
+ private:
+  const Pipeline* _pipeline;
+
+  mutable ResultCache _cache;
+
+  // the stages are run one request at a time, they are already parallelized
+  // internally
+  mutable std::mutex _runMut;
+
+  Result render(const std::vector<Stage>& stages, const std::string& in) const;
+
+  // number of stages whose result is cached, the last cached result is
+  // written to res
+  size_t getCached(const std::vector<std::string>& keys, Result* res) const;
+};
+
+}  // namespace server
+}  // namespace loomserver
+
+#endif  // LOOMSERVER_SERVER_RENDERHANDLER_H_
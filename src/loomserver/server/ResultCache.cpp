@@ -0,0 +1,46 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include "loomserver/server/ResultCache.h"
+
+using loomserver::server::Result;
+using loomserver::server::ResultCache;
+
+// _____________________________________________________________________________
+Result ResultCache::get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(_mut);
+
+  auto it = _idx.find(key);
+  if (it == _idx.end()) return Result();
+
+  _lru.splice(_lru.begin(), _lru, it->second);
+  return it->second->second;
+}
+
+// _____________________________________________________________________________
+void ResultCache::add(const std::string& key, Result res) {
+  std::lock_guard<std::mutex> lock(_mut);
+  if (_maxSize == 0) return;
+
+  auto it = _idx.find(key);
+  if (it != _idx.end()) {
+    it->second->second = res;
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return;
+  }
+
+  _lru.push_front({key, res});
+  _idx[key] = _lru.begin();
+
+  while (_lru.size() > _maxSize) {
+    _idx.erase(_lru.back().first);
+    _lru.pop_back();
+  }
+}
+
+// _____________________________________________________________________________
+size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(_mut);
+  return _lru.size();
+}
@@ -0,0 +1,45 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOMSERVER_SERVER_RESULTCACHE_H_
+#define LOOMSERVER_SERVER_RESULTCACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace loomserver {
+namespace server {
+
+typedef std::shared_ptr<const std::string> Result;
+
+// Thread-safe LRU cache of stage results.
+class ResultCache {
+ public:
+  explicit ResultCache(size_t maxSize) : _maxSize(maxSize) {}
+
+  // returns 0 if key is not cached
+  Result get(const std::string& key);
+  void add(const std::string& key, Result res);
+
+  size_t size() const;
+
+ private:
+  size_t _maxSize;
+
+  // most recently used first
+  std::list<std::pair<std::string, Result>> _lru;
+  std::unordered_map<std::string,
+                     std::list<std::pair<std::string, Result>>::iterator>
+      _idx;
+
+  mutable std::mutex _mut;
+};
+
+}  // namespace server
+}  // namespace loomserver
+
+#endif  // LOOMSERVER_SERVER_RESULTCACHE_H_
@@ -0,0 +1,136 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "loomserver/config/ServerConfig.h"
+#include "loomserver/server/Pipeline.h"
+#include "loomserver/server/RenderHandler.h"
+#include "loomserver/server/ResultCache.h"
+#include "util/Misc.h"
+#include "util/String.h"
+
+using loomserver::server::Pipeline;
+using loomserver::server::RenderHandler;
+using loomserver::server::Result;
+using loomserver::server::ResultCache;
+using loomserver::server::Stage;
+
+// a single bent edge, so transitmap draws no inner geometries. Both lines
+// have the same color, loom breaks ties between line orders by address.
+const static std::string GRAPH =
+    "{\"type\":\"FeatureCollection\",\"features\":["
+    "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\","
+    "\"coordinates\":[0,0]},\"properties\":{\"id\":\"A\",\"station_id\":"
+    "\"A\",\"station_label\":\"A\"}},"
+    "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\","
+    "\"coordinates\":[1000,1000]},\"properties\":{\"id\":\"B\","
+    "\"station_id\":\"B\",\"station_label\":\"B\"}},"
+    "{\"type\":\"Feature\",\"geometry\":{\"type\":\"LineString\","
+    "\"coordinates\":[[0,0],[500,200],[1000,1000]]},\"properties\":{"
+    "\"from\":\"A\",\"to\":\"B\",\"lines\":[{\"id\":\"1\","
+    "\"color\":\"ff0000\"},{\"id\":\"2\",\"color\":\"ff0000\"}]}}]}";
+
+// the lines of an SVG, sorted. Stations are drawn in node address order.
+std::vector<std::string> sortedLines(const std::string& svg) {
+  auto ret = util::split(svg, '\n');
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  UNUSED(argc);
+  UNUSED(argv);
+
+  // ___________________________________________________________________________
+  {
+    std::vector<Stage> stages;
+    TEST(Pipeline::parseStages("topo,loom,octi,transitmap", &stages));
+    TEST(stages.size(), ==, (size_t)4);
+
+    stages.clear();
+    TEST(Pipeline::parseStages("loom, transitmap", &stages));
+    TEST(stages.size(), ==, (size_t)2);
+    TEST(stages[0] == loomserver::server::LOOM);
+    TEST(stages[1] == loomserver::server::TRANSITMAP);
+
+    stages.clear();
+    TEST(!Pipeline::parseStages("transitmap,loom", &stages));
+
+    stages.clear();
+    TEST(!Pipeline::parseStages("loom,loom", &stages));
+
+    stages.clear();
+    TEST(!Pipeline::parseStages("loom,blub", &stages));
+
+    stages.clear();
+    TEST(!Pipeline::parseStages("", &stages));
+  }
+
+  // ___________________________________________________________________________
+  {
+    ResultCache cache(2);
+
+    cache.add("a", std::make_shared<const std::string>("A"));
+    cache.add("b", std::make_shared<const std::string>("B"));
+    TEST(cache.size(), ==, (size_t)2);
+
+    // a is now the most recently used
+    TEST(*cache.get("a"), ==, "A");
+
+    cache.add("c", std::make_shared<const std::string>("C"));
+    TEST(cache.size(), ==, (size_t)2);
+    TEST(!cache.get("b"));
+    TEST(*cache.get("a"), ==, "A");
+    TEST(*cache.get("c"), ==, "C");
+
+    ResultCache noCache(0);
+    noCache.add("a", std::make_shared<const std::string>("A"));
+    TEST(!noCache.get("a"));
+  }
+
+  // ___________________________________________________________________________
+  {
+    auto keys = RenderHandler::getKeys(
+        "{}", {loomserver::server::LOOM, loomserver::server::TRANSITMAP});
+    TEST(keys.size(), ==, (size_t)2);
+    TEST(keys[1].find(keys[0]), ==, (size_t)0);
+
+    auto other = RenderHandler::getKeys("{ }", {loomserver::server::LOOM});
+    TEST(other[0] != keys[0]);
+
+    auto params = RenderHandler::getParams("/render?stages=loom%2Ctransitmap&x");
+    TEST(params["stages"], ==, "loom,transitmap");
+    TEST(params.count("x"), ==, (size_t)1);
+    TEST(RenderHandler::getParams("/render").size(), ==, (size_t)0);
+  }
+
+  // ___________________________________________________________________________
+  {
+    loomserver::config::Config cfg;
+    Pipeline pipeline(&cfg);
+
+    // handing the graph over in memory gives the same result as piping the
+    // output of one tool into the next
+    auto loomed = pipeline.run({loomserver::server::LOOM}, GRAPH);
+    auto piped = pipeline.run({loomserver::server::TRANSITMAP}, loomed);
+    auto direct = pipeline.run(
+        {loomserver::server::LOOM, loomserver::server::TRANSITMAP}, GRAPH);
+
+    TEST(direct.find("<polyline"), !=, std::string::npos);
+    TEST(sortedLines(direct) == sortedLines(piped));
+
+    TEST(pipeline.getContentType(loomserver::server::LOOM), ==,
+         "application/json");
+    TEST(pipeline.getContentType(loomserver::server::TRANSITMAP), ==,
+         "image/svg+xml");
+
+    loomserver::config::Config binCfg;
+    binCfg.loomArgs = {"--format", "binary"};
+    TEST(Pipeline(&binCfg).getContentType(loomserver::server::LOOM), ==,
+         "application/octet-stream");
+  }
+}
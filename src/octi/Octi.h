@@ -0,0 +1,36 @@
+// Copyright 2017
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi <brosi@cs.uni-freiburg.de>
+
+#ifndef OCTI_OCTI_H_
+#define OCTI_OCTI_H_
+
+#include <string>
+#include <vector>
+#include "octi/basegraph/BaseGraph.h"
+#include "octi/config/OctiConfig.h"
+#include "shared/linegraph/LineGraph.h"
+#include "util/geo/Geo.h"
+#include "util/json/Writer.h"
+
+namespace octi {
+
+// Schematizes tg into res with the method set in cfg->optMode. Used by the
+// octi tool and by loomserver. tg is planarized and contracted on the way.
+// The base graph the drawing was found on is written to gg and must be
+// deleted by the caller. The returned statistics are only set if
+// cfg->writeStats is set.
+//
+// Throws a NoEmbeddingFoundExc if no drawing was found, and a
+// std::runtime_error on an unknown optimization mode.
+util::json::Dict run(const config::Config* cfg,
+                     shared::linegraph::LineGraph* tg,
+                     shared::linegraph::LineGraph* res,
+                     basegraph::BaseGraph** gg);
+
+// obstacle polygons from a GeoJSON file
+std::vector<util::geo::DPolygon> readObstacleFile(const std::string& p);
+
+}  // namespace octi
+
+#endif  // OCTI_OCTI_H_
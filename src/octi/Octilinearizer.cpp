@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <set>
 #include <thread>
 #include "ilp/ILPGridOptimizer.h"
 #include "octi/Octilinearizer.h"
@@ -23,6 +24,12 @@
 #include "util/graph/BiDijkstra.h"
 #include "util/graph/Dijkstra.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#define omp_get_thread_num() 0
+#endif
 
 using namespace octi;
 using namespace basegraph;
@@ -67,7 +74,8 @@ Score Octilinearizer::drawILP(
     // important: always use restrLocSearch here!
     auto score = draw(cg, box, &tmpOutTg, &gg, &drawing, pensCpy, gridSize,
                       borderRad, maxGrDist, orderMethod, true, enfGeoPen,
-                      hananIters, {}, 100, std::numeric_limits<size_t>::max());
+                      hananIters, {}, 100, std::numeric_limits<size_t>::max(),
+                      0);
     if (score.violations) throw NoEmbeddingFoundExc();
     LOGTO(DEBUG, std::cerr) << "Presolving finished.";
   } catch (const NoEmbeddingFoundExc& exc) {
@@ -124,21 +132,21 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                            OrderMethod orderMethod, bool restrLocSearch,
                            double enfGeoPen, size_t hananIters,
                            const std::vector<Polygon<double>>& obstacles,
-                           size_t locSearchIters, size_t abortAfter) {
-  size_t jobs = 4;
-  std::vector<BaseGraph*> ggs(jobs);
+                           size_t locSearchIters, size_t abortAfter,
+                           size_t threads) {
+  size_t jobs = threads ? threads : omp_get_max_threads();
 
-  LOGTO(DEBUG, std::cerr) << "Creating grid graphs... ";
+  // there is no point in having more jobs than nodes to move around
+  jobs = std::max<size_t>(1, std::min(jobs, cg.getNds().size()));
+
+  LOGTO(DEBUG, std::cerr) << "Creating grid graph... ";
   T_START(ggraph);
-#pragma omp parallel for
-  for (size_t i = 0; i < jobs; i++) {
-    ggs[i] = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
-    ggs[i]->init();
-  }
+  BaseGraph* gg = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
+  gg->init();
 
   LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(ggraph) << "ms)";
 
-  LOGTO(DEBUG, std::cerr) << "Grid graph has " << ggs[0]->getNds().size()
+  LOGTO(DEBUG, std::cerr) << "Grid graph has " << gg->getNds().size()
                           << " nodes";
 
   size_t LOCAL_SEARCH_ITERS = locSearchIters;
@@ -154,7 +162,7 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
     LOGTO(DEBUG, std::cerr) << "Writing geopens... ";
     T_START(geopens);
     for (auto cmbEdg : edges) {
-      ggs[0]->writeGeoCoursePens(cmbEdg, &enfGeoPens, enfGeoPen);
+      gg->writeGeoCoursePens(cmbEdg, &enfGeoPens, enfGeoPen);
     }
     LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(geopens) << "ms)";
     geoPens = &enfGeoPens;
@@ -163,13 +171,16 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   if (obstacles.size()) {
     LOGTO(DEBUG, std::cerr) << "Writing obstacles... ";
     T_START(obstacles);
-    for (auto gg : ggs)
-      for (const auto& obst : obstacles) gg->addObstacle(obst);
+    for (const auto& obst : obstacles) gg->addObstacle(obst);
     LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(obstacles) << "ms)";
   }
 
+  // the jobs share the grid topology, but each works on its own layer of
+  // grid costs and settled / closed states
+  gg->setNumLayers(jobs);
+
   // this is the best drawing
-  Drawing drawing(ggs[0]);
+  Drawing drawing(gg);
 
   // try our default edge ordering first, without any randomization
 
@@ -189,11 +200,12 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
 
   LOGTO(DEBUG, std::cerr) << "Searching initial drawing... ";
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(jobs)
   for (size_t btch = 0; btch < jobs; btch++) {
+    curLayer() = btch;
     for (OrderMethod meth : batches[btch]) {
       T_START(draw);
-      Drawing drawingCp(ggs[btch]);
+      Drawing drawingCp(gg);
 
       // get a randomized ordering
       std::vector<CombEdge*> iterOrder = getOrdering(cg, meth);
@@ -203,10 +215,10 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
 #pragma omp critical
       { bestScoreSoFar = drawing.score(); }
 
-      auto status = draw(iterOrder, ggs[btch], &drawingCp, bestScoreSoFar,
-                         maxGrDist, geoPens, abortAfter);
+      auto status = draw(iterOrder, gg, &drawingCp, bestScoreSoFar, maxGrDist,
+                         geoPens, abortAfter);
 
-      drawingCp.eraseFromGrid(ggs[btch]);
+      drawingCp.eraseFromGrid(gg);
 
       statLine(status, std::string("Try ") + std::to_string(meth), drawingCp,
                T_STOP(draw), "*");
@@ -220,13 +232,18 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
         }
       }
     }
+    curLayer() = 0;
   }
 
   if (drawing.score() == INF) throw NoEmbeddingFoundExc();
 
   LOGTO(DEBUG, std::cerr) << "Done.";
 
-  for (size_t i = 0; i < jobs; i++) drawing.applyToGrid(ggs[i]);
+  for (size_t i = 0; i < jobs; i++) {
+    curLayer() = i;
+    drawing.applyToGrid(gg);
+  }
+  curLayer() = 0;
 
   size_t iters = 0;
 
@@ -237,100 +254,94 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   // dont use local search if abortAfter is set
   if (abortAfter != std::numeric_limits<size_t>::max()) LOCAL_SEARCH_ITERS = 0;
 
-  std::vector<std::vector<CombNode*>> batchesLoc(jobs);
-  size_t c = 0;
+  std::vector<CombNode*> locNds;
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    batchesLoc[c % jobs].push_back(nd);
-    c++;
+    locNds.push_back(nd);
   }
 
   for (; iters < LOCAL_SEARCH_ITERS; iters++) {
     T_START(iter);
-    std::vector<Drawing> bestFrIters(jobs);
-
-#pragma omp parallel for
-    for (size_t btch = 0; btch < jobs; btch++) {
-      for (auto a : batchesLoc[btch]) {
-        Drawing drawingCp = drawing;
-
-        // use the batches grid graph
-        drawingCp.setBaseGraph(ggs[btch]);
-
-        // reverting a
-        std::vector<CombEdge*> test;
-        for (auto ce : a->getAdjList()) {
-          test.push_back(ce);
-
-          drawingCp.eraseFromGrid(ce, ggs[btch]);
-          drawingCp.erase(ce);
-        }
-
-        drawingCp.erase(a);
-        ggs[btch]->unSettleNd(a);
-
-        for (size_t pos = 0; pos < ggs[btch]->maxDeg() + 1; pos++) {
-          SettledPos p;
+    std::vector<NdMove> moves(locNds.size());
+
+#pragma omp parallel num_threads(jobs)
+    {
+      // each thread works on its own copy of the drawing and on its own layer
+      // of the grid graph. Moves are undone after they were evaluated, so the
+      // result for a node does not depend on the thread evaluating it
+      curLayer() = omp_get_thread_num();
+      Drawing work = drawing;
+
+#pragma omp for schedule(dynamic, 1)
+      for (size_t i = 0; i < locNds.size(); i++) {
+        moves[i] = bestMove(locNds[i], gg, &work, maxGrDist, restrLocSearch,
+                            geoPens);
+      }
 
-          auto n = ggs[btch]->neigh(drawing.getGrNd(a), pos);
-          if (!n) continue;
+      curLayer() = 0;
+    }
 
-          p[a] = n;
+    // apply the improving moves, best first. Moves which touch the
+    // neighborhood of an already applied move are skipped, as they were
+    // evaluated against an outdated drawing
+    std::vector<size_t> order;
+    for (size_t i = 0; i < moves.size(); i++) {
+      if (moves[i].pos) order.push_back(i);
+    }
 
-          if (restrLocSearch) {
-            // dont try positions outside the move radius for consistency with
-            // ILP approach
-            double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
-            double maxDis = ggs[btch]->getCellSize() * maxGrDist;
-            if (gridD >= maxDis) continue;
-          }
+    std::stable_sort(order.begin(), order.end(), [&moves](size_t a, size_t b) {
+      return moves[a].score < moves[b].score;
+    });
 
-          Drawing run = drawingCp;
+    Drawing prev = drawing;
+    std::set<const CombNode*> touched;
+    size_t applied = 0;
 
-          // we can use bestFromIter.score() as the limit for the shortest
-          // path computation, as we can already do at least as good.
-          auto error =
-              draw(test, p, ggs[btch], &run, bestFrIters[btch].score(),
-                   maxGrDist, geoPens, std::numeric_limits<size_t>::max());
+    for (size_t i : order) {
+      auto a = moves[i].nd;
 
-          if (!error && bestFrIters[btch].score() > run.score()) {
-            bestFrIters[btch] = run;
-          }
+      bool conflict = touched.count(a);
+      for (auto ce : a->getAdjList()) {
+        conflict |= touched.count(ce->getOtherNd(a));
+      }
+      if (conflict) continue;
 
-          // reset grid
-          for (auto ce : a->getAdjList()) run.eraseFromGrid(ce, ggs[btch]);
-          if (ggs[btch]->isSettled(a)) ggs[btch]->unSettleNd(a);
-        }
+      // the move was evaluated against the previous drawing, re-route it on
+      // the current one and keep it only if it still improves
+      double before = drawing.score();
+      auto grNd = drawing.getGrNd(a);
+      auto undo = drawing.getState(a);
 
-        ggs[btch]->settleNd(const_cast<GridNode*>(ggs[btch]->getGrNdById(
-                                drawing.getGrNd(a)->pl().getId())),
-                            a);
+      auto status = reroute(a, moves[i].pos, gg, &drawing, before, maxGrDist,
+                            geoPens);
 
-        // re-settle edges
-        for (auto ce : a->getAdjList()) drawing.applyToGrid(ce, ggs[btch]);
+      if (status != DRAWN || drawing.score() >= before) {
+        restore(a, grNd, undo, gg, &drawing);
+        continue;
       }
-    }
 
-    size_t bestCore;
-    double bestScore = std::numeric_limits<double>::infinity();
-    for (size_t i = 0; i < jobs; i++) {
-      if (bestFrIters[i].score() < bestScore) {
-        bestScore = bestFrIters[i].score();
-        bestCore = i;
-      }
+      applied++;
+      touched.insert(a);
+      for (auto ce : a->getAdjList()) touched.insert(ce->getOtherNd(a));
     }
 
-    double imp = (drawing.score() - bestFrIters[bestCore].score());
+    double imp = prev.score() - drawing.score();
     LOGTO(DEBUG, std::cerr)
-        << " ++ Iter " << iters << ", prev " << drawing.score() << ", next "
-        << bestFrIters[bestCore].score() << " (" << (imp >= 0 ? "+" : "") << imp
-        << ", " << T_STOP(iter) << " ms)";
+        << " ++ Iter " << iters << ", prev " << prev.score() << ", next "
+        << drawing.score() << " (" << (imp >= 0 ? "+" : "") << imp << ", "
+        << applied << " moves, " << T_STOP(iter) << " ms)";
 
+    // bring all layers to the new drawing
     for (size_t i = 0; i < jobs; i++) {
-      drawing.eraseFromGrid(ggs[i]);
-      bestFrIters[bestCore].applyToGrid(ggs[i]);
+      curLayer() = i;
+      if (i == 0) {
+        drawing.eraseFromGrid(gg);
+      } else {
+        prev.eraseFromGrid(gg);
+      }
+      drawing.applyToGrid(gg);
     }
-    drawing = bestFrIters[bestCore];
+    curLayer() = 0;
 
     if (imp < CONVERGENCE_THRESHOLD) break;
   }
@@ -343,16 +354,94 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                           << ", mv costs: " << fullScore.move
                           << ", dense costs: " << fullScore.dense;
 
-  *retGg = ggs[0];
+  // all layers hold the same state now, drop the additional ones
+  gg->setNumLayers(1);
+
+  *retGg = gg;
   *dOut = drawing;
 
   // the drawing might still have another internal grid graph, make sure they
   // match (this is important for drawILP)
-  dOut->setBaseGraph(ggs[0]);
+  dOut->setBaseGraph(gg);
   fullScore.iters = iters;
   return fullScore;
 }
 
+// _____________________________________________________________________________
+NdMove Octilinearizer::bestMove(CombNode* a, BaseGraph* gg, Drawing* drawing,
+                                double maxGrDist, bool restrLocSearch,
+                                const GeoPensMap* geoPens) {
+  // the best move has to improve the current drawing
+  NdMove best{a, 0, drawing->score()};
+
+  auto grNd = drawing->getGrNd(a);
+  auto undo = drawing->getState(a);
+
+  for (size_t pos = 0; pos < gg->maxDeg() + 1; pos++) {
+    auto n = gg->neigh(grNd, pos);
+    if (!n) continue;
+
+    if (restrLocSearch) {
+      // dont try positions outside the move radius for consistency with
+      // ILP approach
+      double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
+      double maxDis = gg->getCellSize() * maxGrDist;
+      if (gridD >= maxDis) continue;
+    }
+
+    // we can use the best score as the limit for the shortest path
+    // computation, as we can already do at least as good.
+    auto status = reroute(a, n, gg, drawing, best.score, maxGrDist, geoPens);
+
+    if (status == DRAWN && drawing->score() < best.score) {
+      best.pos = n;
+      best.score = drawing->score();
+    }
+
+    restore(a, grNd, undo, gg, drawing);
+  }
+
+  return best;
+}
+
+// _____________________________________________________________________________
+Undrawable Octilinearizer::reroute(CombNode* a, const GridNode* n,
+                                   BaseGraph* gg, Drawing* drawing,
+                                   double cutoff, double maxGrDist,
+                                   const GeoPensMap* geoPens) {
+  std::vector<CombEdge*> test;
+  for (auto ce : a->getAdjList()) {
+    test.push_back(ce);
+
+    drawing->eraseFromGrid(ce, gg);
+    drawing->erase(ce);
+  }
+
+  drawing->erase(a);
+  gg->unSettleNd(a);
+
+  SettledPos p;
+  p[a] = n;
+
+  return draw(test, p, gg, drawing, cutoff, maxGrDist, geoPens,
+              std::numeric_limits<size_t>::max());
+}
+
+// _____________________________________________________________________________
+void Octilinearizer::restore(CombNode* a, const GridNode* grNd,
+                             const combgraph::DrawingState& undo,
+                             BaseGraph* gg, Drawing* drawing) {
+  // reset grid
+  for (auto ce : a->getAdjList()) drawing->eraseFromGrid(ce, gg);
+  if (gg->isSettled(a)) gg->unSettleNd(a);
+
+  drawing->setState(undo);
+
+  // re-settle node and edges
+  gg->settleNd(const_cast<GridNode*>(grNd), a);
+  for (auto ce : a->getAdjList()) drawing->applyToGrid(ce, gg);
+}
+
 // _____________________________________________________________________________
 void Octilinearizer::settleRes(GridNode* frGrNd, GridNode* toGrNd,
                                BaseGraph* gg, CombNode* from, CombNode* to,
@@ -480,15 +569,22 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
 
     auto heur = gg->getHeur(toGrNds);
 
+    // the search state is re-used for all routings of a thread
+    thread_local GridDijkstra dijkstra;
+
+    // the node heuristic is hidden in Dijkstra::HeurFunc, call it via the base
+    const util::graph::HeurFunc<GridNodePL, GridEdgePL, float>& heurFunc =
+        *heur;
+
     if (geoPensMap) {
       // init cost function with geo distance penalties
       auto cost = GridCostGeoPen(cutoff + costOffsetTo + costOffsetFrom,
                                  &geoPensMap->find(cmbEdg)->second);
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      dijkstra.shortestPath(frGrNds, toGrNds, cost, heurFunc, &eL, &nL);
     } else {
       auto cost = GridCost(cutoff + costOffsetTo + costOffsetFrom);
 
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      dijkstra.shortestPath(frGrNds, toGrNds, cost, heurFunc, &eL, &nL);
     }
 
     delete heur;
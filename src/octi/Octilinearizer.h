@@ -15,6 +15,7 @@
 #include "octi/config/OctiConfig.h"
 #include "shared/linegraph/LineGraph.h"
 #include "util/graph/BiDijkstra.h"
+#include "util/graph/DenseDijkstra.h"
 #include "util/graph/Dijkstra.h"
 
 namespace octi {
@@ -50,6 +51,13 @@ typedef std::map<CombNode*, const GridNode*> SettledPos;
 
 enum Undrawable { DRAWN = 0, NO_PATH = 1, NO_CANDS = 2 };
 
+// a node move in the local search, pos is 0 if no improving move was found
+struct NdMove {
+  CombNode* nd;
+  const GridNode* pos;
+  double score;
+};
+
 // exception thrown when no planar embedding could be found
 struct NoEmbeddingFoundExc : public std::exception {
   const char* what() const throw() {
@@ -129,7 +137,10 @@ struct GraphMeasures {
   size_t maxDeg;
 };
 
-struct GridCost
+typedef util::graph::DenseDijkstra<GridNodePL, GridEdgePL, float> GridDijkstra;
+
+// final, so the calls from GridDijkstra are not virtual
+struct GridCost final
     : public util::graph::Dijkstra::CostFunc<GridNodePL, GridEdgePL, float> {
   GridCost(float inf) : _inf(inf) {}
   virtual float operator()(const GridNode* from, const GridEdge* e,
@@ -144,7 +155,7 @@ struct GridCost
   virtual float inf() const { return _inf; }
 };
 
-struct GridCostGeoPen
+struct GridCostGeoPen final
     : public Dijkstra::CostFunc<GridNodePL, GridEdgePL, float> {
   GridCostGeoPen(float inf, const GeoPens* geoPens)
       : _inf(inf), _geoPens(geoPens) {}
@@ -152,7 +163,9 @@ struct GridCostGeoPen
                            const GridNode* to) const {
     UNUSED(from);
     UNUSED(to);
-    return e->pl().cost() + (*_geoPens)[e->pl().getId()];
+    // geo course penalties only apply to hop edges
+    if (e->pl().isSecondary()) return e->pl().cost();
+    return e->pl().cost() + _geoPens->get(e->pl().getId());
   }
 
   float _inf;
@@ -172,7 +185,7 @@ class Octilinearizer {
              config::OrderMethod orderMethod, bool restrLocSearch,
              double enfGeoCourse, size_t hananIters,
              const std::vector<util::geo::Polygon<double>>& obstacles,
-             size_t locsearchIters, size_t abortAfter);
+             size_t locsearchIters, size_t abortAfter, size_t threads);
 
   Score drawILP(const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
                 basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
@@ -218,6 +231,16 @@ class Octilinearizer {
   SettledPos neigh(const SettledPos& pos, const std::vector<CombNode*>&,
                    size_t i) const;
 
+  NdMove bestMove(CombNode* a, basegraph::BaseGraph* gg, Drawing* drawing,
+                  double maxGrDist, bool restrLocSearch,
+                  const GeoPensMap* geoPens);
+  Undrawable reroute(CombNode* a, const GridNode* n, basegraph::BaseGraph* gg,
+                     Drawing* drawing, double cutoff, double maxGrDist,
+                     const GeoPensMap* geoPens);
+  void restore(CombNode* a, const GridNode* grNd,
+               const combgraph::DrawingState& undo, basegraph::BaseGraph* gg,
+               Drawing* drawing);
+
   RtPair getRtPair(CombNode* frCmbNd, CombNode* toCmbNd,
                    const SettledPos& settled, basegraph::BaseGraph* gg,
                    double maxGrDist);
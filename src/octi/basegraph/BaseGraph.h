@@ -32,6 +32,10 @@ const static double INF = std::numeric_limits<double>::infinity();
 
 const static double SOFT_INF = 100000;
 
+// radius, in grid cells, of the corridor around the original geometry of a
+// comb edge in which geographic course penalties are stored, see GeoPens
+const static double GEO_PEN_CORRIDOR = 8;
+
 enum BaseGraphType {
   HEXGRID,
   OCTIGRID,
@@ -49,7 +53,29 @@ typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
 typedef std::pair<const GridEdge*, const GridEdge*> EdgPair;
 typedef std::vector<std::pair<EdgPair, EdgPair>> CrossEdgPairs;
 
-typedef std::vector<double> GeoPens;
+// Geographic course penalties of the grid hop edges for a single comb edge.
+// Only penalties inside a corridor around the comb edge's original geometry
+// are stored, all other hop edges get the capped default penalty.
+class GeoPens {
+ public:
+  GeoPens() : _def(0) {}
+  explicit GeoPens(double def) : _def(def) {}
+
+  double get(size_t edgId) const {
+    auto i = _pens.find(edgId);
+    if (i == _pens.end()) return _def;
+    return i->second;
+  }
+
+  void set(size_t edgId, double pen) { _pens[edgId] = pen; }
+
+  size_t size() const { return _pens.size(); }
+
+ private:
+  std::unordered_map<size_t, double> _pens;
+  double _def;
+};
+
 typedef std::map<const CombEdge*, GeoPens> GeoPensMap;
 
 struct Candidate {
@@ -95,6 +121,10 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   virtual std::priority_queue<Candidate> getGridNdCands(
       const util::geo::DPoint& p, size_t maxGrD) const = 0;
 
+  // all sink nodes with a distance < maxD to p, regardless of their state
+  virtual std::set<GridNode*> getSinkNds(const util::geo::DPoint& p,
+                                         double maxD) const = 0;
+
   virtual void addCostVec(GridNode* n, const NodeCost& addC) = 0;
 
   virtual void openSinkTo(GridNode* n, double cost) = 0;
@@ -125,6 +155,9 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   virtual GridEdge* getNEdg(const GridNode* a, const GridNode* b) const = 0;
   virtual void reset() = 0;
 
+  // set the number of state layers, all layers start as a copy of layer 0
+  virtual void setNumLayers(size_t n) = 0;
+
   virtual GridNode* getSettled(const CombNode* cnd) const = 0;
   virtual bool unused(const GridNode* gnd) const = 0;
 
@@ -42,9 +42,7 @@ void ConvexHullOctiGridGraph::init() {
         GridNode* toN = neigh(x, y, p);
         if (frN && toN) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
-          auto e = addEdg(frN, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(frN, to, 9, false, false);
         }
       }
     }
@@ -95,13 +93,8 @@ GridNode* ConvexHullOctiGridGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, true);
+    addGrEdg(nn, n, INF, true, true);
   }
 
   // in-node connections
@@ -115,15 +108,8 @@ GridNode* ConvexHullOctiGridGraph::writeNd(size_t x, size_t y) {
       if (y == _grid.getYHeight() - 1 && (i == 3 || i == 4 || i == 5))
         pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
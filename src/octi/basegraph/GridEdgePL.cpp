@@ -11,27 +11,20 @@ using util::geo::PolyLine;
 using namespace octi::basegraph;
 
 // _____________________________________________________________________________
-GridEdgePL::GridEdgePL(double c, bool secondary, bool sink)
-    : _c(c),
-      _isSecondary(secondary),
-      _isSink(sink),
-      _closed(false),
-      _softClosed(false),
-      _blocked(false),
-      _resEdgs(0), _rndrOrder(0) {}
+GridEdgePL::GridEdgePL(GridEdgeStates* sts, size_t id, bool secondary,
+                       bool sink)
+    : _sts(sts), _id(id), _isSecondary(secondary), _isSink(sink) {}
 
 // _____________________________________________________________________________
 const util::geo::Line<double>* GridEdgePL::getGeom() const { return 0; }
 
 // _____________________________________________________________________________
-size_t GridEdgePL::resEdgs() const {
-  return _resEdgs;
-}
+size_t GridEdgePL::resEdgs() const { return _sts->resEdgs[i()]; }
 
 // _____________________________________________________________________________
 void GridEdgePL::reset() {
-  _closed = false;
-  _resEdgs = 0;
+  flags() &= ~GridEdgeStates::CLOSED;
+  _sts->resEdgs[i()] = 0;
 }
 
 // _____________________________________________________________________________
@@ -40,64 +33,72 @@ util::json::Dict GridEdgePL::getAttrs() const {
   obj["cost"] = cost() == std::numeric_limits<double>::infinity()
                     ? "inf"
                     : util::toString(cost());
-  obj["res_edges"] = util::toString((int)_resEdgs);
-  obj["rndr_order"] = util::toString((int)_rndrOrder);
+  obj["res_edges"] = util::toString((int)resEdgs());
+  obj["rndr_order"] = util::toString((int)_sts->rndrOrder[i()]);
   obj["secondary"] = util::toString((int)_isSecondary);
   obj["sink"] = util::toString((int)_isSink);
-  obj["closed"] = util::toString(_closed);
-  obj["blocked"] = util::toString(_blocked);
-  obj["softclosed"] = util::toString(_softClosed);
+  obj["closed"] = util::toString(closed());
+  obj["blocked"] = util::toString((flags() & GridEdgeStates::BLOCKED) != 0);
+  obj["softclosed"] =
+      util::toString((flags() & GridEdgeStates::SOFT_CLOSED) != 0);
   return obj;
 }
 // _____________________________________________________________________________
 double GridEdgePL::cost() const {
   // testing relaxed constraints for diagonal intersections
-  if (_softClosed || _blocked) return SOFT_INF + rawCost();
-  if (_closed) return INF;
+  uint8_t f = flags();
+  if (f & (GridEdgeStates::SOFT_CLOSED | GridEdgeStates::BLOCKED))
+    return SOFT_INF + rawCost();
+  if (f & GridEdgeStates::CLOSED) return INF;
 
   return rawCost();
 }
 
 // _____________________________________________________________________________
-double GridEdgePL::rawCost() const { return _c; }
+double GridEdgePL::rawCost() const { return _sts->c[i()]; }
 
 // _____________________________________________________________________________
-void GridEdgePL::addResEdge() { _resEdgs++; }
+void GridEdgePL::addResEdge() { _sts->resEdgs[i()]++; }
 
 // _____________________________________________________________________________
-void GridEdgePL::close() { _closed = true; _softClosed = false;}
+void GridEdgePL::close() {
+  flags() |= GridEdgeStates::CLOSED;
+  flags() &= ~GridEdgeStates::SOFT_CLOSED;
+}
 
 // _____________________________________________________________________________
-void GridEdgePL::softClose() { if (!_closed) _softClosed = true; _closed = true;}
+void GridEdgePL::softClose() {
+  if (!closed()) flags() |= GridEdgeStates::SOFT_CLOSED;
+  flags() |= GridEdgeStates::CLOSED;
+}
 
 // _____________________________________________________________________________
-bool GridEdgePL::closed() const { return _closed; }
+bool GridEdgePL::closed() const { return flags() & GridEdgeStates::CLOSED; }
 
 // _____________________________________________________________________________
-void GridEdgePL::open() { _closed = false; _softClosed = false;}
+void GridEdgePL::open() {
+  flags() &= ~(GridEdgeStates::CLOSED | GridEdgeStates::SOFT_CLOSED);
+}
 
 // _____________________________________________________________________________
-void GridEdgePL::block() { _blocked = true; }
+void GridEdgePL::block() { flags() |= GridEdgeStates::BLOCKED; }
 
 // _____________________________________________________________________________
-void GridEdgePL::unblock() { _blocked = false; }
+void GridEdgePL::unblock() { flags() &= ~GridEdgeStates::BLOCKED; }
 
 // _____________________________________________________________________________
-void GridEdgePL::setCost(double c) { _c = c; }
+void GridEdgePL::setCost(double c) { _sts->c[i()] = c; }
 
 // _____________________________________________________________________________
 bool GridEdgePL::isSecondary() const { return _isSecondary; }
 
 // _____________________________________________________________________________
-void GridEdgePL::delResEdg() { if (_resEdgs > 0) _resEdgs--; }
-
-// _____________________________________________________________________________
-void GridEdgePL::setId(size_t id) { _id = id; }
+void GridEdgePL::delResEdg() {
+  if (_sts->resEdgs[i()] > 0) _sts->resEdgs[i()]--;
+}
 
 // _____________________________________________________________________________
 size_t GridEdgePL::getId() const { return _id; }
 
 // _____________________________________________________________________________
-void GridEdgePL::setRndrOrder(size_t order) {
-  _rndrOrder = order;
-}
+void GridEdgePL::setRndrOrder(size_t order) { _sts->rndrOrder[i()] = order; }
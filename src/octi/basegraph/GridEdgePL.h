@@ -4,7 +4,9 @@
 #ifndef OCTI_BASEGRAPH_GRIDEDGEPL_H_
 #define OCTI_BASEGRAPH_GRIDEDGEPL_H_
 
+#include <cstdint>
 #include <set>
+#include <vector>
 #include "octi/combgraph/CombEdgePL.h"
 #include "octi/combgraph/CombNodePL.h"
 #include "util/geo/GeoGraph.h"
@@ -16,9 +18,63 @@ using util::geo::PolyLine;
 namespace octi {
 namespace basegraph {
 
+// The mutable state of grid nodes and edges (costs, closed and settled flags)
+// may exist in several layers over a single grid topology, so that multiple
+// threads can route on the same grid graph. Each thread works on its current
+// layer, see BaseGraph::setNumLayers().
+inline size_t& curLayer() {
+  static thread_local size_t layer = 0;
+  return layer;
+}
+
+// Mutable edge states of a grid graph, stored as a struct of arrays indexed
+// by the edge id. The states of layer i are at offset i * size().
+struct GridEdgeStates {
+  static const uint8_t CLOSED = 1;
+  static const uint8_t SOFT_CLOSED = 2;
+  // edges are blocked if they would cross a settled edge
+  static const uint8_t BLOCKED = 4;
+
+  GridEdgeStates() : num(0) {}
+
+  // add an edge state to layer 0, returns its id
+  size_t add(double cost) {
+    c.push_back(cost);
+    flags.push_back(0);
+    resEdgs.push_back(0);
+    rndrOrder.push_back(0);
+    return num++;
+  }
+
+  size_t size() const { return num; }
+
+  // initialize layers 1 to n - 1 with the state of layer 0
+  void setNumLayers(size_t n) {
+    c.resize(num);
+    flags.resize(num);
+    resEdgs.resize(num);
+    rndrOrder.resize(num);
+    for (size_t i = 1; i < n; i++) {
+      c.insert(c.end(), c.begin(), c.begin() + num);
+      flags.insert(flags.end(), flags.begin(), flags.begin() + num);
+      resEdgs.insert(resEdgs.end(), resEdgs.begin(), resEdgs.begin() + num);
+      rndrOrder.insert(rndrOrder.end(), rndrOrder.begin(),
+                       rndrOrder.begin() + num);
+    }
+  }
+
+  std::vector<double> c;
+  std::vector<uint8_t> flags;
+  std::vector<uint8_t> resEdgs;
+  std::vector<uint32_t> rndrOrder;
+
+  size_t num;
+};
+
 class GridEdgePL : util::geograph::GeoEdgePL<double> {
  public:
-  GridEdgePL(double c, bool secondar, bool sink);
+  // the state of the edge is stored at id in sts
+  GridEdgePL(GridEdgeStates* sts, size_t id, bool secondar, bool sink);
 
   const util::geo::Line<double>* getGeom() const;
   util::json::Dict getAttrs() const;
@@ -43,26 +99,20 @@ class GridEdgePL : util::geograph::GeoEdgePL<double> {
   void delResEdg();
   void addResEdge();
 
-  void setId(size_t id);
   size_t getId() const;
 
   void setRndrOrder(size_t order);
 
  private:
-  double _c;
+  GridEdgeStates* _sts;
+  uint32_t _id;
 
   bool _isSecondary;
   bool _isSink;
 
-  bool _closed;
-  bool _softClosed;
-
-  // edges are blocked if they would cross a settled edge
-  bool _blocked;
-
-  uint8_t _resEdgs;
-  size_t _rndrOrder;
-  size_t _id;
+  size_t i() const { return curLayer() * _sts->num + _id; }
+  uint8_t& flags() { return _sts->flags[i()]; }
+  uint8_t flags() const { return _sts->flags[i()]; }
 };
 }
 }
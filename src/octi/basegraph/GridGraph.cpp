@@ -33,7 +33,8 @@ GridGraph::GridGraph(const DBox& bbox, double cellSize, double spacer,
       _grid(cellSize, cellSize, bbox, false),
       _cellSize(cellSize),
       _spacer(spacer),
-      _edgeCount(0) {
+      _settled(1),
+      _resEdgs(1) {
   assert(_c.p_0 <= _c.p_135);
   assert(_c.p_135 <= _c.p_90);
   assert(_c.p_90 <= _c.p_45);
@@ -66,9 +67,7 @@ void GridGraph::init() {
         GridNode* toN = neigh(x, y, p);
         if (frN && toN) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
-          auto e = addEdg(frN, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(frN, to, 9, false, false);
         }
       }
     }
@@ -116,9 +115,9 @@ GridNode* GridGraph::neigh(const GridNode* n, size_t i) const {
 
 // _____________________________________________________________________________
 void GridGraph::unSettleNd(CombNode* a) {
-  openTurns(_settled[a]);
-  _settled[a]->pl().setSettled(false);
-  _settled.erase(a);
+  openTurns(settled()[a]);
+  settled()[a]->pl().setSettled(false);
+  settled().erase(a);
 }
 
 // _____________________________________________________________________________
@@ -135,10 +134,10 @@ void GridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  resEdgs()[ge].erase(ce);
+  resEdgs()[gf].erase(ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (resEdgs()[ge].size() == 0) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
@@ -180,34 +179,39 @@ void GridGraph::writeObstacleCost(const util::geo::Polygon<double>& obst) {
 // _____________________________________________________________________________
 void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
                                    double pen) {
-  (*target)[ce].resize(_edgeCount);
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      auto grNdA = getNode(x, y);
-
-      for (size_t i = 0; i < maxDeg(); i++) {
-        auto grNeigh = neigh(x, y, i);
-        if (!grNeigh) continue;
-        auto ge = getNEdg(grNdA, grNeigh);
-
-        double d = std::numeric_limits<double>::infinity();
-
-        for (auto orE : ce->pl().getChilds()) {
-          double dLoc = fmax(fmax(
-              dist(*orE->pl().getGeom(), *ge->getFrom()->pl().getGeom()) /
-              getCellSize(),
-              dist(*orE->pl().getGeom(), util::geo::centroid(util::geo::MultiPoint<double>{*ge->getFrom()->pl().getGeom(), *ge->getFrom()->pl().getGeom()})) /
-              getCellSize()),
-              dist(*orE->pl().getGeom(), *ge->getTo()->pl().getGeom()) /
-              getCellSize());
-
-          if (dLoc < d) d = dLoc;
-        }
+  // beyond the corridor, the penalty is capped at that of the corridor border
+  auto& pens = (*target)[ce];
+  pens = GeoPens(pen * GEO_PEN_CORRIDOR * GEO_PEN_CORRIDOR);
+
+  // candidate grid nodes within the corridor around any child geometry,
+  // padded by one cell because the grid index is cell-based
+  std::set<GridNode*> nds;
+  for (auto orE : ce->pl().getChilds()) {
+    _grid.get(util::geo::pad(util::geo::getBoundingBox(*orE->pl().getGeom()),
+                             (GEO_PEN_CORRIDOR + 1) * getCellSize()),
+              &nds);
+  }
+
+  for (auto grNdA : nds) {
+    for (size_t i = 0; i < maxDeg(); i++) {
+      auto grNeigh = neigh(grNdA, i);
+      if (!grNeigh) continue;
+      auto ge = getNEdg(grNdA, grNeigh);
+      if (!ge) continue;
+
+      double d = std::numeric_limits<double>::infinity();
+
+      for (auto orE : ce->pl().getChilds()) {
+        double dLoc = fmax(
+            dist(*orE->pl().getGeom(), *ge->getFrom()->pl().getGeom()),
+            dist(*orE->pl().getGeom(), *ge->getTo()->pl().getGeom()));
+
+        if (dLoc < d) d = dLoc;
+      }
 
-        d *= pen * d;
+      d /= getCellSize();
 
-        (*target)[ce][ge->pl().getId()] = d;
-      }
+      if (d < GEO_PEN_CORRIDOR) pens.set(ge->pl().getId(), pen * d * d);
     }
   }
 }
@@ -241,16 +245,16 @@ bool GridGraph::unused(const GridNode* gnd) const {
     if (!neighbor) continue;
     auto e = getNEdg(gnd, neighbor);
     auto f = getNEdg(neighbor, gnd);
-    auto a = _resEdgs.find(const_cast<GridEdge*>(e));
+    auto a = resEdgs().find(const_cast<GridEdge*>(e));
 
 
-    if (a != _resEdgs.end()) {
+    if (a != resEdgs().end()) {
       assert(a->second.size() == e->pl().resEdgs());
     }
-    if (a != _resEdgs.end() && a->second.size() != 0) return false;
-    a = _resEdgs.find(const_cast<GridEdge*>(f));
-    if (a != _resEdgs.end()) assert(a->second.size() == f->pl().resEdgs());
-    if (a != _resEdgs.end() && a->second.size() != 0) return false;
+    if (a != resEdgs().end() && a->second.size() != 0) return false;
+    a = resEdgs().find(const_cast<GridEdge*>(f));
+    if (a != resEdgs().end()) assert(a->second.size() == f->pl().resEdgs());
+    if (a != resEdgs().end() && a->second.size() != 0) return false;
   }
   return true;
 }
@@ -258,15 +262,15 @@ bool GridGraph::unused(const GridNode* gnd) const {
 // _____________________________________________________________________________
 void GridGraph::addResEdg(GridEdge* ge, CombEdge* ce) {
   ge->pl().addResEdge();
-  _resEdgs[ge].insert(ce);
-  assert(_resEdgs[ge].size() == ge->pl().resEdgs());
+  resEdgs()[ge].insert(ce);
+  assert(resEdgs()[ge].size() == ge->pl().resEdgs());
 }
 
 // _____________________________________________________________________________
 std::set<CombEdge*> GridGraph::getResEdgs(const GridEdge* ge) const {
   if (!ge) return {};
-  if (_resEdgs.count(const_cast<GridEdge*>(ge)))
-    return _resEdgs.find(const_cast<GridEdge*>(ge))->second;
+  if (resEdgs().count(const_cast<GridEdge*>(ge)))
+    return resEdgs().find(const_cast<GridEdge*>(ge))->second;
   return {};
 }
 
@@ -275,12 +279,12 @@ std::set<CombEdge*> GridGraph::getResEdgsDirInd(const GridEdge* ge) const {
   std::set<CombEdge*> ret;
   if (!ge) return {};
   auto otherEdge = getEdg(ge->getTo(), ge->getFrom());
-  if (_resEdgs.count(const_cast<GridEdge*>(ge))) {
-    const auto& tmp = _resEdgs.find(const_cast<GridEdge*>(ge))->second;
+  if (resEdgs().count(const_cast<GridEdge*>(ge))) {
+    const auto& tmp = resEdgs().find(const_cast<GridEdge*>(ge))->second;
     ret.insert(tmp.begin(), tmp.end());
   }
-  if (otherEdge && _resEdgs.count(const_cast<GridEdge*>(otherEdge))) {
-    const auto& tmp = _resEdgs.find(const_cast<GridEdge*>(otherEdge))->second;
+  if (otherEdge && resEdgs().count(const_cast<GridEdge*>(otherEdge))) {
+    const auto& tmp = resEdgs().find(const_cast<GridEdge*>(otherEdge))->second;
     ret.insert(tmp.begin(), tmp.end());
   }
   return ret;
@@ -521,20 +525,27 @@ void GridGraph::writeInitialCosts() {
 std::priority_queue<Candidate> GridGraph::getGridNdCands(const DPoint& p,
                                                          size_t maxGrD) const {
   std::priority_queue<Candidate> ret;
-  std::set<GridNode*> neigh;
 
-  double maxD = getCellSize() * maxGrD;
+  for (auto n : getSinkNds(p, getCellSize() * maxGrD)) {
+    if (n->pl().isClosed() || n->pl().isSettled()) continue;
+    ret.push(Candidate(n, dist(*n->pl().getGeom(), p)));
+  }
+
+  return ret;
+}
 
+// _____________________________________________________________________________
+std::set<GridNode*> GridGraph::getSinkNds(const DPoint& p, double maxD) const {
+  std::set<GridNode*> neigh, ret;
+
+  // only sink nodes are added to the grid index
   DBox b(DPoint(p.getX() - maxD, p.getY() - maxD),
          DPoint(p.getX() + maxD, p.getY() + maxD));
 
   _grid.get(b, &neigh);
 
   for (auto n : neigh) {
-    if (n->pl().isClosed() || n->pl().isSettled()) continue;
-    double d = dist(*n->pl().getGeom(), p);
-
-    if (d < maxD) ret.push(Candidate(n, d));
+    if (dist(*n->pl().getGeom(), p) < maxD) ret.insert(n);
   }
 
   return ret;
@@ -657,8 +668,8 @@ void GridGraph::closeSinkFr(GridNode* n) {
 
 // _____________________________________________________________________________
 GridNode* GridGraph::getSettled(const CombNode* cnd) const {
-  auto i = _settled.find(cnd);
-  if (i != _settled.end()) return i->second;
+  auto i = settled().find(cnd);
+  if (i != settled().end()) return i->second;
   return 0;
 }
 
@@ -683,7 +694,7 @@ std::set<GridNode*> GridGraph::getGrNdCands(CombNode* n, size_t maxDis) {
       cands.pop();
     }
   } else {
-    tos.insert(_settled.find(n)->second);
+    tos.insert(settled().find(n)->second);
   }
 
   return tos;
@@ -691,13 +702,13 @@ std::set<GridNode*> GridGraph::getGrNdCands(CombNode* n, size_t maxDis) {
 
 // _____________________________________________________________________________
 void GridGraph::settleNd(GridNode* n, CombNode* cn) {
-  _settled[cn] = n;
+  settled()[cn] = n;
   n->pl().setSettled(true);
 }
 
 // _____________________________________________________________________________
 bool GridGraph::isSettled(const CombNode* cn) {
-  return _settled.find(cn) != _settled.end();
+  return settled().find(cn) != settled().end();
 }
 
 // _____________________________________________________________________________
@@ -746,13 +757,8 @@ GridNode* GridGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, true);
+    addGrEdg(nn, n, INF, true, true);
   }
 
   // in-node connections
@@ -765,21 +771,22 @@ GridNode* GridGraph::writeNd(size_t x, size_t y) {
       if (x == _grid.getXWidth() - 1 && i == 1) pen = INF;
       if (y == _grid.getYHeight() - 1 && i == 2) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
   return n;
 }
 
+// _____________________________________________________________________________
+GridEdge* GridGraph::addGrEdg(GridNode* from, GridNode* to, double cost,
+                              bool secondary, bool sink) {
+  // only the edge topology is stored in the edge, its state lives in _edgSts
+  return addEdg(from, to,
+                GridEdgePL(&_edgSts, _edgSts.add(cost), secondary, sink));
+}
+
 // _____________________________________________________________________________
 double GridGraph::ndMovePen(const CombNode* cbNd, const GridNode* grNd) const {
   // the move penalty has to be at least the max cost of saving a single
@@ -805,8 +812,8 @@ double GridGraph::ndMovePen(const CombNode* cbNd, const GridNode* grNd) const {
 
 // _____________________________________________________________________________
 void GridGraph::reset() {
-  _settled.clear();
-  _resEdgs.clear();
+  settled().clear();
+  resEdgs().clear();
   for (auto n : getNds()) {
     for (auto e : n->getAdjListOut()) e->pl().reset();
     if (!n->pl().isSink()) continue;
@@ -819,6 +826,25 @@ void GridGraph::reset() {
   reWriteObstCosts();
 }
 
+// _____________________________________________________________________________
+void GridGraph::setNumLayers(size_t n) {
+  assert(n > 0);
+
+  auto settled = _settled.front();
+  auto resEdgs = _resEdgs.front();
+  _settled.assign(n, settled);
+  _resEdgs.assign(n, resEdgs);
+
+  size_t numNds = getNds().size();
+  std::vector<GridNodeState>((n - 1) * numNds).swap(_ndLyrs);
+  _edgSts.setNumLayers(n);
+
+  // layers are stored one after the other, so each thread accesses a
+  // contiguous block
+  size_t i = 0;
+  for (auto nd : getNds()) nd->pl().setLayers(_ndLyrs.data() + i++, n, numNds);
+}
+
 // _____________________________________________________________________________
 void GridGraph::reWriteObstCosts() {
   for (const auto& obst : _obstacles) writeObstacleCost(obst);
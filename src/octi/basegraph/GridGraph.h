@@ -46,6 +46,9 @@ class GridGraph : public BaseGraph {
   virtual std::priority_queue<Candidate> getGridNdCands(
       const util::geo::DPoint& p, size_t maxGrD) const;
 
+  virtual std::set<GridNode*> getSinkNds(const util::geo::DPoint& p,
+                                         double maxD) const;
+
   virtual void addCostVec(GridNode* n, const NodeCost& addC);
 
   virtual void openSinkTo(GridNode* n, double cost);
@@ -74,6 +77,7 @@ class GridGraph : public BaseGraph {
   virtual GridEdge* getNEdg(const GridNode* a, const GridNode* b) const;
   virtual void init();
   virtual void reset();
+  virtual void setNumLayers(size_t n);
 
   virtual GridNode* getSettled(const CombNode* cnd) const;
 
@@ -106,23 +110,33 @@ class GridGraph : public BaseGraph {
 
   Grid<GridNode*, Point, double> _grid;
   double _cellSize, _spacer;
-  std::unordered_map<const CombNode*, GridNode*> _settled;
 
   double _heurHopCost;
 
   // encoding portable IDs for each node
   std::vector<GridNode*> _nds;
 
-  // edge id counter
-  size_t _edgeCount;
+  // costs and flags of all grid edges, indexed by the edge id
+  GridEdgeStates _edgSts;
 
   std::vector<util::geo::Polygon<double>> _obstacles;
 
-  // may be multiple resident edges if hard constraints are relaxed
-  std::unordered_map<GridEdge*, std::set<CombEdge*>> _resEdgs;
-
   const Grid<GridNode*, Point, double>& getGrid() const;
 
+  std::unordered_map<const CombNode*, GridNode*>& settled() {
+    return _settled[curLayer()];
+  }
+  const std::unordered_map<const CombNode*, GridNode*>& settled() const {
+    return _settled[curLayer()];
+  }
+
+  std::unordered_map<GridEdge*, std::set<CombEdge*>>& resEdgs() {
+    return _resEdgs[curLayer()];
+  }
+  const std::unordered_map<GridEdge*, std::set<CombEdge*>>& resEdgs() const {
+    return _resEdgs[curLayer()];
+  }
+
   virtual void writeInitialCosts();
   virtual void writeObstacleCost(const util::geo::Polygon<double>& obst);
   virtual void reWriteObstCosts();
@@ -134,6 +148,9 @@ class GridGraph : public BaseGraph {
 
   virtual GridNode* writeNd(size_t x, size_t y);
 
+  GridEdge* addGrEdg(GridNode* from, GridNode* to, double cost, bool secondary,
+                     bool sink);
+
   virtual GridNode* neigh(size_t cx, size_t cy, size_t i) const;
 
   virtual void getSettledAdjEdgs(GridNode* n, CombNode* origNd,
@@ -145,6 +162,15 @@ class GridGraph : public BaseGraph {
 
  private:
   double _bendCosts[2];
+
+  // per state layer, see curLayer()
+  std::vector<std::unordered_map<const CombNode*, GridNode*>> _settled;
+
+  // may be multiple resident edges if hard constraints are relaxed
+  std::vector<std::unordered_map<GridEdge*, std::set<CombEdge*>>> _resEdgs;
+
+  // node states of layers 1 to n - 1
+  std::vector<GridNodeState> _ndLyrs;
 };
 
 struct GridCost
@@ -12,10 +12,11 @@ GridNodePL::GridNodePL(Point<double> pos)
     : visited(false),
       _pos(pos),
       _parent(0),
-      _closed(false),
       _sink(false),
       _station(false),
-      _settled(false) {}
+      _st{false, false},
+      _lyrs(0),
+      _lyrStride(0) {}
 
 // _____________________________________________________________________________
 const Point<double>* GridNodePL::getGeom() const { return &_pos; }
@@ -25,8 +26,8 @@ util::json::Dict GridNodePL::getAttrs() const {
   util::json::Dict obj;
 
   obj["visited"] = visited ? "1" : "0";
-  obj["settled"] = _settled ? "1" : "0";
-  obj["closed"] = _closed ? "1" : "0";
+  obj["settled"] = st().settled ? "1" : "0";
+  obj["closed"] = st().closed ? "1" : "0";
   obj["grid"] = util::toString(_id);
   obj["x"] = util::toString(_x);
   obj["y"] = util::toString(_y);
@@ -65,16 +66,16 @@ size_t GridNodePL::getX() const { return _parent->pl()._x; }
 size_t GridNodePL::getY() const { return _parent->pl()._y; }
 
 // _____________________________________________________________________________
-void GridNodePL::setClosed(bool c) { _closed = c; }
+void GridNodePL::setClosed(bool c) { st().closed = c; }
 
 // _____________________________________________________________________________
-bool GridNodePL::isClosed() const { return _closed; }
+bool GridNodePL::isClosed() const { return st().closed; }
 
 // _____________________________________________________________________________
-void GridNodePL::setSettled(bool c) { _settled = c; }
+void GridNodePL::setSettled(bool c) { st().settled = c; }
 
 // _____________________________________________________________________________
-bool GridNodePL::isSettled() const { return _settled; }
+bool GridNodePL::isSettled() const { return st().settled; }
 
 // _____________________________________________________________________________
 void GridNodePL::setSink() { _sink = true; }
@@ -84,3 +85,10 @@ bool GridNodePL::isSink() const { return _sink; }
 
 // _____________________________________________________________________________
 void GridNodePL::setStation() { _station = true; }
+
+// _____________________________________________________________________________
+void GridNodePL::setLayers(GridNodeState* lyrs, size_t n, size_t stride) {
+  _lyrs = lyrs;
+  _lyrStride = stride;
+  for (size_t i = 1; i < n; i++) _lyrs[(i - 1) * _lyrStride] = _st;
+}
@@ -17,12 +17,18 @@ namespace octi {
 namespace basegraph {
 
 class GridNodePL;
+
+struct GridNodeState {
+  bool closed;
+  bool settled;
+};
+
 typedef util::graph::Node<GridNodePL, GridEdgePL> GridNode;
 typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
 
 class GridNodePL : util::geograph::GeoNodePL<double> {
  public:
-  GridNodePL(){};
+  GridNodePL() : _st{false, false}, _lyrs(0), _lyrStride(0){};
   GridNodePL(Point<double> pos);
 
   const Point<double>* getGeom() const;
@@ -52,6 +58,10 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
   void setId(size_t id);
   size_t getId() const;
 
+  // store layers 1 to n - 1 at lyrs[(i - 1) * stride], initialized with the
+  // state of layer 0, see curLayer()
+  void setLayers(GridNodeState* lyrs, size_t n, size_t stride);
+
   bool visited;
 
  private:
@@ -62,7 +72,20 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
 
   size_t _x, _y;
   size_t _id;
-  bool _closed, _sink, _station, _settled;
+  bool _sink, _station;
+
+  // state of layer 0
+  GridNodeState _st;
+
+  GridNodeState* _lyrs;
+  size_t _lyrStride;
+
+  GridNodeState& st() {
+    return curLayer() ? _lyrs[(curLayer() - 1) * _lyrStride] : _st;
+  }
+  const GridNodeState& st() const {
+    return curLayer() ? _lyrs[(curLayer() - 1) * _lyrStride] : _st;
+  }
 };
 }
 }
@@ -36,9 +36,7 @@ void HexGridGraph::init() {
         GridNode* toN = neigh(x, y, p);
         if (frN && toN) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
-          auto e = addEdg(frN, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(frN, to, 9, false, false);
         }
       }
     }
@@ -227,13 +225,8 @@ GridNode* HexGridGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, true);
+    addGrEdg(nn, n, INF, true, true);
   }
 
   // in-node connections
@@ -246,15 +239,8 @@ GridNode* HexGridGraph::writeNd(size_t x, size_t y) {
       if (x == _grid.getXWidth() - 1 && i == 1) pen = INF;
       if (y == _grid.getYHeight() - 1 && i == 2) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
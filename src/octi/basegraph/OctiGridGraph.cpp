@@ -46,17 +46,17 @@ void OctiGridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  resEdgs()[ge].erase(ce);
+  resEdgs()[gf].erase(ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (resEdgs()[ge].size() == 0) {
     if (!a->pl().isSettled()) openTurns(a);
     if (!b->pl().isSettled()) openTurns(b);
   }
 
   // unblock blocked diagonal edges crossing this edge
   size_t dir = getDir(a, b);
-  if (dir % 2 != 0 && _resEdgs[ge].size() == 0) {
+  if (dir % 2 != 0 && resEdgs()[ge].size() == 0) {
     size_t x = a->pl().getX();
     size_t y = a->pl().getY();
 
@@ -258,13 +258,8 @@ GridNode* OctiGridGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, true);
+    addGrEdg(nn, n, INF, true, true);
   }
 
   // in-node connections
@@ -278,15 +273,8 @@ GridNode* OctiGridGraph::writeNd(size_t x, size_t y) {
       if (y == _grid.getYHeight() - 1 && (i == 3 || i == 4 || i == 5))
         pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
@@ -41,16 +41,16 @@ void OctiHananGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  resEdgs()[ge].erase(ce);
+  resEdgs()[gf].erase(ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (resEdgs()[ge].size() == 0) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
 
   // unblock blocked diagonal edges crossing this edge
-  if (getDir(a, b) % 2 != 0 && _resEdgs[ge].size() == 0) {
+  if (getDir(a, b) % 2 != 0 && resEdgs()[ge].size() == 0) {
     auto pairs = _edgePairs.find(ge);
     if (pairs == _edgePairs.end()) return;
     for (auto p : pairs->second) {
@@ -360,16 +360,12 @@ void OctiHananGraph::connectNodes(GridNode* grNdFr, GridNode* grNdTo,
   GridNode* fr = grNdFr->pl().getPort(p);
   GridNode* to = grNdTo->pl().getPort((p + maxDeg() / 2) % maxDeg());
 
-  auto e = addEdg(fr, to, GridEdgePL(9, false, false));
-  e->pl().setId(_edgeCount);
-  _edgeCount++;
+  addGrEdg(fr, to, 9, false, false);
 
   _neighs[grNdFr->pl().getId() + p] = grNdTo;
   _neighs[grNdTo->pl().getId() + (p + maxDeg() / 2) % maxDeg()] = grNdFr;
 
-  auto f = addEdg(to, fr, GridEdgePL(9, false, false));
-  f->pl().setId(_edgeCount);
-  _edgeCount++;
+  addGrEdg(to, fr, 9, false, false);
 }
 
 // _____________________________________________________________________________
@@ -428,13 +424,8 @@ GridNode* OctiHananGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, true);
+    addGrEdg(nn, n, INF, true, true);
   }
 
   // in-node connections
@@ -448,15 +439,8 @@ GridNode* OctiHananGraph::writeNd(size_t x, size_t y) {
       if (y == _grid.getYHeight() - 1 && (i == 3 || i == 4 || i == 5))
         pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
@@ -43,9 +43,7 @@ void OrthoRadialGraph::init() {
         if (from != 0 && toN != 0) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
           if (!to) continue;
-          auto e = addEdg(from, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(from, to, 9, false, false);
         }
       }
     }
@@ -210,13 +208,8 @@ GridNode* OrthoRadialGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, false);
+    addGrEdg(nn, n, INF, true, false);
   }
 
   // in-node connections
@@ -233,15 +226,8 @@ GridNode* OrthoRadialGraph::writeNd(size_t x, size_t y) {
       if (y == 1 && j == 2) pen = INF;
       if (y == _grid.getYHeight() / 2 && i == 0) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
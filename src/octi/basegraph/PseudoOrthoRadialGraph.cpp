@@ -55,9 +55,7 @@ void PseudoOrthoRadialGraph::init() {
           if (y == 0) to = toN->pl().getPort(2);
           if (toN->pl().getY() == 0) to = toN->pl().getPort(x / 2);
           if (!to) continue;
-          auto e = addEdg(from, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(from, to, 9, false, false);
         }
       }
     }
@@ -315,13 +313,8 @@ GridNode* PseudoOrthoRadialGraph::writeNd(size_t x, size_t y) {
     nn->pl().setParent(n);
     n->pl().setPort(i, nn);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
-
-    e = addEdg(nn, n, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true, false);
+    addGrEdg(nn, n, INF, true, false);
   }
 
   // in-node connections
@@ -338,15 +331,8 @@ GridNode* PseudoOrthoRadialGraph::writeNd(size_t x, size_t y) {
       if (y == 1 && x % 2 && j == 2) pen = INF;
       if (y == _grid.getYHeight() / 2 && i == 0) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
-
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true, false);
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true, false);
     }
   }
 
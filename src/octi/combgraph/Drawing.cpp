@@ -15,6 +15,7 @@ using octi::combgraph::CombEdge;
 using octi::combgraph::CombGraph;
 using octi::combgraph::CombNode;
 using octi::combgraph::Drawing;
+using octi::combgraph::DrawingState;
 using octi::combgraph::GrPath;
 using octi::combgraph::Score;
 using shared::linegraph::LineEdge;
@@ -542,6 +543,54 @@ const std::map<const CombEdge*, GrPath>& Drawing::getEdgPaths() const {
   return _edgs;
 }
 
+// _____________________________________________________________________________
+template <typename K, typename V>
+void copyEntries(const std::map<K, V>& from, const std::vector<K>& keys,
+                 std::map<K, V>* to) {
+  for (auto k : keys) {
+    to->erase(k);
+    auto it = from.find(k);
+    if (it != from.end()) (*to)[k] = it->second;
+  }
+}
+
+// _____________________________________________________________________________
+DrawingState Drawing::getState(const CombNode* nd) const {
+  DrawingState ret;
+  ret.c = _c;
+  ret.violations = _violations;
+
+  ret.ndKeys.push_back(nd);
+  for (auto e : nd->getAdjList()) {
+    ret.edgKeys.push_back(e);
+    ret.ndKeys.push_back(e->getOtherNd(nd));
+  }
+
+  copyEntries(_nds, ret.ndKeys, &ret.nds);
+  copyEntries(_ndReachCosts, ret.ndKeys, &ret.ndReachCosts);
+  copyEntries(_ndBndCosts, ret.ndKeys, &ret.ndBndCosts);
+  copyEntries(_edgs, ret.edgKeys, &ret.edgs);
+  copyEntries(_edgCosts, ret.edgKeys, &ret.edgCosts);
+  copyEntries(_vios, ret.edgKeys, &ret.vios);
+  copyEntries(_springCosts, ret.edgKeys, &ret.springCosts);
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+void Drawing::setState(const DrawingState& state) {
+  _c = state.c;
+  _violations = state.violations;
+
+  copyEntries(state.nds, state.ndKeys, &_nds);
+  copyEntries(state.ndReachCosts, state.ndKeys, &_ndReachCosts);
+  copyEntries(state.ndBndCosts, state.ndKeys, &_ndBndCosts);
+  copyEntries(state.edgs, state.edgKeys, &_edgs);
+  copyEntries(state.edgCosts, state.edgKeys, &_edgCosts);
+  copyEntries(state.vios, state.edgKeys, &_vios);
+  copyEntries(state.springCosts, state.edgKeys, &_springCosts);
+}
+
 // _____________________________________________________________________________
 void Drawing::erase(CombEdge* ce) {
   _edgs.erase(ce);
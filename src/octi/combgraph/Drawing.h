@@ -67,6 +67,25 @@ struct Segment {
   std::set<CombEdge*> combEdges;
 };
 
+// The parts of a drawing which belong to a comb node, its neighbors and its
+// adjacent edges. Used as an undo log for local changes, which avoids copying
+// the entire drawing.
+struct DrawingState {
+  double c;
+  size_t violations;
+
+  std::vector<const CombNode*> ndKeys;
+  std::vector<const CombEdge*> edgKeys;
+
+  std::map<const CombNode*, size_t> nds;
+  std::map<const CombEdge*, GrPath> edgs;
+  std::map<const CombNode*, double> ndReachCosts;
+  std::map<const CombNode*, double> ndBndCosts;
+  std::map<const CombEdge*, double> edgCosts;
+  std::map<const CombEdge*, int> vios;
+  std::map<const CombEdge*, double> springCosts;
+};
+
 class Drawing {
  public:
   Drawing(const BaseGraph* gg)
@@ -106,6 +125,9 @@ class Drawing {
 
   const std::map<const CombEdge*, GrPath>& getEdgPaths() const;
 
+  DrawingState getState(const CombNode* nd) const;
+  void setState(const DrawingState& state);
+
  private:
   std::map<const CombNode*, size_t> _nds;
   std::map<const CombEdge*, GrPath> _edgs;
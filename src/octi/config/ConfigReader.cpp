@@ -56,6 +56,10 @@ void ConfigReader::help(const char* bin) const {
             << "number of threads to use by ILP solver,\n"
             << std::setw(36) << " "
             << " 0 means solver default\n"
+            << std::setw(36) << "  --heur-num-threads arg (=0)"
+            << "number of threads to use by heuristic,\n"
+            << std::setw(36) << " "
+            << " 0 means number of cores\n"
             << std::setw(36) << "  --hanan-iters arg (=1)"
             << "number of Hanan grid iterations\n"
             << std::setw(36) << "  --loc-search-max-iters arg (=100)"
@@ -74,6 +78,8 @@ void ConfigReader::help(const char* bin) const {
             << "write stats to output graph\n"
             << std::setw(36) << "  -D [ --from-dot ]"
             << "input is in dot format\n"
+            << std::setw(36) << "  --format arg (=geojson)"
+            << "output format, 'geojson' or 'binary'\n"
             << std::setw(36) << "  --no-deg2-heur"
             << "don't contract degree 2 nodes\n"
             << std::setw(36) << "  --geo-pen arg (=0)"
@@ -143,6 +149,8 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"pen-45", required_argument, 0, 23},
                          {"nd-move-pen", required_argument, 0, 24},
                          {"abort-after", required_argument, 0, 'a'},
+                         {"heur-num-threads", required_argument, 0, 25},
+                         {"format", required_argument, 0, 26},
                          {0, 0, 0, 0}};
 
   char c;
@@ -231,6 +239,12 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 24:
         cfg->pens.ndMovePen= atof(optarg);
         break;
+      case 25:
+        cfg->heurNumThreads = atoi(optarg);
+        break;
+      case 26:
+        cfg->outFormat = optarg;
+        break;
       case 'g':
         cfg->gridSize = optarg;
         break;
@@ -301,4 +315,10 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
     LOG(ERROR) << "Unknown base graph type " << baseGraphStr << std::endl;
     exit(0);
   }
+
+  if (cfg->outFormat != "geojson" && cfg->outFormat != "binary") {
+    LOG(ERROR) << "Unknown output format " << cfg->outFormat
+               << ", must be one of {geojson, binary}";
+    exit(1);
+  }
 }
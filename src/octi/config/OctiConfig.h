@@ -28,6 +28,7 @@ struct Config {
   double borderRad = 45;
 
   std::string printMode = "linegraph";
+  std::string outFormat = "geojson";
   std::string optMode = "heur";
   std::string ilpPath;
   bool fromDot = false;
@@ -45,6 +46,9 @@ struct Config {
 
   int heurLocSearchIters = 100;
 
+  // number of threads used by the heuristic approach, 0 means all cores
+  size_t heurNumThreads = 0;
+
   size_t abortAfter = -1;
 
   size_t hananIters = 1;
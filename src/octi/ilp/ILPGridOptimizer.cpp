@@ -14,8 +14,11 @@ using octi::basegraph::GeoPensMap;
 using octi::basegraph::GridEdge;
 using octi::basegraph::GridNode;
 using octi::combgraph::Drawing;
+using octi::ilp::FeasibleSol;
 using octi::ilp::ILPGridOptimizer;
 using octi::ilp::ILPStats;
+using octi::ilp::ILPVars;
+using shared::optim::ILPModel;
 using shared::optim::ILPSolver;
 using shared::optim::StarterSol;
 
@@ -30,7 +33,7 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
                                     const std::string& path) const {
   // extract first feasible solution from gridgraph
   ILPStats s{std::numeric_limits<double>::infinity(), 0, 0, 0, 0};
-  StarterSol sol = extractFeasibleSol(d, gg, cg, maxGrDist);
+  FeasibleSol feasSol = extractFeasibleSol(d, gg, cg, maxGrDist);
   gg->reset();
 
   for (auto nd : gg->getNds()) {
@@ -48,11 +51,18 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
   // clear drawing
   d->crumble();
 
-  auto lp = createProblem(gg, cg, geoPensMap, maxGrDist, solverStr);
+  // names are only needed for the MPS output
+  ILPModel m(path.size());
+  ILPVars vars;
+  createProblem(gg, cg, geoPensMap, maxGrDist, &m, &vars);
 
-  s.cols = lp->getNumVars();
-  s.rows = lp->getNumConstrs();
+  s.cols = m.getNumCols();
+  s.rows = m.getNumRows();
 
+  StarterSol sol = getStarterSol(feasSol, vars);
+
+  ILPSolver* lp = shared::optim::getSolver(solverStr, shared::optim::MIN);
+  lp->load(m);
   lp->setStarter(sol);
 
   if (path.size()) {
@@ -62,7 +72,7 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
 
     std::string outf = basename + ".sol";
     std::string solutionF = basename + ".mst";
-    lp->writeMst(solutionF, sol);
+    m.writeMst(solutionF, sol);
     lp->writeMps(path);
   }
 
@@ -84,7 +94,7 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
           "limit)!");
     }
 
-    extractSolution(lp, gg, cg, d);
+    extractSolution(lp, vars, gg, cg, d);
     shared::linegraph::LineGraph tg;
     d->getLineGraph(&tg);
 
@@ -99,52 +109,42 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
 }
 
 // _____________________________________________________________________________
-ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
-                                           const GeoPensMap* geoPensMap,
-                                           double maxGrDist,
-                                           const std::string& solverStr) const {
-  ILPSolver* lp = shared::optim::getSolver(solverStr, shared::optim::MIN);
-
+void ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
+                                     const GeoPensMap* geoPensMap,
+                                     double maxGrDist, ILPModel* m,
+                                     ILPVars* vars) const {
   // grid nodes that may potentially be a position for an
   // input station
   std::map<const CombNode*, std::set<const GridNode*>> cands;
 
+  // threshold for speedup
+  double maxDis = gg->getCellSize() * maxGrDist;
+
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    std::stringstream oneAssignment;
     // must sum up to 1
-    oneAssignment << "oneass(" << nd << ")";
-    int rowStat = lp->addRow(oneAssignment.str(), 1, shared::optim::FIX);
+    int rowStat =
+        m->addRow(1, shared::optim::FIX, m->name("oneass(", nd, ")"));
 
     size_t i = 0;
 
-    for (const GridNode* n : gg->getNds()) {
-      if (!n->pl().isSink()) continue;
-
+    for (const GridNode* n : gg->getSinkNds(*nd->pl().getGeom(), maxDis)) {
       // don't use nodes as candidates which cannot hold the comb node due to
       // their degree
       if (n->getDeg() < nd->getDeg()) {
         continue;
       }
 
-      double gridD = dist(*n->pl().getGeom(), *nd->pl().getGeom());
-
-      // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
-      if (gridD >= maxDis) {
-        continue;
-      }
-
       cands[nd].insert(n);
 
       gg->openSinkFr(const_cast<GridNode*>(n), 0);
       gg->openSinkTo(const_cast<GridNode*>(n), 0);
 
-      auto varName = getStatPosVar(n, nd);
+      int col = m->addCol(shared::optim::BIN, gg->ndMovePen(nd, n),
+                          m->hasNames() ? getStatPosVar(n, nd) : "");
+      vars->statPos[nd][n] = col;
 
-      int col = lp->addCol(varName, shared::optim::BIN, gg->ndMovePen(nd, n));
-
-      lp->addColToRow(rowStat, col, 1);
+      m->addColToRow(rowStat, col, 1);
 
       i++;
     }
@@ -175,24 +175,22 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             continue;
           }
 
-          auto edgeVarName = getEdgUseVar(e, edg);
-
           double coef;
           if (geoPensMap && !e->pl().isSecondary()) {
             // add geo pen
             coef = e->pl().cost() +
-                   (*geoPensMap).find(edg)->second[e->pl().getId()];
+                   (*geoPensMap).find(edg)->second.get(e->pl().getId());
           } else {
             coef = e->pl().cost();
           }
-          lp->addCol(edgeVarName, shared::optim::BIN, coef);
+          vars->edgUse[edg][e] = m->addCol(
+              shared::optim::BIN, coef,
+              m->hasNames() ? getEdgUseVar(e, edg) : "");
         }
       }
     }
   }
 
-  lp->update();
-
   // an edge can only be used a single time
   std::set<const GridEdge*> proced;
   for (const GridNode* n : gg->getNds()) {
@@ -203,23 +201,19 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
       proced.insert(e);
       proced.insert(f);
 
-      std::stringstream constName;
-      constName << "ue(" << e->getFrom()->pl().getId() << ","
-                << e->getTo()->pl().getId() << ")";
-      int row = lp->addRow(constName.str(), 1, shared::optim::UP);
+      int row = m->addRow(1, shared::optim::UP,
+                          m->name("ue(", e->getFrom()->pl().getId(), ",",
+                                  e->getTo()->pl().getId(), ")"));
 
       for (auto nd : cg.getNds()) {
         for (auto edg : nd->getAdjList()) {
           if (edg->getFrom() != nd) continue;
           if (e->pl().cost() >= basegraph::SOFT_INF) continue;
 
-          auto eVarName = getEdgUseVar(e, edg);
-          auto fVarName = getEdgUseVar(f, edg);
-
-          int eCol = lp->getVarByName(eVarName);
-          if (eCol > -1) lp->addColToRow(row, eCol, 1);
-          int fCol = lp->getVarByName(fVarName);
-          if (fCol > -1) lp->addColToRow(row, fCol, 1);
+          int eCol = vars->getEdgUse(e, edg);
+          if (eCol > -1) m->addColToRow(row, eCol, 1);
+          int fCol = vars->getEdgUse(f, edg);
+          if (fCol > -1) m->addColToRow(row, fCol, 1);
         }
       }
     }
@@ -233,11 +227,9 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     for (auto nd : cg.getNds()) {
       for (auto edg : nd->getAdjList()) {
         if (edg->getFrom() != nd) continue;
-        std::stringstream constName;
-        constName << "as(" << n->pl().getId() << "," << edg << ")";
-
         // an upper bound is enough here
-        int row = lp->addRow(constName.str(), 0, shared::optim::UP);
+        int row = m->addRow(0, shared::optim::UP,
+                            m->name("as(", n->pl().getId(), ",", edg, ")"));
 
         // normally, we count an incoming edge as 1 and an outgoing edge as -1
         // later on, we make sure that each node has a some of all out and in
@@ -261,34 +253,32 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         if (n->pl().isSink()) {
           // subtract the variable for this start node and edge, if used
           // as a candidate
-          int ndColFrom = lp->getVarByName(getStatPosVar(n, edg->getFrom()));
-          if (ndColFrom > -1) lp->addColToRow(row, ndColFrom, -2);
+          int ndColFrom = vars->getStatPos(n, edg->getFrom());
+          if (ndColFrom > -1) m->addColToRow(row, ndColFrom, -2);
 
           // add the variable for this end node and edge, if used
           // as a candidate
-          int ndColTo = lp->getVarByName(getStatPosVar(n, edg->getTo()));
-          if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
+          int ndColTo = vars->getStatPos(n, edg->getTo());
+          if (ndColTo > -1) m->addColToRow(row, ndColTo, 1);
 
           outCost = 2;
         }
 
         for (auto e : n->getAdjListIn()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
+          int edgCol = vars->getEdgUse(e, edg);
           if (edgCol < 0) continue;
-          lp->addColToRow(row, edgCol, inCost);
+          m->addColToRow(row, edgCol, inCost);
         }
 
         for (auto e : n->getAdjListOut()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
+          int edgCol = vars->getEdgUse(e, edg);
           if (edgCol < 0) continue;
-          lp->addColToRow(row, edgCol, outCost);
+          m->addColToRow(row, edgCol, outCost);
         }
       }
     }
   }
 
-  lp->update();
-
   // only a single sink edge can be activated per input edge and settled grid
   // node
   // THIS RULE IS REDUNDANT AND IMPLICITELY ENFORCED BY OTHER RULES,
@@ -300,10 +290,8 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
       for (auto e : nd->getAdjList()) {
         if (e->getFrom() != nd) continue;
 
-        std::stringstream constName;
-        constName << "ss(" << n->pl().getId() << "," << e << ")";
-
-        int row = lp->addRow(constName.str(), 0, shared::optim::FIX);
+        int row = m->addRow(0, shared::optim::FIX,
+                            m->name("ss(", n->pl().getId(), ",", e, ")"));
 
         if (!cands[e->getFrom()].count(n) && !cands[e->getTo()].count(n)) {
           // node does not appear as start or end cand, so the number of
@@ -311,27 +299,24 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
         } else {
           if (cands[e->getTo()].count(n)) {
-            int ndColTo = lp->getVarByName(getStatPosVar(n, e->getTo()));
-            if (ndColTo > -1) lp->addColToRow(row, ndColTo, -1);
+            int ndColTo = vars->getStatPos(n, e->getTo());
+            if (ndColTo > -1) m->addColToRow(row, ndColTo, -1);
           }
 
           if (cands[e->getFrom()].count(n)) {
-            int ndColFr = lp->getVarByName(getStatPosVar(n, e->getFrom()));
-            if (ndColFr > -1) lp->addColToRow(row, ndColFr, -1);
+            int ndColFr = vars->getStatPos(n, e->getFrom());
+            if (ndColFr > -1) m->addColToRow(row, ndColFr, -1);
           }
         };
 
         for (size_t p = 0; p < gg->maxDeg(); p++) {
           auto portNd = n->pl().getPort(p);
           if (!portNd) continue;
-          auto varSinkTo = getEdgUseVar(gg->getEdg(portNd, n), e);
-          auto varSinkFr = getEdgUseVar(gg->getEdg(n, portNd), e);
-
-          int ndColTo = lp->getVarByName(varSinkTo);
-          if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
+          int ndColTo = vars->getEdgUse(gg->getEdg(portNd, n), e);
+          if (ndColTo > -1) m->addColToRow(row, ndColTo, 1);
 
-          int ndColFr = lp->getVarByName(varSinkFr);
-          if (ndColFr > -1) lp->addColToRow(row, ndColFr, 1);
+          int ndColFr = vars->getEdgUse(gg->getEdg(n, portNd), e);
+          if (ndColFr > -1) m->addColToRow(row, ndColFr, 1);
         }
       }
     }
@@ -342,17 +327,15 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   for (GridNode* n : gg->getNds()) {
     if (!n->pl().isSink()) continue;
 
-    std::stringstream constName;
-    constName << "iu(" << n->pl().getId() << ")";
-
-    int row = lp->addRow(constName.str(), 1, shared::optim::UP);
+    int row = m->addRow(1, shared::optim::UP,
+                        m->name("iu(", n->pl().getId(), ")"));
 
     // a meta grid node can either be a sink for a single input node, or
     // a pass-through
 
     for (auto nd : cg.getNds()) {
-      int ndcolto = lp->getVarByName(getStatPosVar(n, nd).c_str());
-      if (ndcolto > -1) lp->addColToRow(row, ndcolto, 1);
+      int ndcolto = vars->getStatPos(n, nd);
+      if (ndcolto > -1) m->addColToRow(row, ndcolto, 1);
     }
 
     // go over all ports
@@ -368,70 +351,63 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
           for (auto edg : nd->getAdjList()) {
             if (edg->getFrom() != nd) continue;
 
-            int edgCol = lp->getVarByName(getEdgUseVar(innerE, edg));
+            int edgCol = vars->getEdgUse(innerE, edg);
             if (edgCol < 0) continue;
-            lp->addColToRow(row, edgCol, 1);
+            m->addColToRow(row, edgCol, 1);
           }
         }
       }
     }
   }
 
-  lp->update();
-
   // dont allow crossing edges
   size_t rowId = 0;
   for (auto edgPair : gg->getCrossEdgPairs()) {
-    std::stringstream constName;
-    constName << "nc(" << rowId << ")";
+    int row = m->addRow(1, shared::optim::UP, m->name("nc(", rowId, ")"));
     rowId++;
 
-    int row = lp->addRow(constName.str(), 1, shared::optim::UP);
-
     for (auto nd : cg.getNds()) {
       for (auto edg : nd->getAdjList()) {
         if (edg->getFrom() != nd) continue;
 
-        int col = lp->getVarByName(getEdgUseVar(edgPair.first.first, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+        int col = vars->getEdgUse(edgPair.first.first, edg);
+        if (col > -1) m->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.first.second, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+        col = vars->getEdgUse(edgPair.first.second, edg);
+        if (col > -1) m->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.first, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+        col = vars->getEdgUse(edgPair.second.first, edg);
+        if (col > -1) m->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.second, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+        col = vars->getEdgUse(edgPair.second.second, edg);
+        if (col > -1) m->addColToRow(row, col, 1);
       }
     }
   }
 
-  lp->update();
+  // direction variables, per comb node and adjacent comb edge
+  std::map<std::pair<const CombNode*, const CombEdge*>, int> dirCols;
 
   // for each input node N, define a var x_dirNE which tells the direction of
   // E at N
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() < 2) continue;  // we don't need this for deg 1 nodes
     for (auto edg : nd->getAdjList()) {
-      std::stringstream dirName;
-      dirName << "d(" << nd << "," << edg << ")";
-      int col =
-          lp->addCol(dirName.str(), shared::optim::INT, 0, 0, gg->maxDeg() - 1);
-
-      std::stringstream constName;
-      constName << "dc(" << nd << "," << edg << ")";
+      int col = m->addCol(shared::optim::INT, 0, 0, gg->maxDeg() - 1,
+                          m->name("d(", nd, ",", edg, ")"));
+      dirCols[{nd, edg}] = col;
 
-      int row = lp->addRow(constName.str(), 0, shared::optim::FIX);
+      int row = m->addRow(0, shared::optim::FIX,
+                          m->name("dc(", nd, ",", edg, ")"));
 
-      lp->addColToRow(row, col, -1);
+      m->addColToRow(row, col, -1);
 
       for (GridNode* n : gg->getNds()) {
         if (!n->pl().isSink()) continue;
 
         // check if this grid node is used as a candidate for comb node
         // if not, we don't have to add the constraints
-        int ndColFrom = lp->getVarByName(getStatPosVar(n, nd));
+        int ndColFrom = vars->getStatPos(n, nd);
         if (ndColFrom == -1) continue;
 
         if (edg->getFrom() == nd) {
@@ -440,8 +416,8 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(n, portNd);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
-            if (col > -1) lp->addColToRow(row, col, i);
+            int col = vars->getEdgUse(e, edg);
+            if (col > -1) m->addColToRow(row, col, i);
           }
         } else {
           // the 0 can be skipped here
@@ -449,16 +425,14 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(portNd, n);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
-            if (col > -1) lp->addColToRow(row, col, i);
+            int col = vars->getEdgUse(e, edg);
+            if (col > -1) m->addColToRow(row, col, i);
           }
         }
       }
     }
   }
 
-  lp->update();
-
   // for each input node N, make sure that the circular ordering of the final
   // drawing matches the input ordering
   int M = gg->maxDeg();
@@ -466,22 +440,20 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     // for degree < 3, the circular ordering cannot be violated
     if (nd->getDeg() < 3) continue;
 
-    std::stringstream vulnConstName;
-    vulnConstName << "vc(" << nd << ")";
     // an upper bound would also work here, at most one
     // of the vuln vars may be 1
 
-    int vulnRow = lp->addRow(vulnConstName.str(), 1, shared::optim::FIX);
+    int vulnRow =
+        m->addRow(1, shared::optim::FIX, m->name("vc(", nd, ")"));
 
+    std::vector<int> vulnCols;
     for (size_t i = 0; i < nd->getDeg(); i++) {
-      std::stringstream n;
-      n << "vuln(" << nd << "," << i << ")";
-      int col = lp->addCol(n.str(), shared::optim::BIN, 0);
-      lp->addColToRow(vulnRow, col, 1);
+      int col = m->addCol(shared::optim::BIN, 0,
+                          m->name("vuln(", nd, ",", i, ")"));
+      vulnCols.push_back(col);
+      m->addColToRow(vulnRow, col, 1);
     }
 
-    lp->update();
-
     auto order = nd->pl().getEdgeOrdering().getOrderedSet();
     assert(order.size() > 2);
     for (size_t i = 0; i < order.size(); i++) {
@@ -495,33 +467,24 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
       assert(edgA != edgB);
 
-      std::stringstream colNameA;
-      colNameA << "d(" << nd << "," << edgA << ")";
-      int colA = lp->getVarByName(colNameA.str());
-      assert(colA > -1);
+      assert(dirCols.count({nd, edgA}));
+      int colA = dirCols[{nd, edgA}];
 
-      std::stringstream colNameB;
-      colNameB << "d(" << nd << "," << edgB << ")";
-      int colB = lp->getVarByName(colNameB.str());
-      assert(colB > -1);
+      assert(dirCols.count({nd, edgB}));
+      int colB = dirCols[{nd, edgB}];
 
-      std::stringstream constName;
-      constName << "oc(" << nd << "," << i << ")";
-      int row = lp->addRow(constName.str(), 1, shared::optim::LO);
+      int row = m->addRow(1, shared::optim::LO,
+                          m->name("oc(", nd, ",", i, ")"));
 
-      std::stringstream vulnColName;
-      vulnColName << "vuln(" << nd << "," << i << ")";
-      int vulnCol = lp->getVarByName(vulnColName.str());
-      assert(vulnCol > -1);
+      assert(i < vulnCols.size());
+      int vulnCol = vulnCols[i];
 
-      lp->addColToRow(row, colB, 1);
-      lp->addColToRow(row, colA, -1);
-      lp->addColToRow(row, vulnCol, M);
+      m->addColToRow(row, colB, 1);
+      m->addColToRow(row, colA, -1);
+      m->addColToRow(row, vulnCol, M);
     }
   }
 
-  lp->update();
-
   std::vector<double> pens = gg->getCosts();
 
   // for each adjacent edge pair, add variables telling the accuteness of the
@@ -547,76 +510,60 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
         if (!sharedLines) continue;
 
-        std::stringstream negVar;
-        negVar << "negdist(" << edgA << "," << edgB << ")";
+        int colNeg = m->addCol(shared::optim::BIN, 0,
+                               m->name("negdist(", edgA, ",", edgB, ")"));
 
-        int colNeg = lp->addCol(negVar.str(), shared::optim::BIN, 0);
+        int row1 = m->addRow(0, shared::optim::LO,
+                             m->name("nc(", edgA, ",", edgB, ")lo"));
+        int row2 = m->addRow(gg->maxDeg() - 1, shared::optim::UP,
+                             m->name("nc(", edgA, ",", edgB, ")up"));
 
-        std::stringstream constName;
-        constName << "nc(" << edgA << "," << edgB << ")";
+        assert(dirCols.count({nd, edgA}));
+        int colA = dirCols[{nd, edgA}];
+        m->addColToRow(row1, colA, 1);
+        m->addColToRow(row2, colA, 1);
 
-        int row1 = lp->addRow(constName.str() + "lo", 0, shared::optim::LO);
-        int row2 = lp->addRow(constName.str() + "up", gg->maxDeg() - 1,
-                              shared::optim::UP);
+        assert(dirCols.count({nd, edgB}));
+        int colB = dirCols[{nd, edgB}];
+        m->addColToRow(row1, colB, -1);
+        m->addColToRow(row2, colB, -1);
 
-        std::stringstream dirNameA;
-        dirNameA << "d(" << nd << "," << edgA << ")";
-        std::stringstream dirNameB;
-        dirNameB << "d(" << nd << "," << edgB << ")";
+        m->addColToRow(row1, colNeg, gg->maxDeg());
+        m->addColToRow(row2, colNeg, gg->maxDeg());
 
-        int colA = lp->getVarByName(dirNameA.str());
-        assert(colA > -1);
-        lp->addColToRow(row1, colA, 1);
-        lp->addColToRow(row2, colA, 1);
+        int rowAng = m->addRow(0, shared::optim::FIX,
+                               m->name("ac(", edgA, ",", edgB, ")"));
 
-        int colB = lp->getVarByName(dirNameB.str());
-        assert(colB > -1);
-        lp->addColToRow(row1, colB, -1);
-        lp->addColToRow(row2, colB, -1);
+        m->addColToRow(rowAng, colA, 1);
+        m->addColToRow(rowAng, colB, -1);
+        m->addColToRow(rowAng, colNeg, gg->maxDeg());
 
-        lp->addColToRow(row1, colNeg, gg->maxDeg());
-        lp->addColToRow(row2, colNeg, gg->maxDeg());
-
-        std::stringstream angConst;
-        angConst << "ac(" << edgA << "," << edgB << ")";
-        int rowAng = lp->addRow(angConst.str(), 0, shared::optim::FIX);
-
-        lp->addColToRow(rowAng, colA, 1);
-        lp->addColToRow(rowAng, colB, -1);
-        lp->addColToRow(rowAng, colNeg, gg->maxDeg());
-
-        std::stringstream sumConst;
-        sumConst << "asc(" << edgA << "," << edgB << ")";
-
-        int rowSum = lp->addRow(sumConst.str(), 1, shared::optim::UP);
+        int rowSum = m->addRow(1, shared::optim::UP,
+                               m->name("asc(", edgA, ",", edgB, ")"));
 
         int N = gg->maxDeg() - 1;
         int M = pens.size();
 
         for (int k = 0; k < N; k++) {
-          std::stringstream var;
+          std::string var;
           size_t pp = pens.size() - 1 - k;
           if (k >= M) {
             pp = k + 1 - pens.size();
-            var << "d" << pp << "'(" << edgA << "," << edgB << ")";
+            var = m->name("d", pp, "'(", edgA, ",", edgB, ")");
           } else {
-            var << "d" << pp << "(" << edgA << "," << edgB << ")";
+            var = m->name("d", pp, "(", edgA, ",", edgB, ")");
           }
 
           // TODO: maybe multiply per shared lines - but this actually
           // makes the drawings look worse.
-          int col = lp->addCol(var.str(), shared::optim::BIN, pens[pp]);
+          int col = m->addCol(shared::optim::BIN, pens[pp], var);
 
-          lp->addColToRow(rowAng, col, -(k + 1));
-          lp->addColToRow(rowSum, col, 1);
+          m->addColToRow(rowAng, col, -(k + 1));
+          m->addColToRow(rowSum, col, 1);
         }
       }
     }
   }
-
-  lp->update();
-
-  return lp;
 }
 
 // _____________________________________________________________________________
@@ -639,8 +586,8 @@ std::string ILPGridOptimizer::getStatPosVar(const GridNode* n,
 }
 
 // _____________________________________________________________________________
-void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
-                                       const CombGraph& cg,
+void ILPGridOptimizer::extractSolution(ILPSolver* lp, const ILPVars& vars,
+                                       BaseGraph* gg, const CombGraph& cg,
                                        combgraph::Drawing* d) const {
   std::map<const CombNode*, const GridNode*> gridNds;
   std::map<const CombEdge*, std::set<const GridEdge*>> gridEdgs;
@@ -653,9 +600,7 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
       for (auto nd : cg.getNds()) {
         for (auto edg : nd->getAdjList()) {
           if (edg->getFrom() != nd) continue;
-          auto varName = getEdgUseVar(e, edg);
-
-          int i = lp->getVarByName(varName);
+          int i = vars.getEdgUse(e, edg);
           if (i > -1) {
             double val = lp->getVarVal(i);
             if (val > 0.5) {
@@ -671,9 +616,7 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
   for (GridNode* n : gg->getNds()) {
     if (!n->pl().isSink()) continue;
     for (auto nd : cg.getNds()) {
-      auto varName = getStatPosVar(n, nd);
-
-      int i = lp->getVarByName(varName);
+      int i = vars.getStatPos(n, nd);
       if (i > -1) {
         double val = lp->getVarVal(i);
         if (val > 0.5) {
@@ -745,26 +688,21 @@ size_t ILPGridOptimizer::nonInfDeg(const GridNode* g) const {
 }
 
 // _____________________________________________________________________________
-StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
-                                                const CombGraph& cg,
-                                                double maxGrDist) const {
-  StarterSol sol;
+FeasibleSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
+                                                 const CombGraph& cg,
+                                                 double maxGrDist) const {
+  FeasibleSol sol;
+
+  // threshold for speedup
+  double maxDis = gg->getCellSize() * maxGrDist;
 
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
     auto settled = gg->getSettled(nd);
 
-    for (auto gnd : gg->getNds()) {
-      if (!gnd->pl().isSink()) continue;
-      double gridD = dist(*nd->pl().getGeom(), *gnd->pl().getGeom());
-
-      // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
-      if (gridD >= maxDis) continue;
-
-      auto varName = getStatPosVar(gnd, nd);
+    for (auto gnd : gg->getSinkNds(*nd->pl().getGeom(), maxDis)) {
       if (gnd == settled) {
-        sol[varName] = 1;
+        sol.statPos[{gnd, nd}] = 1;
 
         // if settled, all bend edges are unused
         for (size_t p = 0; p < gg->maxDeg(); p++) {
@@ -774,13 +712,12 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
             if (!bendEdg->pl().isSecondary()) continue;
             for (auto cEdg : nd->getAdjList()) {
               if (cEdg->getFrom() != nd) continue;
-              auto varName = getEdgUseVar(bendEdg, cEdg);
-              sol[varName] = 0;
+              sol.edgUse[{bendEdg, cEdg}] = 0;
             }
           }
         }
       } else {
-        sol[varName] = 0;
+        sol.statPos[{gnd, nd}] = 0;
 
         // if not settled, all sink edges are unused
         // for all input edges
@@ -788,8 +725,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
           assert(sinkEdg->pl().isSecondary());
           for (auto cEdg : nd->getAdjList()) {
             if (cEdg->getFrom() != nd) continue;
-            auto varName = getEdgUseVar(sinkEdg, cEdg);
-            sol[varName] = 0;
+            sol.edgUse[{sinkEdg, cEdg}] = 0;
           }
         }
       }
@@ -804,8 +740,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
       for (auto cNd : cg.getNds()) {
         for (auto cEdg : cNd->getAdjList()) {
           if (cEdg->getFrom() != cNd) continue;
-          auto varName = getEdgUseVar(grEdg, cEdg);
-          sol[varName] = 0;
+          sol.edgUse[{grEdg, cEdg}] = 0;
         }
       }
     }
@@ -817,8 +752,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
     const auto& grEdgList = a.second;
     for (auto xy : grEdgList) {
       auto grEdg = gg->getGrEdgById(xy);
-      auto varName = getEdgUseVar(grEdg, cEdg);
-      sol[varName] = 1;
+      sol.edgUse[{grEdg, cEdg}] = 1;
     }
   }
 
@@ -826,3 +760,40 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
   // typically be filled by the solver using the information given above
   return sol;
 }
+
+// _____________________________________________________________________________
+StarterSol ILPGridOptimizer::getStarterSol(const FeasibleSol& sol,
+                                           const ILPVars& vars) const {
+  StarterSol ret;
+
+  // variables not present in the ILP are skipped
+  for (const auto& kv : sol.statPos) {
+    int col = vars.getStatPos(kv.first.first, kv.first.second);
+    if (col > -1) ret[col] = kv.second;
+  }
+
+  for (const auto& kv : sol.edgUse) {
+    int col = vars.getEdgUse(kv.first.first, kv.first.second);
+    if (col > -1) ret[col] = kv.second;
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+int ILPVars::getEdgUse(const GridEdge* e, const CombEdge* ce) const {
+  auto i = edgUse.find(ce);
+  if (i == edgUse.end()) return -1;
+  auto j = i->second.find(e);
+  if (j == i->second.end()) return -1;
+  return j->second;
+}
+
+// _____________________________________________________________________________
+int ILPVars::getStatPos(const GridNode* n, const CombNode* cn) const {
+  auto i = statPos.find(cn);
+  if (i == statPos.end()) return -1;
+  auto j = i->second.find(n);
+  if (j == i->second.end()) return -1;
+  return j->second;
+}
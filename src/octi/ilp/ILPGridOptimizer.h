@@ -5,10 +5,14 @@
 #ifndef OCTI_ILP_ILPGRIDOPTIMIZER_H_
 #define OCTI_ILP_ILPGRIDOPTIMIZER_H_
 
+#include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/combgraph/Drawing.h"
+#include "shared/optim/ILPModel.h"
 #include "shared/optim/ILPSolver.h"
 
 using octi::basegraph::BaseGraph;
@@ -30,6 +34,23 @@ struct ILPStats {
   bool optimal;
 };
 
+// column ids of the edge use and station position variables
+struct ILPVars {
+  std::map<const CombEdge*, std::unordered_map<const GridEdge*, int>> edgUse;
+  std::map<const CombNode*, std::unordered_map<const GridNode*, int>> statPos;
+
+  // -1 if there is no such variable
+  int getEdgUse(const GridEdge* e, const CombEdge* ce) const;
+  int getStatPos(const GridNode* n, const CombNode* cn) const;
+};
+
+// feasible solution given by grid graph elements, translated to a starter
+// solution once the ILP has been built
+struct FeasibleSol {
+  std::map<std::pair<const GridEdge*, const CombEdge*>, int> edgUse;
+  std::map<std::pair<const GridNode*, const CombNode*>, int> statPos;
+};
+
 class ILPGridOptimizer {
  public:
   ILPGridOptimizer() {}
@@ -42,21 +63,22 @@ class ILPGridOptimizer {
                     const std::string& path) const;
 
  protected:
-  shared::optim::ILPSolver* createProblem(
-      BaseGraph* gg, const CombGraph& cg,
-      const basegraph::GeoPensMap* geoPensMap, double maxGrDist,
-      const std::string& solverStr) const;
+  void createProblem(BaseGraph* gg, const CombGraph& cg,
+                     const basegraph::GeoPensMap* geoPensMap, double maxGrDist,
+                     shared::optim::ILPModel* m, ILPVars* vars) const;
 
   std::string getEdgUseVar(const GridEdge* e, const CombEdge* cg) const;
   std::string getStatPosVar(const GridNode* e, const CombNode* cg) const;
 
-  void extractSolution(shared::optim::ILPSolver* lp, BaseGraph* gg,
-                       const CombGraph& cg, combgraph::Drawing* d) const;
+  void extractSolution(shared::optim::ILPSolver* lp, const ILPVars& vars,
+                       BaseGraph* gg, const CombGraph& cg,
+                       combgraph::Drawing* d) const;
+
+  FeasibleSol extractFeasibleSol(combgraph::Drawing* d, BaseGraph* gg,
+                                 const CombGraph& cg, double maxGrDist) const;
 
-  shared::optim::StarterSol extractFeasibleSol(combgraph::Drawing* d,
-                                               BaseGraph* gg,
-                                               const CombGraph& cg,
-                                               double maxGrDist) const;
+  shared::optim::StarterSol getStarterSol(const FeasibleSol& sol,
+                                          const ILPVars& vars) const;
 
   size_t nonInfDeg(const GridNode* g) const;
 };
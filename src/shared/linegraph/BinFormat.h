@@ -0,0 +1,109 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef SHARED_LINEGRAPH_BINFORMAT_H_
+#define SHARED_LINEGRAPH_BINFORMAT_H_
+
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+// Binary line graph format. All integers are written as LEB128 varints,
+// signed integers are zigzag encoded. Strings are given by their index into
+// the string table. Coordinates are fixed point numbers with PREC decimal
+// digits, each written as the delta to the previously written coordinate.
+//
+//  header  MAGIC, VERSION (1 byte each), precision, metadata string
+//          (JSON attributes like statistics, may be empty)
+//  strings count, then length and bytes of each string
+//  lines   count, then id, label, color of each line
+//  nodes   count, then for each node: x, y, station count, and id, name
+//          of each station
+//  edges   count, then for each edge: from node, to node, flags, point
+//          count, the points, occurrence count and for each occurrence:
+//          line, direction (node + 1, 0 for both directions), style + 1 and
+//          outline style + 1 (0 if not set)
+//  excs    count, then for each node with exceptions: node, count and
+//          lines not served, count and (line, edge a, edge b) of each
+//          excluded line connection
+
+namespace shared {
+namespace linegraph {
+namespace bin {
+
+const static char MAGIC[] = "\x89LGB";
+const static uint8_t VERSION = 1;
+const static uint8_t PREC = 6;
+
+const static uint8_t F_DONT_CONTRACT = 1;
+
+// _____________________________________________________________________________
+inline void writeUInt(std::streambuf* out, uint64_t v) {
+  while (v >= 0x80) {
+    out->sputc(static_cast<char>((v & 0x7F) | 0x80));
+    v >>= 7;
+  }
+  out->sputc(static_cast<char>(v));
+}
+
+// _____________________________________________________________________________
+inline void writeInt(std::streambuf* out, int64_t v) {
+  writeUInt(out,
+            (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+// _____________________________________________________________________________
+inline uint64_t readUInt(std::streambuf* in) {
+  uint64_t ret = 0;
+  for (size_t shift = 0; shift < 64; shift += 7) {
+    int c = in->sbumpc();
+    if (c == std::char_traits<char>::eof())
+      throw std::runtime_error("Unexpected end of binary line graph.");
+    ret |= static_cast<uint64_t>(c & 0x7F) << shift;
+    if (!(c & 0x80)) return ret;
+  }
+  throw std::runtime_error("Invalid varint in binary line graph.");
+}
+
+// _____________________________________________________________________________
+inline int64_t readInt(std::streambuf* in) {
+  uint64_t v = readUInt(in);
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// _____________________________________________________________________________
+inline void writeStr(std::streambuf* out, const std::string& str) {
+  writeUInt(out, str.size());
+  out->sputn(str.data(), str.size());
+}
+
+// _____________________________________________________________________________
+inline std::string readStr(std::streambuf* in) {
+  std::string ret(readUInt(in), 0);
+  if (in->sgetn(&ret[0], ret.size()) != static_cast<int64_t>(ret.size()))
+    throw std::runtime_error("Unexpected end of binary line graph.");
+  return ret;
+}
+
+// _____________________________________________________________________________
+inline double fixedMult(uint8_t prec) {
+  // no std::pow, which is not exact under -Ofast
+  double ret = 1;
+  while (prec--) ret *= 10;
+  return ret;
+}
+
+// _____________________________________________________________________________
+inline int64_t toFixed(double v, double mult) {
+  return static_cast<int64_t>(std::llround(v * mult));
+}
+
+}  // namespace bin
+}  // namespace linegraph
+}  // namespace shared
+
+#endif  // SHARED_LINEGRAPH_BINFORMAT_H_
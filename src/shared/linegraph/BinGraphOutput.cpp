@@ -0,0 +1,208 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shared/linegraph/BinFormat.h"
+#include "shared/linegraph/BinGraphOutput.h"
+
+using shared::linegraph::BinGraphOutput;
+using shared::linegraph::LineEdge;
+using shared::linegraph::LineGraph;
+using shared::linegraph::LineNode;
+
+namespace bin = shared::linegraph::bin;
+
+namespace {
+
+// _____________________________________________________________________________
+class StrTable {
+ public:
+  size_t get(const std::string& str) {
+    auto i = _idx.find(str);
+    if (i != _idx.end()) return i->second;
+    _idx[str] = _strs.size();
+    _strs.push_back(str);
+    return _strs.size() - 1;
+  }
+
+  const std::vector<std::string>& strs() const { return _strs; }
+
+ private:
+  std::unordered_map<std::string, size_t> _idx;
+  std::vector<std::string> _strs;
+};
+
+}  // namespace
+
+// _____________________________________________________________________________
+void BinGraphOutput::print(const LineGraph& g, std::ostream& str) {
+  print(g, str, util::json::Null());
+}
+
+// _____________________________________________________________________________
+void BinGraphOutput::print(const LineGraph& g, std::ostream& str,
+                           util::json::Val attrs) {
+  double mult = bin::fixedMult(bin::PREC);
+
+  std::unordered_map<const LineNode*, size_t> ndIdx;
+  std::unordered_map<const LineEdge*, size_t> edgIdx;
+  std::unordered_map<const Line*, size_t> lineIdx;
+  std::vector<const LineNode*> nds;
+  std::vector<const LineEdge*> edgs;
+  std::vector<const Line*> lines;
+
+  // same order as the GeoJSON output
+  for (const LineNode* n : g.getNds()) {
+    ndIdx[n] = nds.size();
+    nds.push_back(n);
+  }
+
+  for (const LineNode* n : nds) {
+    for (const LineEdge* e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      edgIdx[e] = edgs.size();
+      edgs.push_back(e);
+      for (const auto& lo : e->pl().getLines()) {
+        if (lineIdx.count(lo.line)) continue;
+        lineIdx[lo.line] = lines.size();
+        lines.push_back(lo.line);
+      }
+    }
+  }
+
+  // lines only referenced by exceptions
+  for (const LineNode* n : nds) {
+    for (const Line* l : n->pl().getLinesNotServed()) {
+      if (lineIdx.count(l)) continue;
+      lineIdx[l] = lines.size();
+      lines.push_back(l);
+    }
+  }
+
+  // the string table must precede everything referencing it, so the body is
+  // written to a buffer first
+  StrTable strs;
+  std::stringbuf body;
+  int64_t x = 0, y = 0;
+
+  bin::writeUInt(&body, lines.size());
+  for (const Line* l : lines) {
+    bin::writeUInt(&body, strs.get(l->id()));
+    bin::writeUInt(&body, strs.get(l->label()));
+    bin::writeUInt(&body, strs.get(l->color()));
+  }
+
+  bin::writeUInt(&body, nds.size());
+  for (const LineNode* n : nds) {
+    int64_t nx = bin::toFixed(n->pl().getGeom()->getX(), mult);
+    int64_t ny = bin::toFixed(n->pl().getGeom()->getY(), mult);
+    bin::writeInt(&body, nx - x);
+    bin::writeInt(&body, ny - y);
+    x = nx;
+    y = ny;
+
+    bin::writeUInt(&body, n->pl().stops().size());
+    for (const auto& st : n->pl().stops()) {
+      bin::writeUInt(&body, strs.get(st.id));
+      bin::writeUInt(&body, strs.get(st.name));
+    }
+  }
+
+  bin::writeUInt(&body, edgs.size());
+  for (const LineEdge* e : edgs) {
+    bin::writeUInt(&body, ndIdx[e->getFrom()]);
+    bin::writeUInt(&body, ndIdx[e->getTo()]);
+    bin::writeUInt(&body, e->pl().dontContract() ? bin::F_DONT_CONTRACT : 0);
+
+    const auto& pl = e->pl().getPolyline().getLine();
+    bin::writeUInt(&body, pl.size());
+    for (const auto& p : pl) {
+      int64_t px = bin::toFixed(p.getX(), mult);
+      int64_t py = bin::toFixed(p.getY(), mult);
+      bin::writeInt(&body, px - x);
+      bin::writeInt(&body, py - y);
+      x = px;
+      y = py;
+    }
+
+    bin::writeUInt(&body, e->pl().getLines().size());
+    for (const auto& lo : e->pl().getLines()) {
+      bin::writeUInt(&body, lineIdx[lo.line]);
+      bin::writeUInt(&body, lo.direction ? ndIdx[lo.direction] + 1 : 0);
+
+      size_t css = 0, outlineCss = 0;
+      if (!lo.style.isNull()) {
+        if (lo.style.get().getCss().size())
+          css = strs.get(lo.style.get().getCss()) + 1;
+        if (lo.style.get().getOutlineCss().size())
+          outlineCss = strs.get(lo.style.get().getOutlineCss()) + 1;
+      }
+      bin::writeUInt(&body, css);
+      bin::writeUInt(&body, outlineCss);
+    }
+  }
+
+  std::vector<const LineNode*> excNds;
+  for (const LineNode* n : nds) {
+    if (n->pl().getLinesNotServed().size() || n->pl().getConnExc().size())
+      excNds.push_back(n);
+  }
+
+  bin::writeUInt(&body, excNds.size());
+  for (const LineNode* n : excNds) {
+    bin::writeUInt(&body, ndIdx[n]);
+
+    bin::writeUInt(&body, n->pl().getLinesNotServed().size());
+    for (const Line* l : n->pl().getLinesNotServed()) {
+      bin::writeUInt(&body, lineIdx[l]);
+    }
+
+    // exceptions are stored in both directions, write each pair once
+    std::vector<size_t> excs;
+    for (const auto& ro : n->pl().getConnExc()) {
+      if (!lineIdx.count(ro.first)) continue;
+      for (const auto& exFr : ro.second) {
+        for (const LineEdge* exTo : exFr.second) {
+          if (!edgIdx.count(exFr.first) || !edgIdx.count(exTo)) continue;
+          if (edgIdx[exTo] < edgIdx[exFr.first]) continue;
+          excs.push_back(lineIdx[ro.first]);
+          excs.push_back(edgIdx[exFr.first]);
+          excs.push_back(edgIdx[exTo]);
+        }
+      }
+    }
+
+    bin::writeUInt(&body, excs.size() / 3);
+    for (size_t v : excs) bin::writeUInt(&body, v);
+  }
+
+  std::string meta;
+  if (attrs.type != util::json::Val::JSNULL) {
+    std::stringstream ss;
+    util::json::Writer wr(&ss, 10, false);
+    wr.val(attrs);
+    wr.closeAll();
+    meta = ss.str();
+  }
+
+  // written in two chunks, the output stream may be unbuffered
+  std::stringbuf head;
+  head.sputn(bin::MAGIC, 4);
+  head.sputc(static_cast<char>(bin::VERSION));
+  head.sputc(static_cast<char>(bin::PREC));
+  bin::writeStr(&head, meta);
+
+  bin::writeUInt(&head, strs.strs().size());
+  for (const auto& s : strs.strs()) bin::writeStr(&head, s);
+
+  std::streambuf* out = str.rdbuf();
+  const std::string& h = head.str();
+  out->sputn(h.data(), h.size());
+  const std::string& b = body.str();
+  out->sputn(b.data(), b.size());
+  out->pubsync();
+}
@@ -0,0 +1,30 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef SHARED_LINEGRAPH_BINGRAPHOUTPUT_H_
+#define SHARED_LINEGRAPH_BINGRAPHOUTPUT_H_
+
+#include <ostream>
+#include "shared/linegraph/LineGraph.h"
+#include "util/json/Writer.h"
+
+namespace shared {
+namespace linegraph {
+
+// Writes a line graph in the binary format described in BinFormat.h, read
+// by LineGraph::readFromBinary()
+class BinGraphOutput {
+ public:
+  BinGraphOutput() {}
+
+  // print a graph to the provided stream, with optional JSON attributes
+  void print(const LineGraph& g, std::ostream& str);
+  void print(const LineGraph& g, std::ostream& str,
+             util::json::Val attrs);
+};
+
+}  // namespace linegraph
+}  // namespace shared
+
+#endif  // SHARED_LINEGRAPH_BINGRAPHOUTPUT_H_
@@ -2,8 +2,13 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
 #include "3rdparty/json.hpp"
 #include "dot/Parser.h"
+#include "shared/linegraph/BinFormat.h"
 #include "shared/linegraph/LineEdgePL.h"
 #include "shared/linegraph/LineGraph.h"
 #include "shared/linegraph/LineNodePL.h"
@@ -23,9 +28,12 @@ using shared::linegraph::LineNode;
 using shared::linegraph::LineOcc;
 using shared::linegraph::NodeGrid;
 using shared::linegraph::Partner;
+using util::geo::DLine;
 using util::geo::DPoint;
 using util::geo::Point;
 
+namespace bin = shared::linegraph::bin;
+
 // _____________________________________________________________________________
 void LineGraph::readFromDot(std::istream* s, double smooth) {
   UNUSED(smooth);
@@ -145,6 +153,151 @@ void LineGraph::readFromDot(std::istream* s, double smooth) {
   buildGrids();
 }
 
+// _____________________________________________________________________________
+bool LineGraph::isBinary(std::istream* s) {
+  return s->peek() == static_cast<unsigned char>(bin::MAGIC[0]);
+}
+
+// _____________________________________________________________________________
+void LineGraph::readFromBinary(std::istream* s, double smooth) {
+  std::streambuf* in = s->rdbuf();
+
+  char head[6];
+  if (in->sgetn(head, 6) != 6 || std::string(head, 4) != bin::MAGIC)
+    throw std::runtime_error("Not a binary line graph.");
+  int version = static_cast<uint8_t>(head[4]);
+  if (version != bin::VERSION)
+    throw std::runtime_error("Unsupported binary line graph version " +
+                             util::toString(version) + ".");
+
+  double mult = bin::fixedMult(static_cast<uint8_t>(head[5]));
+
+  // metadata is not needed to build the graph
+  bin::readStr(in);
+
+  std::vector<std::string> strs(bin::readUInt(in));
+  for (auto& str : strs) str = bin::readStr(in);
+
+  auto getStr = [&strs](uint64_t i) -> const std::string& {
+    if (i >= strs.size())
+      throw std::runtime_error("Invalid string in binary line graph.");
+    return strs[i];
+  };
+
+  std::vector<const Line*> lines(bin::readUInt(in));
+  for (auto& l : lines) {
+    const std::string& id = getStr(bin::readUInt(in));
+    const std::string& label = getStr(bin::readUInt(in));
+    const std::string& color = getStr(bin::readUInt(in));
+
+    l = getLine(id);
+    if (!l) {
+      l = new Line(id, label, color);
+      addLine(l);
+    }
+  }
+
+  auto getLn = [&lines](uint64_t i) {
+    if (i >= lines.size())
+      throw std::runtime_error("Invalid line in binary line graph.");
+    return lines[i];
+  };
+
+  _bbox = util::geo::Box<double>();
+
+  int64_t x = 0, y = 0;
+
+  std::vector<LineNode*> nds(bin::readUInt(in));
+  for (auto& n : nds) {
+    x += bin::readInt(in);
+    y += bin::readInt(in);
+    n = addNd(DPoint(x / mult, y / mult));
+    expandBBox(*n->pl().getGeom());
+
+    size_t numStats = bin::readUInt(in);
+    for (size_t i = 0; i < numStats; i++) {
+      const std::string& id = getStr(bin::readUInt(in));
+      const std::string& name = getStr(bin::readUInt(in));
+      n->pl().addStop(Station(id, name, *n->pl().getGeom()));
+    }
+  }
+
+  auto getNd = [&nds](uint64_t i) {
+    if (i >= nds.size())
+      throw std::runtime_error("Invalid node in binary line graph.");
+    return nds[i];
+  };
+
+  std::vector<LineEdge*> edgs(bin::readUInt(in));
+  for (auto& e : edgs) {
+    LineNode* from = getNd(bin::readUInt(in));
+    LineNode* to = getNd(bin::readUInt(in));
+    uint64_t flags = bin::readUInt(in);
+
+    PolyLine<double> pl;
+    size_t numPts = bin::readUInt(in);
+    for (size_t i = 0; i < numPts; i++) {
+      x += bin::readInt(in);
+      y += bin::readInt(in);
+      Point<double> p(x / mult, y / mult);
+      pl << p;
+      expandBBox(p);
+    }
+
+    pl.applyChaikinSmooth(smooth);
+
+    e = addEdg(from, to, pl);
+    if (flags & bin::F_DONT_CONTRACT) e->pl().setDontContract(true);
+
+    size_t numOccs = bin::readUInt(in);
+    for (size_t i = 0; i < numOccs; i++) {
+      const Line* l = getLn(bin::readUInt(in));
+      uint64_t dir = bin::readUInt(in);
+      uint64_t css = bin::readUInt(in);
+      uint64_t outlineCss = bin::readUInt(in);
+
+      LineNode* dirNd = dir ? getNd(dir - 1) : 0;
+
+      if (css || outlineCss) {
+        shared::style::LineStyle ls;
+        if (css) ls.setCss(getStr(css - 1));
+        if (outlineCss) ls.setOutlineCss(getStr(outlineCss - 1));
+        e->pl().addLine(l, dirNd, ls);
+      } else {
+        e->pl().addLine(l, dirNd);
+      }
+    }
+  }
+
+  auto getEdg = [&edgs](uint64_t i) {
+    if (i >= edgs.size())
+      throw std::runtime_error("Invalid edge in binary line graph.");
+    return edgs[i];
+  };
+
+  size_t numExcNds = bin::readUInt(in);
+  for (size_t i = 0; i < numExcNds; i++) {
+    LineNode* n = getNd(bin::readUInt(in));
+
+    size_t numNotServed = bin::readUInt(in);
+    for (size_t j = 0; j < numNotServed; j++) {
+      n->pl().addLineNotServed(getLn(bin::readUInt(in)));
+    }
+
+    size_t numExcs = bin::readUInt(in);
+    for (size_t j = 0; j < numExcs; j++) {
+      const Line* l = getLn(bin::readUInt(in));
+      LineEdge* a = getEdg(bin::readUInt(in));
+      LineEdge* b = getEdg(bin::readUInt(in));
+      n->pl().addConnExc(l, a, b);
+    }
+  }
+
+  _bbox = util::geo::pad(_bbox, 100);
+
+  buildGrids();
+}
+
 // _____________________________________________________________________________
 void LineGraph::readFromTopoJson(nlohmann::json::array_t objects,
                                  nlohmann::json::array_t arcs, double smooth) {
@@ -159,221 +312,300 @@ void LineGraph::readFromGeoJson(nlohmann::json::array_t features,
                                 double smooth) {
   _bbox = util::geo::Box<double>();
 
-  std::map<std::string, LineNode*> idMap;
+  GeoJsonReadState st;
 
-  for (auto feature : features) {
-    auto props = feature["properties"];
-    auto geom = feature["geometry"];
-    if (geom["type"] == "Point") {
-      std::string id = props["id"].get<std::string>();
+  for (auto& feature : features) readGeoJsonFeature(&feature, smooth, &st);
 
-      std::vector<double> coords = geom["coordinates"];
+  finishGeoJson(smooth, &st);
+}
 
-      LineNode* n = addNd(util::geo::DPoint(coords[0], coords[1]));
-      expandBBox(*n->pl().getGeom());
+// _____________________________________________________________________________
+void LineGraph::readGeoJsonFeature(nlohmann::json* feature, double smooth,
+                                   GeoJsonReadState* st) {
+  auto& geom = (*feature)["geometry"];
+  if (geom["type"] == "Point") {
+    readGeoJsonNd(feature, st);
+  } else if (geom["type"] == "LineString") {
+    // edges are usually written after their nodes, only keep those
+    // which cannot be resolved yet
+    if (!readGeoJsonEdg(feature, smooth, false, st)) {
+      st->edgs.push_back(std::move(*feature));
+    }
+  }
+}
 
-      Station i("", "", *n->pl().getGeom());
-      if (!props["station_id"].is_null() || !props["station_label"].is_null()) {
-        if (!props["station_id"].is_null()) {
-          if (props["station_id"].type() == nlohmann::json::value_t::string) {
-            i.id = props["station_id"].get<std::string>();
-          } else {
-            i.id = props["station_id"].get<std::string>();
-          }
-        }
-        if (!props["station_label"].is_null()) i.name = props["station_label"];
-        n->pl().addStop(i);
-      }
+// _____________________________________________________________________________
+void LineGraph::finishGeoJson(double smooth, GeoJsonReadState* st) {
+  for (auto& feature : st->edgs) readGeoJsonEdg(&feature, smooth, true, st);
+  for (auto& props : st->excs) readGeoJsonExcs(&props, st);
+
+  _bbox = util::geo::pad(_bbox, 100);
+
+  buildGrids();
+}
 
-      idMap[id] = n;
+// _____________________________________________________________________________
+void LineGraph::readGeoJsonNd(nlohmann::json* feature, GeoJsonReadState* st) {
+  auto& props = (*feature)["properties"];
+  auto& geom = (*feature)["geometry"];
+
+  std::string id = props["id"].get<std::string>();
+
+  const auto& coords = geom["coordinates"];
+
+  LineNode* n = addNd(
+      util::geo::DPoint(coords[0].get<double>(), coords[1].get<double>()));
+  expandBBox(*n->pl().getGeom());
+
+  Station i("", "", *n->pl().getGeom());
+  if (!props["station_id"].is_null() || !props["station_label"].is_null()) {
+    if (!props["station_id"].is_null()) {
+      i.id = props["station_id"].get<std::string>();
     }
+    if (!props["station_label"].is_null()) i.name = props["station_label"];
+    n->pl().addStop(i);
   }
 
-  // second pass, edges
-  for (auto feature : features) {
-    auto props = feature["properties"];
-    auto geom = feature["geometry"];
-    if (geom["type"] == "LineString") {
-      if (props["lines"].is_null() || props["lines"].size() == 0) continue;
-      std::string from = props["from"].get<std::string>();
-      std::string to = props["to"].get<std::string>();
+  st->idMap[id] = n;
 
-      std::vector<std::vector<double>> coords = geom["coordinates"];
+  // exceptions reference edges, they are added after all edges were read
+  if (!props["not_serving"].is_null() ||
+      !props["excluded_line_conns"].is_null()) {
+    nlohmann::json excs;
+    excs["id"] = id;
+    excs["not_serving"] = std::move(props["not_serving"]);
+    excs["excluded_line_conns"] = std::move(props["excluded_line_conns"]);
+    st->excs.push_back(std::move(excs));
+  }
+}
 
-      PolyLine<double> pl;
-      for (auto coord : coords) {
-        double x = coord[0], y = coord[1];
-        Point<double> p(x, y);
-        pl << p;
-        expandBBox(p);
+// _____________________________________________________________________________
+bool LineGraph::readGeoJsonEdg(nlohmann::json* feature, double smooth,
+                               bool force, GeoJsonReadState* st) {
+  auto& props = (*feature)["properties"];
+  auto& geom = (*feature)["geometry"];
+
+  if (props["lines"].is_null() || props["lines"].size() == 0) return true;
+  std::string from = props["from"].get<std::string>();
+  std::string to = props["to"].get<std::string>();
+
+  if (!force) {
+    if (from.size() && !st->idMap.count(from)) return false;
+    if (to.size() && !st->idMap.count(to)) return false;
+    for (const auto& line : props["lines"]) {
+      if (line.contains("direction") && !line["direction"].is_null() &&
+          !st->idMap.count(line["direction"].get<std::string>())) {
+        return false;
       }
+    }
+  }
 
-      pl.applyChaikinSmooth(smooth);
+  PolyLine<double> pl;
+  for (const auto& coord : geom["coordinates"]) {
+    double x = coord[0], y = coord[1];
+    Point<double> p(x, y);
+    pl << p;
+    expandBBox(p);
+  }
 
-      LineNode* fromN = 0;
-      LineNode* toN = 0;
+  pl.applyChaikinSmooth(smooth);
 
-      if (from.size()) {
-        fromN = idMap[from];
-        if (!fromN) {
-          LOG(ERROR) << "Node \"" << from << "\" not found." << std::endl;
-          continue;
-        }
-      } else {
-        fromN = addNd(pl.getLine().front());
-      }
+  LineNode* fromN = 0;
+  LineNode* toN = 0;
 
-      if (to.size()) {
-        toN = idMap[to];
-        if (!fromN) {
-          LOG(ERROR) << "Node \"" << to << "\" not found." << std::endl;
-          continue;
-        }
-      } else {
-        fromN = addNd(pl.getLine().back());
-      }
+  if (from.size()) {
+    auto it = st->idMap.find(from);
+    if (it == st->idMap.end()) {
+      LOG(ERROR) << "Node \"" << from << "\" not found." << std::endl;
+      return true;
+    }
+    fromN = it->second;
+  } else {
+    fromN = addNd(pl.getLine().front());
+  }
 
-      LineEdge* e = addEdg(fromN, toN, pl);
+  if (to.size()) {
+    auto it = st->idMap.find(to);
+    if (it == st->idMap.end()) {
+      LOG(ERROR) << "Node \"" << to << "\" not found." << std::endl;
+      return true;
+    }
+    toN = it->second;
+  } else {
+    toN = addNd(pl.getLine().back());
+  }
 
-      if (props["dontcontract"].is_number() && props["dontcontract"].get<int>())
-        e->pl().setDontContract(true);
+  LineEdge* e = addEdg(fromN, toN, pl);
 
-      for (auto line : props["lines"]) {
-        std::string id;
-        if (!line["id"].is_null()) {
-          id = line["id"].get<std::string>();
-        } else if (!line["label"].is_null()) {
-          id = line["label"].get<std::string>();
-        } else if (!line["color"].is_null()) {
-          id = line["color"].get<std::string>();
-        } else
-          continue;
-
-        const Line* l = getLine(id);
-        if (!l) {
-          std::string label = line["label"].is_null() ? "" : line["label"];
-          std::string color = line["color"];
-          l = new Line(id, label, color);
-          addLine(l);
-        }
+  if (props["dontcontract"].is_number() && props["dontcontract"].get<int>())
+    e->pl().setDontContract(true);
 
-        LineNode* dir = 0;
+  for (auto& line : props["lines"]) {
+    std::string id;
+    if (!line["id"].is_null()) {
+      id = line["id"].get<std::string>();
+    } else if (!line["label"].is_null()) {
+      id = line["label"].get<std::string>();
+    } else if (!line["color"].is_null()) {
+      id = line["color"].get<std::string>();
+    } else
+      continue;
 
-        if (!line["direction"].is_null()) {
-          dir = idMap[line["direction"].get<std::string>()];
-        }
+    const Line* l = getLine(id);
+    if (!l) {
+      std::string label = line["label"].is_null() ? "" : line["label"];
+      std::string color = line["color"];
+      l = new Line(id, label, color);
+      addLine(l);
+    }
 
-        if (!line["style"].is_null() || !line["outline-style"].is_null()) {
-          shared::style::LineStyle ls;
+    LineNode* dir = 0;
 
-          if (!line["style"].is_null()) ls.setCss(line["style"]);
-          if (!line["outline-style"].is_null())
-            ls.setOutlineCss(line["outline-style"]);
+    if (!line["direction"].is_null()) {
+      auto it = st->idMap.find(line["direction"].get<std::string>());
+      if (it != st->idMap.end()) dir = it->second;
+    }
 
-          e->pl().addLine(l, dir, ls);
-        } else {
-          e->pl().addLine(l, dir);
-        }
-      }
+    if (!line["style"].is_null() || !line["outline-style"].is_null()) {
+      shared::style::LineStyle ls;
+
+      if (!line["style"].is_null()) ls.setCss(line["style"]);
+      if (!line["outline-style"].is_null())
+        ls.setOutlineCss(line["outline-style"]);
+
+      e->pl().addLine(l, dir, ls);
+    } else {
+      e->pl().addLine(l, dir);
     }
   }
 
-  // third pass, exceptions (TODO: do this in the first part, store in some
-  // data structure, add here!)
-  for (auto feature : features) {
-    auto props = feature["properties"];
-    auto geom = feature["geometry"];
-    if (geom["type"] == "Point") {
-      std::string id = props["id"].get<std::string>();
+  return true;
+}
 
-      if (!idMap.count(id)) continue;
-      LineNode* n = idMap[id];
+// _____________________________________________________________________________
+void LineGraph::readGeoJsonExcs(nlohmann::json* props, GeoJsonReadState* st) {
+  std::string id = (*props)["id"].get<std::string>();
 
-      if (!props["not_serving"].is_null()) {
-        for (auto excl : props["not_serving"]) {
-          std::string lid = excl.get<std::string>();
+  if (!st->idMap.count(id)) return;
+  LineNode* n = st->idMap[id];
 
-          const Line* r = getLine(lid);
+  if (!(*props)["not_serving"].is_null()) {
+    for (const auto& excl : (*props)["not_serving"]) {
+      std::string lid = excl.get<std::string>();
 
-          if (!r) {
-            LOG(WARN) << "line " << lid << " marked as not served in in node "
-                      << id << ", but no such line exists.";
-            continue;
-          }
+      const Line* r = getLine(lid);
 
-          n->pl().addLineNotServed(r);
-        }
+      if (!r) {
+        LOG(WARN) << "line " << lid << " marked as not served in in node "
+                  << id << ", but no such line exists.";
+        continue;
       }
 
-      if (!props["excluded_line_conns"].is_null()) {
-        for (auto excl : props["excluded_line_conns"]) {
-          std::string lid = excl["route"].get<std::string>();
-          std::string nid1 = excl["edge1_node"].get<std::string>();
-          std::string nid2 = excl["edge2_node"].get<std::string>();
+      n->pl().addLineNotServed(r);
+    }
+  }
 
-          const Line* r = getLine(lid);
+  if (!(*props)["excluded_line_conns"].is_null()) {
+    for (const auto& excl : (*props)["excluded_line_conns"]) {
+      std::string lid = excl["route"].get<std::string>();
+      std::string nid1 = excl["edge1_node"].get<std::string>();
+      std::string nid2 = excl["edge2_node"].get<std::string>();
 
-          if (!r) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for line " << lid << ", but no such line exists.";
-            continue;
-          }
+      const Line* r = getLine(lid);
 
-          if (!idMap.count(nid1)) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid1
-                      << ", but no such node exists.";
-            continue;
-          }
+      if (!r) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for line " << lid << ", but no such line exists.";
+        continue;
+      }
 
-          if (!idMap.count(nid2)) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid2
-                      << ", but no such node exists.";
-            continue;
-          }
+      if (!st->idMap.count(nid1)) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid1 << ", but no such node exists.";
+        continue;
+      }
 
-          LineNode* n1 = idMap[nid1];
-          LineNode* n2 = idMap[nid2];
+      if (!st->idMap.count(nid2)) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid2 << ", but no such node exists.";
+        continue;
+      }
 
-          LineEdge* a = getEdg(n, n1);
-          LineEdge* b = getEdg(n, n2);
+      LineNode* n1 = st->idMap[nid1];
+      LineNode* n2 = st->idMap[nid2];
 
-          if (!a) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid1
-                      << ", but no such edge exists.";
-            continue;
-          }
+      LineEdge* a = getEdg(n, n1);
+      LineEdge* b = getEdg(n, n2);
 
-          if (!b) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid2
-                      << ", but no such edge exists.";
-            continue;
-          }
+      if (!a) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid1 << ", but no such edge exists.";
+        continue;
+      }
 
-          n->pl().addConnExc(r, a, b);
-        }
+      if (!b) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid2 << ", but no such edge exists.";
+        continue;
       }
+
+      n->pl().addConnExc(r, a, b);
     }
   }
-
-  _bbox = util::geo::pad(_bbox, 100);
-
-  buildGrids();
 }
 
 // _____________________________________________________________________________
 void LineGraph::readFromJson(std::istream* s, double smooth) {
-  nlohmann::json j;
-  (*s) >> j;
+  _bbox = util::geo::Box<double>();
 
-  if (j["type"] == "FeatureCollection") readFromGeoJson(j["features"], smooth);
+  GeoJsonReadState st;
+  std::string key;
+  size_t feats = 0;
+
+  // features are handed to the graph as soon as they are parsed and then
+  // dropped from the document, so the full DOM is never materialized
+  nlohmann::json::parser_callback_t cb =
+      [&](int depth, nlohmann::json::parse_event_t ev, nlohmann::json& parsed) {
+        if (depth == 1 && ev == nlohmann::json::parse_event_t::key) {
+          key = parsed.get<std::string>();
+        } else if (depth == 2 && key == "features" &&
+                   ev == nlohmann::json::parse_event_t::object_end) {
+          readGeoJsonFeature(&parsed, smooth, &st);
+          feats++;
+          return false;
+        }
+        return true;
+      };
+
+  nlohmann::json j = nlohmann::json::parse(*s, cb);
+
+  if (j["type"] == "FeatureCollection" || feats) finishGeoJson(smooth, &st);
   if (j["type"] == "Topology")
     readFromTopoJson(j["objects"], j["arcs"], smooth);
 }
 
+// _____________________________________________________________________________
+void LineGraph::readFromGraph(LineGraph&& other, double smooth) {
+  *this = std::move(other);
+
+  _bbox = util::geo::Box<double>();
+
+  for (auto n : getNds()) {
+    expandBBox(*n->pl().getGeom());
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      auto pl = e->pl().getPolyline();
+      pl.applyChaikinSmooth(smooth);
+      e->pl().setPolyline(pl);
+      for (const auto& p : pl.getLine()) expandBBox(p);
+    }
+  }
+
+  _bbox = util::geo::pad(_bbox, 100);
+
+  buildGrids();
+}
+
 // _____________________________________________________________________________
 void LineGraph::buildGrids() {
   size_t gridSize =
@@ -390,6 +622,9 @@ void LineGraph::buildGrids() {
       _edgeGrid.add(*e->pl().getGeom(), e);
     }
   }
+
+  _nodeGrid.compact();
+  _edgeGrid.compact();
 }
 
 // _____________________________________________________________________________
@@ -402,49 +637,106 @@ const util::geo::DBox& LineGraph::getBBox() const { return _bbox; }
 
 // _____________________________________________________________________________
 void LineGraph::topologizeIsects() {
-  proced.clear();
-  while (getNextIntersection().a) {
-    auto i = getNextIntersection();
-    auto x = addNd(i.bp.p);
-
-    double pa = i.a->pl().getPolyline().projectOn(i.bp.p).totalPos;
+  auto isects = getIsects();
+  if (isects.empty()) return;
+
+  // crossings at (almost) the same position of an edge share a single node,
+  // these are found with a union-find over the crossings
+  std::vector<size_t> rep(isects.size());
+  for (size_t i = 0; i < rep.size(); i++) rep[i] = i;
+  auto find = [&rep](size_t i) {
+    while (rep[i] != i) i = rep[i] = rep[rep[i]];
+    return i;
+  };
+
+  // the crossings on each edge, as (position, crossing)
+  std::vector<LineEdge*> edgs;
+  std::vector<std::vector<std::pair<double, size_t>>> splits;
+  std::unordered_map<const LineEdge*, size_t> edgIds;
+
+  for (size_t i = 0; i < isects.size(); i++) {
+    for (auto ep : {std::make_pair(isects[i].a, isects[i].posA),
+                    std::make_pair(isects[i].b, isects[i].posB)}) {
+      auto id = edgIds.insert({ep.first, edgs.size()});
+      if (id.second) {
+        edgs.push_back(ep.first);
+        splits.push_back({});
+      }
+      splits[id.first->second].push_back({ep.second, i});
+    }
+  }
 
-    auto ba = addEdg(i.b->getFrom(), x, i.b->pl());
-    ba->pl().setPolyline(i.b->pl().getPolyline().getSegment(0, i.bp.totalPos));
+  for (auto& s : splits) {
+    std::sort(s.begin(), s.end());
+    for (size_t j = 1; j < s.size(); j++) {
+      if (s[j].first - s[j - 1].first < 0.001) {
+        rep[find(s[j].second)] = find(s[j - 1].second);
+      }
+    }
+  }
 
-    auto bb = addEdg(x, i.b->getTo(), i.b->pl());
-    bb->pl().setPolyline(i.b->pl().getPolyline().getSegment(i.bp.totalPos, 1));
+  std::vector<LineNode*> nds(isects.size(), 0);
+  for (size_t i = 0; i < isects.size(); i++) {
+    if (find(i) != i) continue;
+    nds[i] = addNd(isects[i].p);
+    _nodeGrid.add(*nds[i]->pl().getGeom(), nds[i]);
+  }
 
-    edgeRpl(i.b->getFrom(), i.b, ba);
-    edgeRpl(i.b->getTo(), i.b, bb);
+  // split each crossed edge into pieces between its crossing nodes
+  for (size_t i = 0; i < edgs.size(); i++) {
+    auto e = edgs[i];
+    auto from = e->getFrom();
+    auto to = e->getTo();
+
+    std::vector<std::pair<double, LineNode*>> ends;
+    for (auto s : splits[i]) {
+      auto nd = nds[find(s.second)];
+      if (ends.size() && ends.back().second == nd) continue;
+      ends.push_back({s.first, nd});
+    }
+    ends.push_back({1, to});
 
-    nodeRpl(ba, i.b->getTo(), x);
-    nodeRpl(bb, i.b->getFrom(), x);
+    LineNode* prevNd = from;
+    double prevPos = 0;
+    LineEdge* first = 0;
+    LineEdge* last = 0;
 
-    _edgeGrid.add(*ba->pl().getGeom(), ba);
-    _edgeGrid.add(*bb->pl().getGeom(), bb);
+    for (auto end : ends) {
+      if (end.second == prevNd) continue;
+      auto piece = getEdg(prevNd, end.second);
+      if (!piece) {
+        piece = addEdg(prevNd, end.second, e->pl());
+        piece->pl().setPolyline(
+            e->pl().getPolyline().getSegment(prevPos, end.first));
 
-    auto aa = addEdg(i.a->getFrom(), x, i.a->pl());
-    aa->pl().setPolyline(i.a->pl().getPolyline().getSegment(0, pa));
-    auto ab = addEdg(x, i.a->getTo(), i.a->pl());
-    ab->pl().setPolyline(i.a->pl().getPolyline().getSegment(pa, 1));
+        nodeRpl(piece, to, end.second);
+        nodeRpl(piece, from, prevNd);
 
-    edgeRpl(i.a->getFrom(), i.a, aa);
-    edgeRpl(i.a->getTo(), i.a, ab);
+        _edgeGrid.add(*piece->pl().getGeom(), piece);
+      } else {
+        // another crossed edge already runs between these nodes
+        for (auto lo : e->pl().getLines()) {
+          if (piece->pl().hasLine(lo.line)) continue;
+          const LineNode* dir = 0;
+          if (lo.direction == to) dir = end.second;
+          if (lo.direction == from) dir = prevNd;
+          piece->pl().addLine(lo.line, dir, lo.style);
+        }
+      }
 
-    nodeRpl(aa, i.b->getTo(), x);
-    nodeRpl(ab, i.b->getFrom(), x);
+      if (!first) first = piece;
+      last = piece;
+      prevNd = end.second;
+      prevPos = end.first;
+    }
 
-    _edgeGrid.add(*aa->pl().getGeom(), aa);
-    _edgeGrid.add(*ab->pl().getGeom(), ab);
+    edgeRpl(from, e, first);
+    edgeRpl(to, e, last);
 
-    _edgeGrid.remove(i.a);
-    _edgeGrid.remove(i.b);
+    _edgeGrid.remove(e);
 
-    assert(getEdg(i.a->getFrom(), i.a->getTo()));
-    assert(getEdg(i.b->getFrom(), i.b->getTo()));
-    delEdg(i.a->getFrom(), i.a->getTo());
-    delEdg(i.b->getFrom(), i.b->getTo());
+    assert(getEdg(from, to));
+    delEdg(from, to);
   }
 }
 
@@ -458,46 +750,109 @@ std::set<LineEdge*> LineGraph::getNeighborEdges(const util::geo::DLine& line,
 }
 
 // _____________________________________________________________________________
-ISect LineGraph::getNextIntersection() {
-  for (auto n1 : getNds()) {
-    for (auto e1 : n1->getAdjList()) {
-      if (e1->getFrom() != n1) continue;
-      if (proced.find(e1) != proced.end()) continue;
-
-      std::set<LineEdge*> neighbors;
-      _edgeGrid.getNeighbors(e1, 0, &neighbors);
-
-      for (auto e2 : neighbors) {
-        if (proced.find(e2) != proced.end()) continue;
-        if (e1 != e2) {
-          auto is =
-              e1->pl().getPolyline().getIntersections(e2->pl().getPolyline());
-
-          if (is.size()) {
-            ISect ret;
-            ret.a = e1;
-            ret.b = e2;
-            ret.bp = *is.begin();
-            // if the intersection is near a shared node, ignore
-            auto shrdNd = sharedNode(e1, e2);
-            if (shrdNd &&
-                util::geo::dist(*shrdNd->pl().getGeom(), ret.bp.p) < 100) {
-              continue;
-            }
-
-            if (ret.bp.totalPos > 0.001 && 1 - ret.bp.totalPos > 0.001) {
-              return ret;
-            }
-          }
+std::vector<ISect> LineGraph::getIsects() const {
+  std::vector<ISect> ret;
+
+  std::vector<LineEdge*> edgs;
+  std::vector<double> lens;
+
+  // all non-degenerated segments, with their edge and the distance of their
+  // start along the edge
+  std::vector<util::geo::LineSegment<double>> segs;
+  std::vector<size_t> segEdgs;
+  std::vector<double> segPos;
+
+  util::geo::DBox box;
+  double totLen = 0;
+
+  for (auto n : getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      const auto& geom = *e->pl().getGeom();
+      double len = 0;
+      for (size_t i = 1; i < geom.size(); i++) {
+        double d = util::geo::dist(geom[i - 1], geom[i]);
+        if (d > 0) {
+          segs.push_back({geom[i - 1], geom[i]});
+          segEdgs.push_back(edgs.size());
+          segPos.push_back(len);
         }
+        len += d;
+      }
+      box = util::geo::extendBox(geom, box);
+      totLen += len;
+      edgs.push_back(e);
+      lens.push_back(len);
+    }
+  }
+
+  if (segs.empty()) return ret;
+
+  // cells of about the average segment length, but not more cells than
+  // segments
+  double w = std::max(box.getUpperRight().getX() - box.getLowerLeft().getX(),
+                      box.getUpperRight().getY() - box.getLowerLeft().getY());
+  double cell = std::max(totLen / segs.size(), w / std::sqrt(segs.size()));
+
+  util::geo::FlatGrid<size_t, util::geo::Line, double> grid(
+      cell, cell, util::geo::pad(box, cell), false);
+  for (size_t i = 0; i < segs.size(); i++)
+    grid.add(DLine{segs[i].first, segs[i].second}, i);
+  grid.compact();
+
+  // candidate crossings per pair of edges
+  std::map<std::pair<size_t, size_t>, std::vector<ISect>> cands;
+
+  for (size_t i = 0; i < segs.size(); i++) {
+    const auto& s = segs[i];
+    grid.visit(util::geo::getBoundingBox(DLine{s.first, s.second}),
+               [&](size_t j) {
+                 size_t ea = segEdgs[i], eb = segEdgs[j];
+                 if (eb <= ea) return;
+                 const auto& t = segs[j];
+                 if (!util::geo::intersects(s.first, s.second, t.first,
+                                            t.second))
+                   return;
+                 auto p = util::geo::intersection(s.first, s.second, t.first,
+                                                  t.second);
+                 ISect is;
+                 is.a = edgs[ea];
+                 is.b = edgs[eb];
+                 is.posA = (segPos[i] + util::geo::dist(s.first, p)) / lens[ea];
+                 is.posB = (segPos[j] + util::geo::dist(t.first, p)) / lens[eb];
+                 is.p = p;
+                 cands[{ea, eb}].push_back(is);
+               });
+  }
+
+  for (auto& c : cands) {
+    auto& is = c.second;
+    std::sort(is.begin(), is.end(), [](const ISect& x, const ISect& y) {
+      return x.posB < y.posB;
+    });
+
+    auto shrdNd = sharedNode(is.front().a, is.front().b);
+    size_t first = ret.size();
+
+    for (const auto& i : is) {
+      // crossings at the very ends of an edge are ignored
+      if (i.posA <= 0.001 || 1 - i.posA <= 0.001) continue;
+      if (i.posB <= 0.001 || 1 - i.posB <= 0.001) continue;
+
+      // if the intersection is near a shared node, ignore
+      if (shrdNd && util::geo::dist(*shrdNd->pl().getGeom(), i.p) < 100) {
+        continue;
+      }
+
+      // same for intersections near an earlier crossing of both edges
+      bool near = false;
+      for (size_t j = first; j < ret.size() && !near; j++) {
+        near = util::geo::dist(ret[j].p, i.p) < 100;
       }
-      proced.insert(e1);
+      if (!near) ret.push_back(i);
     }
   }
 
-  ISect ret;
-  ret.a = 0;
-  ret.b = 0;
   return ret;
 }
 
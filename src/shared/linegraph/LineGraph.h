@@ -10,7 +10,7 @@
 #include "shared/linegraph/LineEdgePL.h"
 #include "shared/linegraph/LineNodePL.h"
 #include "util/geo/Geo.h"
-#include "util/geo/Grid.h"
+#include "util/geo/FlatGrid.h"
 #include "util/graph/UndirGraph.h"
 
 namespace shared {
@@ -21,12 +21,26 @@ typedef util::graph::Edge<LineNodePL, LineEdgePL> LineEdge;
 
 typedef std::pair<LineEdge*, LineEdge*> LineEdgePair;
 
-typedef util::geo::Grid<LineNode*, util::geo::Point, double> NodeGrid;
-typedef util::geo::Grid<LineEdge*, util::geo::Line, double> EdgeGrid;
+typedef util::geo::FlatGrid<LineNode*, util::geo::Point, double> NodeGrid;
+typedef util::geo::FlatGrid<LineEdge*, util::geo::Line, double> EdgeGrid;
 
+// crossing of edges a and b in point p, at the relative positions posA on a
+// and posB on b
 struct ISect {
   LineEdge *a, *b;
-  util::geo::LinePoint<double> bp;
+  double posA, posB;
+  util::geo::DPoint p;
+};
+
+// state kept while reading a GeoJSON line graph feature by feature
+struct GeoJsonReadState {
+  std::map<std::string, LineNode*> idMap;
+
+  // edges which reference nodes not read yet
+  std::vector<nlohmann::json> edgs;
+
+  // node properties which reference edges, applied after all edges were read
+  std::vector<nlohmann::json> excs;
 };
 
 struct Partner {
@@ -44,7 +58,6 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
 
   LineGraph(LineGraph&& other) {
     _bbox = other._bbox;
-    proced = other.proced;
     _lines = other._lines;
     _nodeGrid = std::move(other._nodeGrid);
     _edgeGrid = std::move(other._edgeGrid);
@@ -55,7 +68,6 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
 
   LineGraph& operator=(LineGraph&& other) {
     _bbox = other._bbox;
-    proced = other.proced;
     _lines = other._lines;
     _nodeGrid = std::move(other._nodeGrid);
     _edgeGrid = std::move(other._edgeGrid);
@@ -66,12 +78,24 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
   }
 
   virtual void readFromJson(std::istream* s, double smooth);
-  virtual void readFromGeoJson(nlohmann::json::array_t, double smooth);
+  virtual void readFromGeoJson(nlohmann::json::array_t features,
+                               double smooth);
   virtual void readFromTopoJson(nlohmann::json::array_t objects,
                                 nlohmann::json::array_t arc, double smooth);
   virtual void readFromDot(std::istream* s, double smooth);
+  virtual void readFromBinary(std::istream* s, double smooth);
+
+  // take over a graph built in the same process, as if it had been written
+  // and read back with the given smoothing. This graph must be empty.
+  virtual void readFromGraph(LineGraph&& other, double smooth);
+
+  // true if the stream holds a line graph in binary format
+  static bool isBinary(std::istream* s);
 
   const util::geo::Box<double>& getBBox() const;
+
+  // split all crossing edges at their crossings, crossings closer than 100
+  // to a node shared by both edges are ignored
   void topologizeIsects();
 
   size_t maxDeg() const;
@@ -147,12 +171,19 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
  private:
   util::geo::Box<double> _bbox;
 
-  ISect getNextIntersection();
+  // all edge crossings, found in a single pass over a segment grid
+  std::vector<ISect> getIsects() const;
 
   void buildGrids();
 
-  // TODO: remove this
-  std::set<LineEdge*> proced;
+  void readGeoJsonFeature(nlohmann::json* feature, double smooth,
+                          GeoJsonReadState* st);
+  void readGeoJsonNd(nlohmann::json* feature, GeoJsonReadState* st);
+  bool readGeoJsonEdg(nlohmann::json* feature, double smooth, bool force,
+                      GeoJsonReadState* st);
+  void readGeoJsonExcs(nlohmann::json* props, GeoJsonReadState* st);
+  void finishGeoJson(double smooth, GeoJsonReadState* st);
+
   std::map<std::string, const Line*> _lines;
 
   NodeGrid _nodeGrid;
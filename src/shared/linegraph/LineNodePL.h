@@ -89,6 +89,7 @@ class LineNodePL : util::geograph::GeoNodePL<double> {
 
   void addLineNotServed(const Line* r);
   bool lineServed(const Line* r) const;
+  const NotServedLines& getLinesNotServed() const { return _notServed; }
 
   void clearConnExc();
 
@@ -16,6 +16,7 @@
 #include "OsiSolverInterface.hpp"
 
 #include "shared/optim/COINSolver.h"
+#include "shared/optim/ILPModel.h"
 #include "util/Misc.h"
 #include "util/String.h"
 #include "util/log/Log.h"
@@ -138,6 +139,40 @@ int COINSolver::addRow(const std::string& name, double bnd, RowType rowType) {
   return rowId;
 }
 
+// _____________________________________________________________________________
+void COINSolver::load(const ILPModel& m) {
+  int colOffset = getNumVars();
+
+  for (size_t i = 0; i < m.getNumCols(); i++) {
+    const auto& c = m.getCol(i);
+    double lo = c.bounded ? c.lowBnd : -COIN_DBL_MAX;
+    double up = c.bounded ? c.upBnd : COIN_DBL_MAX;
+    if (c.type == BIN) {
+      lo = 0.0;
+      up = 1.0;
+    }
+    _model.addCol(0, NULL, NULL, lo, up, c.objCoef,
+                  m.hasNames() ? m.getColName(i).c_str() : NULL,
+                  c.type != CONT);
+  }
+
+  // rows are added with all their elements at once, which is much cheaper
+  // than single setElement() calls
+  std::vector<int> beg, ind;
+  std::vector<double> vals;
+  m.getCompressed(true, &beg, &ind, &vals);
+  for (auto& col : ind) col += colOffset;
+
+  for (size_t i = 0; i < m.getNumRows(); i++) {
+    const auto& r = m.getRow(i);
+    double lo = r.type == UP ? -COIN_DBL_MAX : r.bnd;
+    double up = r.type == LO ? COIN_DBL_MAX : r.bnd;
+    _model.addRow(beg[i + 1] - beg[i], ind.data() + beg[i],
+                  vals.data() + beg[i], lo, up,
+                  m.hasNames() ? m.getRowName(i).c_str() : NULL);
+  }
+}
+
 // _____________________________________________________________________________
 void COINSolver::addColToRow(const std::string& rowName,
                              const std::string& colName, double coef) {
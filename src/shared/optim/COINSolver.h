@@ -31,6 +31,8 @@ class COINSolver : public ILPSolver {
              double lowBnd, double upBnd);
   int addRow(const std::string& name, double bnd, RowType rowType);
 
+  void load(const ILPModel& m);
+
   void addColToRow(const std::string& rowName, const std::string& colName,
                    double coef);
   void addColToRow(int rowId, int colId, double coef);
@@ -9,6 +9,7 @@
 #include <sstream>
 #include <stdexcept>
 #include "shared/optim/GLPKSolver.h"
+#include "shared/optim/ILPModel.h"
 #include "util/Misc.h"
 #include "util/String.h"
 #include "util/log/Log.h"
@@ -50,22 +51,9 @@ GLPKSolver::~GLPKSolver() {
 // _____________________________________________________________________________
 int GLPKSolver::addCol(const std::string& name, ColType colType,
                        double objCoef) {
-  int vtype = 0;
-  switch (colType) {
-    case INT:
-      vtype = GLP_IV;
-      break;
-    case BIN:
-      vtype = GLP_BV;
-      break;
-    case CONT:
-      vtype = GLP_CV;
-      break;
-  }
-
   int col = glp_add_cols(_prob, 1);
   glp_set_col_name(_prob, col, name.c_str());
-  glp_set_col_kind(_prob, col, vtype);
+  glp_set_col_kind(_prob, col, getColKind(colType));
   glp_set_obj_coef(_prob, col, objCoef);
 
   return col - 1;
@@ -74,47 +62,100 @@ int GLPKSolver::addCol(const std::string& name, ColType colType,
 // _____________________________________________________________________________
 int GLPKSolver::addCol(const std::string& name, ColType colType, double objCoef,
                        double lowBnd, double upBnd) {
-  int rtype = 0;
+  int col = addCol(name, colType, objCoef);
+  glp_set_col_bnds(_prob, col + 1, getBndType(lowBnd, upBnd), lowBnd, upBnd);
+
+  return col;
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::addRow(const std::string& name, double bnd, RowType rowType) {
+  int row = glp_add_rows(_prob, 1);
+  assert(row);
+  glp_set_row_name(_prob, row, name.c_str());
+  glp_set_row_bnds(_prob, row, getRowType(rowType), bnd, bnd);
+
+  return row - 1;
+}
+
+// _____________________________________________________________________________
+void GLPKSolver::load(const ILPModel& m) {
+  int colOffset = getNumVars();
+  int rowOffset = getNumConstrs();
+
+  if (m.getNumCols()) glp_add_cols(_prob, m.getNumCols());
+  if (m.getNumRows()) glp_add_rows(_prob, m.getNumRows());
+
+  for (size_t i = 0; i < m.getNumCols(); i++) {
+    const auto& c = m.getCol(i);
+    int col = colOffset + i + 1;
+    if (m.hasNames()) glp_set_col_name(_prob, col, m.getColName(i).c_str());
+    glp_set_col_kind(_prob, col, getColKind(c.type));
+    glp_set_obj_coef(_prob, col, c.objCoef);
+    if (c.bounded) {
+      glp_set_col_bnds(_prob, col, getBndType(c.lowBnd, c.upBnd), c.lowBnd,
+                       c.upBnd);
+    }
+  }
+
+  for (size_t i = 0; i < m.getNumRows(); i++) {
+    const auto& r = m.getRow(i);
+    int row = rowOffset + i + 1;
+    if (m.hasNames()) glp_set_row_name(_prob, row, m.getRowName(i).c_str());
+    glp_set_row_bnds(_prob, row, getRowType(r.type), r.bnd, r.bnd);
+  }
+
+  _vm.rowNum.reserve(_vm.rowNum.size() + m.getNumCoefs());
+  _vm.colNum.reserve(_vm.colNum.size() + m.getNumCoefs());
+  _vm.vals.reserve(_vm.vals.size() + m.getNumCoefs());
+
+  for (size_t i = 0; i < m.getNumCoefs(); i++) {
+    addColToRow(rowOffset + m.getCoefRows()[i], colOffset + m.getCoefCols()[i],
+                m.getCoefs()[i]);
+  }
+
+  update();
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::getColKind(ColType colType) {
+  switch (colType) {
+    case INT:
+      return GLP_IV;
+    case BIN:
+      return GLP_BV;
+    case CONT:
+    default:
+      return GLP_CV;
+  }
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::getBndType(double lowBnd, double upBnd) {
   if (lowBnd <= -std::numeric_limits<double>::max() &&
       upBnd >= std::numeric_limits<double>::max()) {
-    rtype = GLP_FR;
+    return GLP_FR;
   } else if (lowBnd <= -std::numeric_limits<double>::max()) {
-    rtype = GLP_UP;
+    return GLP_UP;
   } else if (upBnd >= std::numeric_limits<double>::max()) {
-    rtype = GLP_LO;
+    return GLP_LO;
   } else if (lowBnd == upBnd) {
-    rtype = GLP_FX;
-  } else {
-    rtype = GLP_DB;
+    return GLP_FX;
   }
-
-  int col = addCol(name, colType, objCoef);
-  glp_set_col_bnds(_prob, col + 1, rtype, lowBnd, upBnd);
-
-  return col;
+  return GLP_DB;
 }
 
 // _____________________________________________________________________________
-int GLPKSolver::addRow(const std::string& name, double bnd, RowType rowType) {
-  int rtype = 0;
+int GLPKSolver::getRowType(RowType rowType) {
   switch (rowType) {
     case FIX:
-      rtype = GLP_FX;
-      break;
+      return GLP_FX;
     case UP:
-      rtype = GLP_UP;
-      break;
+      return GLP_UP;
     case LO:
-      rtype = GLP_LO;
-      break;
+    default:
+      return GLP_LO;
   }
-
-  int row = glp_add_rows(_prob, 1);
-  assert(row);
-  glp_set_row_name(_prob, row, name.c_str());
-  glp_set_row_bnds(_prob, row, rtype, bnd, bnd);
-
-  return row - 1;
 }
 
 // _____________________________________________________________________________
@@ -129,7 +170,7 @@ void GLPKSolver::addColToRow(const std::string& rowName,
     LOGTO(ERROR, std::cerr) << "Could not find constraint " << rowName;
   }
 
-  addColToRow(col, row, coef);
+  addColToRow(row, col, coef);
 }
 
 // _____________________________________________________________________________
@@ -307,15 +348,12 @@ int GLPKSolver::getNumVars() const { return glp_get_num_cols(_prob); }
 
 // _____________________________________________________________________________
 void GLPKSolver::setStarter(const StarterSol& starterSol) {
-  _starterArr = new double[getNumVars() + 1];
-
-  size_t a = 0;
+  if (_starterArr) delete[] _starterArr;
+  _starterArr = new double[getNumVars() + 1]();
 
   for (const auto& varVal : starterSol) {
-    int colId = getVarByName(varVal.first);
-    if (colId < 0) continue;
-    _starterArr[colId + 1] = varVal.second;
-    a++;
+    if (varVal.first < 0 || varVal.first >= getNumVars()) continue;
+    _starterArr[varVal.first + 1] = varVal.second;
   }
 }
 
@@ -35,6 +35,8 @@ class GLPKSolver : public ILPSolver {
              double lowBnd, double upBnd);
   int addRow(const std::string& name, double bnd, RowType rowType);
 
+  void load(const ILPModel& m);
+
   void addColToRow(const std::string& rowName, const std::string& colName,
                    double coef);
   void addColToRow(int rowId, int colId, double coef);
@@ -86,6 +88,10 @@ class GLPKSolver : public ILPSolver {
 
   std::string _termBuf;
 
+  static int getColKind(ColType colType);
+  static int getBndType(double lowBnd, double upBnd);
+  static int getRowType(RowType rowType);
+
   static void optCb(glp_tree* tree, void* solver);
   static int termHook(void* info, const char* str);
   static void errorHook(void* info);
@@ -6,8 +6,10 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include "gurobi_c.h"
 #include "shared/optim/GurobiSolver.h"
+#include "shared/optim/ILPModel.h"
 #include "util/Misc.h"
 #include "util/String.h"
 #include "util/log/Log.h"
@@ -79,20 +81,8 @@ int GurobiSolver::addCol(const std::string& name, ColType colType,
 // _____________________________________________________________________________
 int GurobiSolver::addCol(const std::string& name, ColType colType,
                          double objCoef, double lowBnd, double upBnd) {
-  char vtype = 0;
-  switch (colType) {
-    case INT:
-      vtype = GRB_INTEGER;
-      break;
-    case BIN:
-      vtype = GRB_BINARY;
-      break;
-    case CONT:
-      vtype = GRB_CONTINUOUS;
-      break;
-  }
-  int error =
-      GRBaddvar(_model, 0, 0, 0, objCoef, lowBnd, upBnd, vtype, name.c_str());
+  int error = GRBaddvar(_model, 0, 0, 0, objCoef, lowBnd, upBnd,
+                        getVarType(colType), name.c_str());
   if (error) {
     throw std::runtime_error("Could not add variable " + name);
   }
@@ -102,19 +92,8 @@ int GurobiSolver::addCol(const std::string& name, ColType colType,
 
 // _____________________________________________________________________________
 int GurobiSolver::addRow(const std::string& name, double bnd, RowType rowType) {
-  char rtype = 0;
-  switch (rowType) {
-    case FIX:
-      rtype = GRB_EQUAL;
-      break;
-    case UP:
-      rtype = GRB_LESS_EQUAL;
-      break;
-    case LO:
-      rtype = GRB_GREATER_EQUAL;
-      break;
-  }
-  int error = GRBaddconstr(_model, 0, 0, 0, rtype, bnd, name.c_str());
+  int error = GRBaddconstr(_model, 0, 0, 0, getRowSense(rowType), bnd,
+                           name.c_str());
   if (error) {
     throw std::runtime_error("Could not add row " + name);
   }
@@ -123,6 +102,85 @@ int GurobiSolver::addRow(const std::string& name, double bnd, RowType rowType) {
   return _numRows - 1;
 }
 
+// _____________________________________________________________________________
+void GurobiSolver::load(const ILPModel& m) {
+  int colOffset = _numVars;
+
+  std::vector<double> obj(m.getNumCols()), lb(m.getNumCols()),
+      ub(m.getNumCols());
+  std::vector<char> vtypes(m.getNumCols());
+  std::vector<char*> colNames;
+
+  for (size_t i = 0; i < m.getNumCols(); i++) {
+    const auto& c = m.getCol(i);
+    obj[i] = c.objCoef;
+    lb[i] = c.bounded ? c.lowBnd : -GRB_INFINITY;
+    ub[i] = c.bounded ? c.upBnd : GRB_INFINITY;
+    vtypes[i] = getVarType(c.type);
+    if (m.hasNames())
+      colNames.push_back(const_cast<char*>(m.getColName(i).c_str()));
+  }
+
+  int error = GRBaddvars(_model, m.getNumCols(), 0, 0, 0, 0, obj.data(),
+                         lb.data(), ub.data(), vtypes.data(),
+                         m.hasNames() ? colNames.data() : 0);
+  if (error) throw std::runtime_error("Could not add variables");
+  _numVars += m.getNumCols();
+
+  // make the new variables available to the constraints
+  update();
+
+  std::vector<int> beg, ind;
+  std::vector<double> vals;
+  m.getCompressed(true, &beg, &ind, &vals);
+  for (auto& col : ind) col += colOffset;
+
+  std::vector<char> senses(m.getNumRows());
+  std::vector<double> rhs(m.getNumRows());
+  std::vector<char*> rowNames;
+
+  for (size_t i = 0; i < m.getNumRows(); i++) {
+    senses[i] = getRowSense(m.getRow(i).type);
+    rhs[i] = m.getRow(i).bnd;
+    if (m.hasNames())
+      rowNames.push_back(const_cast<char*>(m.getRowName(i).c_str()));
+  }
+
+  error = GRBaddconstrs(_model, m.getNumRows(), vals.size(), beg.data(),
+                        ind.data(), vals.data(), senses.data(), rhs.data(),
+                        m.hasNames() ? rowNames.data() : 0);
+  if (error) throw std::runtime_error("Could not add rows");
+  _numRows += m.getNumRows();
+
+  update();
+}
+
+// _____________________________________________________________________________
+char GurobiSolver::getVarType(ColType colType) {
+  switch (colType) {
+    case INT:
+      return GRB_INTEGER;
+    case BIN:
+      return GRB_BINARY;
+    case CONT:
+    default:
+      return GRB_CONTINUOUS;
+  }
+}
+
+// _____________________________________________________________________________
+char GurobiSolver::getRowSense(RowType rowType) {
+  switch (rowType) {
+    case FIX:
+      return GRB_EQUAL;
+    case UP:
+      return GRB_LESS_EQUAL;
+    case LO:
+    default:
+      return GRB_GREATER_EQUAL;
+  }
+}
+
 // _____________________________________________________________________________
 void GurobiSolver::addColToRow(const std::string& rowName,
                                const std::string& colName, double coef) {
@@ -135,7 +193,7 @@ void GurobiSolver::addColToRow(const std::string& rowName,
     LOGTO(ERROR, std::cerr) << "Could not find constraint " << rowName;
   }
 
-  addColToRow(col, row, coef);
+  addColToRow(row, col, coef);
 }
 
 // _____________________________________________________________________________
@@ -183,13 +241,13 @@ double GurobiSolver::getObjVal() const {
 
 // _____________________________________________________________________________
 void GurobiSolver::setStarter(const StarterSol& starterSol) {
+  if (_starterArr) delete[] _starterArr;
   _starterArr = new double[getNumVars()];
   std::fill_n(_starterArr, getNumVars(), GRB_UNDEFINED);
 
   for (const auto& varVal : starterSol) {
-    int colId = getVarByName(varVal.first);
-    if (colId < 0) continue;
-    _starterArr[colId] = varVal.second;
+    if (varVal.first < 0 || varVal.first >= getNumVars()) continue;
+    _starterArr[varVal.first] = varVal.second;
   }
 }
 
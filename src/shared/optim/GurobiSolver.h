@@ -23,6 +23,8 @@ class GurobiSolver : public ILPSolver {
              double lowBnd, double upBnd);
   int addRow(const std::string& name, double bnd, RowType rowType);
 
+  void load(const ILPModel& m);
+
   void addColToRow(const std::string& rowName, const std::string& colName,
                    double coef);
   void addColToRow(int rowId, int colId, double coef);
@@ -73,6 +75,9 @@ class GurobiSolver : public ILPSolver {
   int _numVars, _numRows;
   std::string _logBuffer;
 
+  static char getVarType(ColType colType);
+  static char getRowSense(RowType rowType);
+
   static int termHook(GRBmodel* mod, void* cbdata, int where, void* solver);
 };
 
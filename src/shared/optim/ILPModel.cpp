@@ -0,0 +1,100 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <cassert>
+#include <fstream>
+#include "shared/optim/ILPModel.h"
+
+using shared::optim::ILPModel;
+
+const std::string ILPModel::EMPTY;
+
+// _____________________________________________________________________________
+ILPModel::ILPModel(bool names) : _names(names) {}
+
+// _____________________________________________________________________________
+int ILPModel::addCol(ColType colType, double objCoef, const std::string& name) {
+  _cols.push_back({colType, objCoef, false, 0, 0});
+  if (_names) _colNames.push_back(name);
+  return _cols.size() - 1;
+}
+
+// _____________________________________________________________________________
+int ILPModel::addCol(ColType colType, double objCoef, double lowBnd,
+                     double upBnd, const std::string& name) {
+  _cols.push_back({colType, objCoef, true, lowBnd, upBnd});
+  if (_names) _colNames.push_back(name);
+  return _cols.size() - 1;
+}
+
+// _____________________________________________________________________________
+int ILPModel::addRow(double bnd, RowType rowType, const std::string& name) {
+  _rows.push_back({rowType, bnd});
+  if (_names) _rowNames.push_back(name);
+  return _rows.size() - 1;
+}
+
+// _____________________________________________________________________________
+void ILPModel::addColToRow(int rowId, int colId, double coef) {
+  assert(rowId >= 0 && rowId < static_cast<int>(_rows.size()));
+  assert(colId >= 0 && colId < static_cast<int>(_cols.size()));
+  _coefRows.push_back(rowId);
+  _coefCols.push_back(colId);
+  _coefs.push_back(coef);
+}
+
+// _____________________________________________________________________________
+void ILPModel::setObjCoef(int colId, double coef) {
+  _cols[colId].objCoef = coef;
+}
+
+// _____________________________________________________________________________
+const std::string& ILPModel::getColName(int colId) const {
+  if (!_names) return EMPTY;
+  return _colNames[colId];
+}
+
+// _____________________________________________________________________________
+const std::string& ILPModel::getRowName(int rowId) const {
+  if (!_names) return EMPTY;
+  return _rowNames[rowId];
+}
+
+// _____________________________________________________________________________
+void ILPModel::getCompressed(bool byRow, std::vector<int>* beg,
+                             std::vector<int>* ind,
+                             std::vector<double>* vals) const {
+  const auto& major = byRow ? _coefRows : _coefCols;
+  const auto& minor = byRow ? _coefCols : _coefRows;
+  size_t n = byRow ? _rows.size() : _cols.size();
+
+  // counting sort, keeps the insertion order within each row (column)
+  beg->assign(n + 1, 0);
+  for (auto i : major) (*beg)[i + 1]++;
+  for (size_t i = 0; i < n; i++) (*beg)[i + 1] += (*beg)[i];
+
+  ind->resize(_coefs.size());
+  vals->resize(_coefs.size());
+
+  std::vector<int> pos(beg->begin(), beg->end() - 1);
+  for (size_t i = 0; i < _coefs.size(); i++) {
+    int p = pos[major[i]]++;
+    (*ind)[p] = minor[i];
+    (*vals)[p] = _coefs[i];
+  }
+}
+
+// _____________________________________________________________________________
+void ILPModel::writeMst(const std::string& path, const StarterSol& sol) const {
+  std::ofstream fo;
+  fo.open(path);
+
+  for (auto kv : sol) {
+    if (_names) {
+      fo << _colNames[kv.first] << "\t" << kv.second << "\n";
+    } else {
+      fo << "C" << kv.first << "\t" << kv.second << "\n";
+    }
+  }
+}
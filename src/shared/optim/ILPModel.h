@@ -0,0 +1,102 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef SHARED_OPTIM_ILPMODEL_H_
+#define SHARED_OPTIM_ILPMODEL_H_
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "shared/optim/ILPSolver.h"
+#include "util/Misc.h"
+
+namespace shared {
+namespace optim {
+
+struct ILPCol {
+  ColType type;
+  double objCoef;
+
+  // columns without explicit bounds keep the default bounds of the solver
+  bool bounded;
+  double lowBnd, upBnd;
+};
+
+struct ILPRow {
+  RowType type;
+  double bnd;
+};
+
+// Solver independent ILP model. Columns and rows are referenced by the
+// integer ids returned by addCol() and addRow(), coefficients are collected
+// as (row, col, coef) triplets and passed to a solver in a single
+// ILPSolver::load(). Column and row names are only stored if the model was
+// created with names (for example, for MPS output).
+class ILPModel {
+ public:
+  explicit ILPModel(bool names);
+
+  int addCol(ColType colType, double objCoef, const std::string& name = "");
+  int addCol(ColType colType, double objCoef, double lowBnd, double upBnd,
+             const std::string& name = "");
+  int addRow(double bnd, RowType rowType, const std::string& name = "");
+
+  void addColToRow(int rowId, int colId, double coef);
+  void setObjCoef(int colId, double coef);
+
+  bool hasNames() const { return _names; }
+
+  // concatenate args to a column or row name, empty if the model has no names
+  template <typename... Args>
+  std::string name(const Args&... args) const {
+    if (!_names) return "";
+    std::stringstream ss;
+    int unpack[]{0, ((ss << args), 0)...};
+    UNUSED(unpack);
+    return ss.str();
+  }
+
+  size_t getNumCols() const { return _cols.size(); }
+  size_t getNumRows() const { return _rows.size(); }
+  size_t getNumCoefs() const { return _coefs.size(); }
+
+  const ILPCol& getCol(int colId) const { return _cols[colId]; }
+  const ILPRow& getRow(int rowId) const { return _rows[rowId]; }
+
+  // empty if the model has no names
+  const std::string& getColName(int colId) const;
+  const std::string& getRowName(int rowId) const;
+
+  // coefficient triplets, in the order they were added
+  const std::vector<int>& getCoefRows() const { return _coefRows; }
+  const std::vector<int>& getCoefCols() const { return _coefCols; }
+  const std::vector<double>& getCoefs() const { return _coefs; }
+
+  // the coefficient matrix in compressed sparse row (byRow) or column format,
+  // the entries of row (column) i are at beg[i] to beg[i + 1] - 1
+  void getCompressed(bool byRow, std::vector<int>* beg, std::vector<int>* ind,
+                     std::vector<double>* vals) const;
+
+  void writeMst(const std::string& path, const StarterSol& sol) const;
+
+ private:
+  bool _names;
+
+  std::vector<ILPCol> _cols;
+  std::vector<ILPRow> _rows;
+
+  std::vector<std::string> _colNames;
+  std::vector<std::string> _rowNames;
+
+  std::vector<int> _coefRows;
+  std::vector<int> _coefCols;
+  std::vector<double> _coefs;
+
+  static const std::string EMPTY;
+};
+
+}  // namespace optim
+}  // namespace shared
+
+#endif  // SHARED_OPTIM_ILPMODEL_H_
@@ -16,7 +16,7 @@ namespace optim {
 
 inline ILPSolver* getSolver(std::string wish,
                             shared::optim::DirType dir) {
-  bool force = (wish.back() == '!');
+  bool force = (!wish.empty() && wish.back() == '!');
   if (force) {
     wish.pop_back();
   }
@@ -5,7 +5,6 @@
 #ifndef SHARED_OPTIM_ILPSOLVER_H_
 #define SHARED_OPTIM_ILPSOLVER_H_
 
-#include <fstream>
 #include <map>
 #include <string>
 
@@ -17,7 +16,10 @@ enum RowType { FIX, UP, LO };
 enum DirType { MAX, MIN };
 enum SolveType { OPTIM, INF, NON_OPTIM };
 
-typedef std::map<std::string, int> StarterSol;
+// starter solution, column id -> value
+typedef std::map<int, int> StarterSol;
+
+class ILPModel;
 
 class ILPSolver {
  public:
@@ -30,6 +32,10 @@ class ILPSolver {
                      double lowBnd, double upBnd) = 0;
   virtual int addRow(const std::string& name, double bnd, RowType rowType) = 0;
 
+  // add all columns, rows and coefficients of a model at once. Model column
+  // and row ids are offset by the number of columns and rows already present.
+  virtual void load(const ILPModel& m) = 0;
+
   virtual void addColToRow(const std::string& rowName,
                            const std::string& colName, double coef) = 0;
   virtual void addColToRow(int rowId, int colId, double coef) = 0;
@@ -67,12 +73,6 @@ class ILPSolver {
   virtual int getNumVars() const = 0;
 
   virtual void writeMps(const std::string& path) const = 0;
-  void writeMst(const std::string& path, const StarterSol& sol) const {
-    std::ofstream fo;
-    fo.open(path);
-
-    for (auto kv : sol) fo << kv.first << "\t" << kv.second << "\n";
-  }
 };
 
 }  // namespace optim
@@ -37,6 +37,17 @@ class HierarOrderCfg : public std::map<const shared::linegraph::LineEdge*,
       }
     }
   }
+
+  // merge another (partial) configuration into this one, orderings for the
+  // same edge part are appended
+  void merge(const HierarOrderCfg& other) {
+    for (const auto& kv : other) {
+      for (const auto& ordering : kv.second) {
+        auto& tgt = (*this)[kv.first][ordering.first];
+        tgt.insert(tgt.end(), ordering.second.begin(), ordering.second.end());
+      }
+    }
+  }
 };
 }
 }
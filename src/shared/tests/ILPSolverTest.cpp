@@ -4,10 +4,12 @@
 #include <cassert>
 #include <string>
 #include <vector>
+#include "shared/optim/ILPModel.h"
 #include "shared/optim/ILPSolver.h"
 #include "shared/tests/ILPSolverTest.h"
 #include "util/Misc.h"
 
+using shared::optim::ILPModel;
 using shared::optim::ILPSolver;
 using util::approx;
 
@@ -145,6 +147,115 @@ void ILPSolverTest::run() {
       TEST(s->getVarVal("y"), ==, approx(0));
       TEST(s->getVarVal("z"), ==, approx(1));
 
+      TEST(s->getObjVal(), ==, approx(3));
+    }
+  }
+  {
+    ILPModel m(false);
+    int col1 = m.addCol(shared::optim::BIN, 1, "x");
+    int col2 = m.addCol(shared::optim::BIN, 1);
+    int col3 = m.addCol(shared::optim::INT, 2, 0, 1);
+
+    TEST(col1, ==, 0);
+    TEST(col2, ==, 1);
+    TEST(col3, ==, 2);
+    TEST(m.getColName(col1), ==, "");
+    TEST(m.getCol(col3).bounded);
+    TEST(!m.getCol(col2).bounded);
+
+    int row1 = m.addRow(4, shared::optim::UP);
+    int row2 = m.addRow(1, shared::optim::LO);
+    m.addColToRow(row2, col1, 1);
+    m.addColToRow(row1, col1, 1);
+    m.addColToRow(row1, col2, 2);
+    m.addColToRow(row2, col2, 1);
+    m.addColToRow(row1, col3, 3);
+
+    TEST(m.getNumCols(), ==, 3);
+    TEST(m.getNumRows(), ==, 2);
+    TEST(m.getNumCoefs(), ==, 5);
+
+    std::vector<int> beg, ind;
+    std::vector<double> vals;
+    m.getCompressed(true, &beg, &ind, &vals);
+
+    TEST(beg.size(), ==, 3);
+    TEST(beg[0], ==, 0);
+    TEST(beg[1], ==, 3);
+    TEST(beg[2], ==, 5);
+    TEST(ind[0], ==, col1);
+    TEST(ind[1], ==, col2);
+    TEST(ind[2], ==, col3);
+    TEST(vals[2], ==, approx(3));
+    TEST(ind[3], ==, col1);
+    TEST(ind[4], ==, col2);
+
+    m.getCompressed(false, &beg, &ind, &vals);
+
+    TEST(beg.size(), ==, 4);
+    TEST(beg[1], ==, 2);
+    TEST(beg[2], ==, 4);
+    TEST(beg[3], ==, 5);
+    TEST(ind[0], ==, row2);
+    TEST(ind[1], ==, row1);
+    TEST(vals[3], ==, approx(1));
+
+    TEST(m.name("x(", 1, ",", 2, ")"), ==, "");
+
+    ILPModel n(true);
+    TEST(n.name("x(", 1, ",", 2, ")"), ==, "x(1,2)");
+    n.addCol(shared::optim::CONT, 0, n.name("y"));
+    TEST(n.getColName(0), ==, "y");
+  }
+  {
+    std::vector<ILPSolver*> solvers;
+#ifdef GUROBI_FOUND
+    try {
+      solvers.push_back(new GurobiSolver(shared::optim::MAX));
+    } catch (const std::exception& e) {
+    }
+#endif
+
+#ifdef GLPK_FOUND
+    solvers.push_back(new GLPKSolver(shared::optim::MAX));
+#endif
+
+#ifdef COIN_FOUND
+    solvers.push_back(new COINSolver(shared::optim::MAX));
+#endif
+
+    for (auto s : solvers) {
+      ILPModel m(true);
+      int col1 = m.addCol(shared::optim::BIN, 1, "x");
+      int col2 = m.addCol(shared::optim::BIN, 0, "y");
+      int col3 = m.addCol(shared::optim::BIN, 2, "z");
+
+      m.setObjCoef(col2, 1);
+
+      int row1 = m.addRow(4, shared::optim::UP, "constr1");
+      m.addColToRow(row1, col1, 1);
+      m.addColToRow(row1, col2, 2);
+      m.addColToRow(row1, col3, 3);
+
+      int row2 = m.addRow(1, shared::optim::LO, "constr2");
+      m.addColToRow(row2, col1, 1);
+      m.addColToRow(row2, col2, 1);
+
+      s->load(m);
+
+      TEST(s->getNumVars(), ==, 3);
+      TEST(s->getNumConstrs(), ==, 2);
+      TEST(s->getVarByName("z"), ==, col3);
+      TEST(s->getConstrByName("constr2"), ==, row2);
+
+      auto ret = s->solve();
+
+      TEST(ret, ==, shared::optim::OPTIM);
+
+      TEST(s->getVarVal(col1), ==, approx(1));
+      TEST(s->getVarVal(col2), ==, approx(0));
+      TEST(s->getVarVal(col3), ==, approx(1));
+
       TEST(s->getObjVal(), ==, approx(3));
     }
   }
@@ -0,0 +1,212 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <sstream>
+#include <string>
+#include "shared/linegraph/BinGraphOutput.h"
+#include "shared/linegraph/LineGraph.h"
+#include "shared/tests/LineGraphTest.h"
+#include "util/Misc.h"
+
+using shared::linegraph::BinGraphOutput;
+using shared::linegraph::LineEdge;
+using shared::linegraph::LineGraph;
+using shared::linegraph::LineNode;
+using util::approx;
+
+// _____________________________________________________________________________
+void LineGraphTest::run() {
+  {
+    // edges given before their nodes, an exception and an edge without
+    // explicit end nodes
+    std::stringstream ss;
+    ss << R"({"type": "FeatureCollection", "crs": {"properties": {"a": 1}},
+    "features": [
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[0, 0], [50, 0]]},
+        "properties": {"from": "a", "to": "b",
+          "lines": [{"id": "1", "color": "ff0000", "direction": "b"},
+                    {"id": "2", "color": "00ff00"}]}},
+      {"type": "Feature", "geometry": {"type": "Point", "coordinates": [0, 0]},
+        "properties": {"id": "a", "station_id": "sa", "station_label": "A"}},
+      {"type": "Feature", "geometry": {"type": "Point",
+        "coordinates": [50, 0]},
+        "properties": {"id": "b", "excluded_line_conns": [{"route": "1",
+          "edge1_node": "a", "edge2_node": "c"}]}},
+      {"type": "Feature", "geometry": {"type": "Point",
+        "coordinates": [100, 0]}, "properties": {"id": "c"}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[50, 0], [100, 0]]},
+        "properties": {"from": "b", "to": "c",
+          "lines": [{"id": "1", "color": "ff0000"}]}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[100, 0], [100, 50]]},
+        "properties": {"from": "c", "to": "",
+          "lines": [{"id": "2", "color": "00ff00"}]}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[0, 0], [0, 50]]},
+        "properties": {"from": "a", "to": "c", "lines": []}}
+    ]})";
+
+    LineGraph g;
+    g.readFromJson(&ss, 0);
+
+    TEST(g.numNds(), ==, 4);
+    TEST(g.numEdgs(), ==, 3);
+    TEST(g.numLines(), ==, 2);
+    TEST(g.numConnExcs(), ==, 1);
+
+    LineNode* a = 0;
+    LineNode* b = 0;
+    for (auto nd : g.getNds()) {
+      if (nd->pl().getGeom()->getX() == 0) a = nd;
+      if (nd->pl().getGeom()->getX() == 50) b = nd;
+    }
+
+    TEST(a);
+    TEST(b);
+    TEST(a->pl().stops().size(), ==, 1);
+    TEST(a->pl().stops().front().name, ==, "A");
+
+    auto e = g.getEdg(a, b);
+    TEST(e);
+    TEST(e->pl().getLines().size(), ==, 2);
+    TEST(e->pl().lineOcc(g.getLine("1")).direction, ==, b);
+    TEST(!e->pl().lineOcc(g.getLine("2")).direction);
+
+    TEST(g.getBBox().getLowerLeft().getX(), ==, -100);
+    TEST(g.getBBox().getUpperRight().getY(), ==, 150);
+
+    // binary round trip
+    e->pl().setDontContract(true);
+    shared::style::LineStyle ls;
+    ls.setCss("stroke-dasharray: 2");
+    e->pl().updateLineOcc(
+        shared::linegraph::LineOcc(g.getLine("2"), 0, ls));
+    a->pl().addLineNotServed(g.getLine("2"));
+
+    std::stringstream bin;
+    BinGraphOutput out;
+    out.print(g, bin, util::json::Dict{{"statistics", util::json::Dict{
+                                            {"iters", size_t(4)}}}});
+
+    TEST(LineGraph::isBinary(&bin));
+    TEST(!LineGraph::isBinary(&ss));
+
+    LineGraph g2;
+    g2.readFromBinary(&bin, 0);
+
+    TEST(g2.numNds(), ==, 4);
+    TEST(g2.numEdgs(), ==, 3);
+    TEST(g2.numLines(), ==, 2);
+    TEST(g2.numConnExcs(), ==, 1);
+    TEST(g2.getBBox().getLowerLeft().getX(), ==, approx(-100));
+    TEST(g2.getBBox().getUpperRight().getY(), ==, approx(150));
+
+    LineNode* a2 = 0;
+    LineNode* b2 = 0;
+    for (auto nd : g2.getNds()) {
+      if (nd->pl().getGeom()->getX() == approx(0)) a2 = nd;
+      if (nd->pl().getGeom()->getX() == approx(50)) b2 = nd;
+    }
+
+    TEST(a2);
+    TEST(b2);
+    TEST(a2->pl().stops().size(), ==, 1);
+    TEST(a2->pl().stops().front().id, ==, "sa");
+    TEST(!a2->pl().lineServed(g2.getLine("2")));
+    TEST(a2->pl().lineServed(g2.getLine("1")));
+
+    LineEdge* e2 = g2.getEdg(a2, b2);
+    TEST(e2);
+    TEST(e2->pl().dontContract());
+    TEST(e2->pl().getPolyline().getLine().size(), ==, 2);
+    TEST(e2->pl().lineOccAtPos(0).line->id(), ==, "1");
+    TEST(e2->pl().lineOccAtPos(0).direction, ==, b2);
+    TEST(e2->pl().lineOccAtPos(1).style.get().getCss(), ==,
+         "stroke-dasharray: 2");
+    TEST(e2->pl().lineOccAtPos(1).line->color(), ==, "00ff00");
+
+    std::stringstream trunc(bin.str().substr(0, 20));
+    LineGraph g3;
+    bool thrown = false;
+    try {
+      g3.readFromBinary(&trunc, 0);
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    TEST(thrown);
+  }
+
+  {
+    // three edges crossing in a single point, and two edges sharing a node
+    // which cross near it
+    std::stringstream ss;
+    ss << R"({"type": "FeatureCollection", "features": [
+      {"type": "Feature", "geometry": {"type": "Point",
+        "coordinates": [200, 200]}, "properties": {"id": "b"}},
+      {"type": "Feature", "geometry": {"type": "Point",
+        "coordinates": [1000, 0]}, "properties": {"id": "g"}},
+      {"type": "Feature", "geometry": {"type": "Point",
+        "coordinates": [1000, 60]}, "properties": {"id": "h"}},
+      {"type": "Feature", "geometry": {"type": "Point",
+        "coordinates": [1080, 60]}, "properties": {"id": "i"}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[0, 0], [200, 200]]},
+        "properties": {"from": "", "to": "b",
+          "lines": [{"id": "1", "color": "ff0000", "direction": "b"}]}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[0, 200], [200, 0]]},
+        "properties": {"from": "", "to": "",
+          "lines": [{"id": "2", "color": "00ff00"}]}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[100, -100], [100, 300]]},
+        "properties": {"from": "", "to": "",
+          "lines": [{"id": "3", "color": "0000ff"}]}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[1000, 0], [1100, 50], [1000, 60]]},
+        "properties": {"from": "g", "to": "h",
+          "lines": [{"id": "1", "color": "ff0000"}]}},
+      {"type": "Feature", "geometry": {"type": "LineString",
+        "coordinates": [[1000, 0], [1080, 60]]},
+        "properties": {"from": "g", "to": "i",
+          "lines": [{"id": "2", "color": "00ff00"}]}}
+    ]})";
+
+    LineGraph g;
+    g.readFromJson(&ss, 0);
+
+    TEST(g.numNds(), ==, 9);
+    TEST(g.numEdgs(), ==, 5);
+
+    g.topologizeIsects();
+
+    TEST(g.numNds(), ==, 10);
+    TEST(g.numEdgs(), ==, 8);
+
+    LineNode* x = 0;
+    LineNode* b = 0;
+    for (auto nd : g.getNds()) {
+      if (nd->pl().getGeom()->getX() == approx(100) &&
+          nd->pl().getGeom()->getY() == approx(100))
+        x = nd;
+      if (nd->pl().getGeom()->getX() == 200 &&
+          nd->pl().getGeom()->getY() == 200)
+        b = nd;
+    }
+
+    TEST(x);
+    TEST(b);
+    TEST(x->getDeg(), ==, 6);
+
+    // the line direction is kept on both pieces of the split edge
+    for (auto e : x->getAdjList()) {
+      if (!e->pl().hasLine(g.getLine("1"))) continue;
+      if (e->getOtherNd(x) == b) {
+        TEST(e->pl().lineOcc(g.getLine("1")).direction, ==, b);
+      } else {
+        TEST(e->pl().lineOcc(g.getLine("1")).direction, ==, x);
+      }
+    }
+  }
+}
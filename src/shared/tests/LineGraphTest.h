@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef SHARED_TEST_LINEGRAPHTEST_H_
+#define SHARED_TEST_LINEGRAPHTEST_H_
+
+class LineGraphTest {
+  public:
+    void run();
+};
+
+#endif
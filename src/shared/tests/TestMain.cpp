@@ -2,6 +2,7 @@
 // Author: Patrick Brosi
 
 #include "shared/tests/ILPSolverTest.h"
+#include "shared/tests/LineGraphTest.h"
 
 #include "util/Misc.h"
 
@@ -9,7 +10,9 @@
 int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
+  LineGraphTest lgt;
   ILPSolverTest gs;
 
+  lgt.run();
   gs.run();
 }
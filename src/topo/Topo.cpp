@@ -0,0 +1,117 @@
+// Copyright 2016
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#include "shared/linegraph/LineGraph.h"
+#include "topo/Topo.h"
+#include "topo/config/TopoConfig.h"
+#include "topo/mapconstructor/MapConstructor.h"
+#include "topo/restr/RestrInferrer.h"
+#include "topo/statinserter/StatInserter.h"
+#include "util/Misc.h"
+#include "util/json/Writer.h"
+#include "util/log/Log.h"
+
+using shared::linegraph::LineGraph;
+
+// _____________________________________________________________________________
+util::json::Dict topo::run(const config::TopoConfig* cfg, LineGraph* g) {
+  topo::restr::RestrInferrer ri(cfg, g);
+  topo::MapConstructor mc(cfg, g);
+  topo::StatInserter si(cfg, g);
+
+  double lenBef = 0, lenAfter = 0;
+
+  if (cfg->outputStats) {
+    for (const auto& nd : g->getNds()) {
+      for (const auto& e : nd->getAdjList()) {
+        if (e->getFrom() != nd) continue;
+        lenBef += e->pl().getPolyline().getLength();
+      }
+    }
+  }
+
+  size_t statFr = mc.freeze();
+  si.init();
+
+  mc.averageNodePositions();
+
+  mc.cleanUpGeoms();
+
+  // does preserve existing turn restrictions
+  mc.removeNodeArtifacts(false);
+
+  // init restriction inferrer
+  ri.init();
+  size_t restrFr = mc.freeze();
+
+  // only remove the artifacts after the restriction inferrer has been
+  // initialized, as these operations do not guarantee that the restrictions
+  // are preserved!
+  mc.removeEdgeArtifacts();
+
+  T_START(construction);
+  size_t iters = 0;
+  iters += mc.collapseShrdSegs(10);
+  iters += mc.collapseShrdSegs(cfg->maxAggrDistance);
+  double constrT = T_STOP(construction);
+
+  mc.removeNodeArtifacts(false);
+
+  double avgMergedEdgs = 0;
+  size_t maxMergedEdgs = 0;
+  if (cfg->outputStats) {
+    size_t c = 0;
+    const auto& origEdgs = mc.freezeTrack(restrFr);
+    for (const auto& nd : g->getNds()) {
+      for (const auto& e : nd->getAdjList()) {
+        if (e->getFrom() != nd) continue;
+        size_t cur = origEdgs.at(e).size();
+        if (cur > maxMergedEdgs) maxMergedEdgs = cur;
+        avgMergedEdgs += cur;
+        c++;
+      }
+    }
+    avgMergedEdgs /= c;
+  }
+
+  // infer restrictions
+  T_START(restrInf);
+  if (!cfg->noInferRestrs) ri.infer(mc.freezeTrack(restrFr));
+  double restrT = T_STOP(restrInf);
+
+  // insert stations
+  T_START(stationIns);
+  si.insertStations(mc.freezeTrack(statFr));
+  double stationT = T_STOP(stationIns);
+
+  // remove orphan lines, which may be introduced by another station
+  // placement
+  mc.removeOrphanLines();
+
+  mc.removeNodeArtifacts(true);
+
+  mc.reconstructIntersections();
+
+  if (!cfg->outputStats) return {};
+
+  for (const auto& nd : g->getNds()) {
+    for (const auto& e : nd->getAdjList()) {
+      if (e->getFrom() != nd) continue;
+      lenAfter += e->pl().getPolyline().getLength();
+    }
+  }
+
+  return util::json::Dict{
+      {"statistics", util::json::Dict{
+                         {"iters", iters},
+                         {"time_const", constrT},
+                         {"time_restr_inf", restrT},
+                         {"time_station_insert", stationT},
+                         {"len_before", lenBef},
+                         {"num_restrs", g->numConnExcs()},
+                         {"avg_merged_edgs", avgMergedEdgs},
+                         {"max_merged_edgs", maxMergedEdgs},
+                         {"len_after", lenAfter},
+                     }}};
+}
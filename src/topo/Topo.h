@@ -0,0 +1,23 @@
+// Copyright 2016
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#ifndef TOPO_TOPO_H_
+#define TOPO_TOPO_H_
+
+#include "shared/linegraph/LineGraph.h"
+#include "topo/config/TopoConfig.h"
+#include "util/json/Writer.h"
+
+namespace topo {
+
+// Runs the full topo pipeline on g: shared segments are collapsed, turn
+// restrictions inferred and the original stations inserted again. Used by
+// the topo tool and by loomserver. The returned statistics are only
+// gathered if cfg->outputStats is set.
+util::json::Dict run(const config::TopoConfig* cfg,
+                     shared::linegraph::LineGraph* g);
+
+}  // namespace topo
+
+#endif  // TOPO_TOPO_H_
@@ -42,10 +42,26 @@ void ConfigReader::help(const char* bin) const {
             << "maximum distance between segments\n"
             << std::setw(35) << "  --write-stats"
             << "write statistics to output file\n"
+            << std::setw(35) << "  --format arg (=geojson)"
+            << "output format, 'geojson' or 'binary'\n"
             << std::setw(35) << "  --no-infer-restrs"
             << "don't infer turn restrictions\n"
             << std::setw(35) << "  --max-length-dev arg (=500)"
-            << "maxumum distance deviation for turn restrictions infer\n";
+            << "maxumum distance deviation for turn restrictions infer\n"
+            << std::setw(35) << "  --collapse-tile-size arg (=0)"
+            << "collapse shared segments in tiles of this size\n"
+            << std::setw(35) << " "
+            << "in parallel, 0 means no tiling\n"
+            << std::setw(35) << "  --collapse-moved-dist arg (=1)"
+            << "only re-collapse around points which moved\n"
+            << std::setw(35) << " "
+            << "more than this in the previous iteration,\n"
+            << std::setw(35) << " "
+            << "0 always re-collapses the whole graph\n"
+            << std::setw(35) << "  --threads arg (=0)"
+            << "number of threads for tiled collapsing and\n"
+            << std::setw(35) << " "
+            << "restriction inference, 0 means all cores\n";
 }
 
 // _____________________________________________________________________________
@@ -58,6 +74,10 @@ void ConfigReader::read(TopoConfig* cfg, int argc, char** argv) const {
                          {"no-infer-restrs", no_argument, 0, 1},
                          {"write-stats", no_argument, 0, 2},
                          {"max-length-dev", required_argument, 0, 3},
+                         {"format", required_argument, 0, 4},
+                         {"collapse-tile-size", required_argument, 0, 5},
+                         {"threads", required_argument, 0, 6},
+                         {"collapse-moved-dist", required_argument, 0, 7},
                          {0, 0, 0, 0}};
 
   char c;
@@ -81,6 +101,18 @@ void ConfigReader::read(TopoConfig* cfg, int argc, char** argv) const {
       case 3:
         cfg->maxAggrDistance = atof(optarg);
         break;
+      case 4:
+        cfg->outFormat = optarg;
+        break;
+      case 5:
+        cfg->collapseTileSize = atof(optarg);
+        break;
+      case 6:
+        cfg->threads = atoi(optarg);
+        break;
+      case 7:
+        cfg->collapseMovedDist = atof(optarg);
+        break;
       case ':':
         std::cerr << argv[optind - 1];
         std::cerr << " requires an argument" << std::endl;
@@ -96,4 +128,10 @@ void ConfigReader::read(TopoConfig* cfg, int argc, char** argv) const {
         break;
     }
   }
+
+  if (cfg->outFormat != "geojson" && cfg->outFormat != "binary") {
+    std::cerr << "Unknown output format " << cfg->outFormat
+              << ", must be one of {geojson, binary}" << std::endl;
+    exit(1);
+  }
 }
@@ -5,6 +5,7 @@
 #ifndef TOPO_CONFIG_TOPOCONFIG_H_
 #define TOPO_CONFIG_TOPOCONFIG_H_
 
+#include <cstddef>
 #include <string>
 
 namespace topo {
@@ -15,6 +16,20 @@ struct TopoConfig {
   double maxLengthDev = 500;
   bool outputStats = false;
   bool noInferRestrs = false;
+  std::string outFormat = "geojson";
+
+  // size of the tiles shared segments are collapsed in concurrently, 0
+  // collapses the whole graph serially
+  double collapseTileSize = 0;
+
+  // later collapse iterations only re-collapse the surroundings of points
+  // which moved more than this in the previous iteration, 0 re-collapses
+  // the whole graph in every iteration
+  double collapseMovedDist = 1;
+
+  // number of threads used for tiled collapsing and restriction inference,
+  // 0 means all available
+  size_t threads = 0;
 };
 
 }  // namespace config
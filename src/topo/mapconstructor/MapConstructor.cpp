@@ -4,12 +4,18 @@
 
 #include <cassert>
 #include <climits>
+#include <cmath>
 #include "shared/linegraph/LineGraph.h"
 #include "topo/mapconstructor/MapConstructor.h"
 #include "util/geo/Geo.h"
 #include "util/geo/Grid.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 
 using topo::MapConstructor;
 using topo::ShrdSegWrap;
@@ -102,8 +108,9 @@ LineNode* MapConstructor::ndCollapseCand(const std::set<LineNode*>& notFrom,
 
     double dMax = maxD(numLines, ndTest, dCut);
 
+    // equally distant candidates are decided by position, not by address
     if (d < dSpanA / sqrt(2.0) && d < dSpanB / sqrt(2.0) && d < dMax &&
-        d < dBest) {
+        (d < dBest || (d == dBest && ndLess(ndTest, ndMin)))) {
       dBest = d;
       ndMin = ndTest;
     }
@@ -193,166 +200,38 @@ int MapConstructor::collapseShrdSegs(double dCut) {
 
 // _____________________________________________________________________________
 int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
+  // points which moved more than cfg->collapseMovedDist in the last
+  // iteration, edges farther away from all of them are not collapsed again
+  bool trackMoved = _cfg->collapseMovedDist > 0;
+  std::vector<DPoint> moved;
+
   size_t ITER = 0;
   for (; ITER < MAX_ITERS; ITER++) {
     shared::linegraph::LineGraph tgNew;
 
-    // new grid per iteration
-    NodeGrid grid(120, 120, bbox());
-
     std::unordered_map<LineNode*, LineNode*> imgNds;
     std::set<LineNode*> imgNdsSet;
 
-    double SEGL = 5;
-
-    std::vector<std::pair<double, LineEdge*>> sortedEdges;
-    for (auto n : _g->getNds()) {
-      for (auto e : n->getAdjList()) {
-        if (e->getFrom() != n) continue;
-        sortedEdges.push_back({e->pl().getPolyline().getLength(), e});
-      }
+    auto edges = sortedEdges();
+    if (ITER > 0 && trackMoved) {
+      edges =
+          freezeEdges(edges, moved, 2 * dCut, &tgNew, &imgNds, &imgNdsSet);
     }
 
-    std::sort(sortedEdges.rbegin(), sortedEdges.rend());
-
-    size_t j = 0;
-    for (const auto& ep : sortedEdges) {
-      j++;
-
-      auto e = ep.second;
-
-      LineNode* last = 0;
-
-      std::set<LineNode*> myNds;
-
-      size_t i = 0;
-      std::vector<LineNode*> affectedNodes;
-      LineNode* front = 0;
-      LineNode* back = e->getTo();
-
-      bool imgFromCovered = false;
-      bool imgToCovered = false;
-
-      auto pl = *e->pl().getGeom();
-      pl.insert(pl.begin(), *e->getFrom()->pl().getGeom());
-      pl.insert(pl.end(), *e->getTo()->pl().getGeom());
-
-      const auto& plDense =
-          util::geo::densify(util::geo::simplify(pl, 0.5), SEGL);
-
-      for (const auto& point : plDense) {
-        if (i == plDense.size() - 1) back = 0;
-        LineNode* cur = ndCollapseCand(myNds, e->pl().getLines().size(), dCut,
-                                       point, front, back, grid, &tgNew);
-
-        if (i == 0) {
-          // this is the "FROM" node
-          if (!imgNds.count(e->getFrom())) {
-            imgNds[e->getFrom()] = cur;
-            imgNdsSet.insert(cur);
-            imgFromCovered = true;
-          }
-        }
-
-        if (i == plDense.size() - 1) {
-          // this is the "TO" node
-          if (!imgNds.count(e->getTo())) {
-            imgNds[e->getTo()] = cur;
-            imgNdsSet.insert(cur);
-            imgToCovered = true;
-          }
-        }
-
-        myNds.insert(cur);
-
-        // careful, increase this here, before the continue below
-        i++;
-
-        if (last == cur) continue;  // skip self-edges
-
-        if (cur == imgNds[e->getFrom()]) {
-          imgFromCovered = true;
-        }
-        if (imgNds.count(e->getTo()) && cur == imgNds[e->getTo()]) {
-          imgToCovered = true;
-        }
-
-        if (last) {
-          auto newE = tgNew.getEdg(last, cur);
-          if (!newE) newE = tgNew.addEdg(last, cur);
-
-          combContEdgs(newE, e);
-          mergeLines(newE, e, last, cur);
-
-          densifyEdg(newE, &tgNew, SEGL);
-        }
-
-        affectedNodes.push_back(cur);
-        if (!front) front = cur;
-        last = cur;
-
-        if (imgNds.count(e->getTo()) && last == imgNds.find(e->getTo())->second)
-          break;
-      }
-
-      assert(imgNds[e->getFrom()]);
-      assert(imgNds[e->getTo()]);
-
-      if (!imgFromCovered) {
-        auto newE = tgNew.getEdg(imgNds[e->getFrom()], front);
-        if (!newE) newE = tgNew.addEdg(imgNds[e->getFrom()], front);
-
-        combContEdgs(newE, e);
-        mergeLines(newE, e, imgNds[e->getFrom()], front);
-
-        densifyEdg(newE, &tgNew, SEGL);
-      }
-
-      if (!imgToCovered) {
-        auto newE = tgNew.getEdg(last, imgNds[e->getTo()]);
-        if (!newE) newE = tgNew.addEdg(last, imgNds[e->getTo()]);
-
-        combContEdgs(newE, e);
-        mergeLines(newE, e, last, imgNds[e->getTo()]);
-
-        densifyEdg(newE, &tgNew, SEGL);
-      }
-
-      // now check all affected nodes for artifact edges (= edges connecting
-      // two deg != 1 nodes under the segment length, they would otherwise
-      // never be collapsed because they have to collapse into themself)
-
-      for (const auto& a : affectedNodes) {
-        if (imgNdsSet.count(a)) continue;
-
-        double dMin = SEGL;
-        LineNode* comb = 0;
-
-        // combine always with the nearest one
-        for (auto e : a->getAdjList()) {
-          auto b = e->getOtherNd(a);
-
-          if ((a->getDeg() < 3 && b->getDeg() < 3)) continue;
-          double dCur = util::geo::dist(*a->pl().getGeom(), *b->pl().getGeom());
-          if (dCur <= dMin) {
-            dMin = dCur;
-            comb = b;
-          }
-        }
+    if (_cfg->collapseTileSize > 0) {
+      collapseTiled(edges, dCut, &tgNew, &imgNds, &imgNdsSet);
+    } else {
+      // new grid per iteration
+      NodeGrid grid(120, 120, bbox());
+      for (auto n : tgNew.getNds()) grid.add(*n->pl().getGeom(), n);
 
-        // this will delete "a" and keep "comb"
-        // crucially, "to" has not yet appeared in the list, and we will
-        // see the combined node later on
-        if (comb && combineNodes(a, comb, &tgNew) && a != comb) grid.remove(a);
-      }
+      collapseEdges(edges, dCut, &grid, &tgNew, &imgNds, &imgNdsSet);
     }
 
     // soft cleanup
-    std::vector<LineNode*> ndsA;
-    ndsA.insert(ndsA.begin(), tgNew.getNds().begin(), tgNew.getNds().end());
-    for (auto from : ndsA) {
+    for (auto from : sortedNds(tgNew)) {
       for (auto e : from->getAdjList()) {
-        if (e->getFrom() != from) continue;
+        if (e->getFrom() != from || _frozen.count(e)) continue;
         auto to = e->getTo();
         if ((from->getDeg() == 2 || to->getDeg() == 2)) continue;
         if (combineNodes(from, to, &tgNew)) break;
@@ -369,16 +248,22 @@ int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
       for (auto e : n->getAdjList()) {
         if (e->getFrom() != n) continue;
 
+        if (_frozen.count(e)) {
+          // frozen edges keep their geometry, only their end nodes may move
+          auto geom = *e->pl().getGeom();
+          geom.front() = *e->getFrom()->pl().getGeom();
+          geom.back() = *e->getTo()->pl().getGeom();
+          e->pl().setGeom(geom);
+          continue;
+        }
+
         e->pl().setGeom(
             {*e->getFrom()->pl().getGeom(), *e->getTo()->pl().getGeom()});
       }
     }
 
     // re-collapse
-    std::vector<LineNode*> nds;
-    nds.insert(nds.begin(), tgNew.getNds().begin(), tgNew.getNds().end());
-
-    for (auto n : nds) {
+    for (auto n : sortedNds(tgNew)) {
       if (n->getDeg() == 2) {
         if (!lineEq(n->getAdjList().front(), n->getAdjList().back())) continue;
 
@@ -402,9 +287,7 @@ int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
     }
 
     // remove edge artifacts
-    nds.clear();
-    nds.insert(nds.begin(), tgNew.getNds().begin(), tgNew.getNds().end());
-    for (auto from : nds) {
+    for (auto from : sortedNds(tgNew)) {
       for (auto e : from->getAdjList()) {
         if (e->getFrom() != from) continue;
         auto to = e->getTo();
@@ -426,10 +309,7 @@ int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
     }
 
     // re-collapse again because we might have introduce deg 2 nodes above
-    nds.clear();
-    nds.insert(nds.begin(), tgNew.getNds().begin(), tgNew.getNds().end());
-
-    for (auto n : nds) {
+    for (auto n : sortedNds(tgNew)) {
       if (n->getDeg() == 2 &&
           !tgNew.getEdg(n->getAdjList().front()->getOtherNd(n),
                         n->getAdjList().back()->getOtherNd(n))) {
@@ -442,7 +322,7 @@ int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
     // smoothen a bit
     for (auto n : tgNew.getNds()) {
       for (auto e : n->getAdjList()) {
-        if (e->getFrom() != n) continue;
+        if (e->getFrom() != n || _frozen.count(e)) continue;
         auto pl = e->pl().getPolyline();
         pl.smoothenOutliers(50);
         pl.simplify(1);
@@ -472,6 +352,18 @@ int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
       }
     }
 
+    if (trackMoved) {
+      moved.clear();
+      movedPoints(tgNew, *_g, _cfg->collapseMovedDist, dCut / 2, &moved);
+      movedPoints(*_g, tgNew, _cfg->collapseMovedDist, dCut / 2, &moved);
+    }
+
+    LOGTO(DEBUG, std::cerr) << "iter " << ITER << ", " << edges.size()
+                            << " edges collapsed, " << _frozen.size()
+                            << " frozen";
+
+    _frozen.clear();
+
     *_g = std::move(tgNew);
 
     LOGTO(DEBUG, std::cerr)
@@ -482,6 +374,413 @@ int MapConstructor::collapseShrdSegs(double dCut, size_t MAX_ITERS) {
   return ITER + 1;
 }
 
+// _____________________________________________________________________________
+std::vector<std::pair<double, LineEdge*>> MapConstructor::sortedEdges() const {
+  std::vector<std::pair<double, LineEdge*>> ret;
+  for (auto n : _g->getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      ret.push_back({e->pl().getPolyline().getLength(), e});
+    }
+  }
+
+  // longest edges first
+  std::sort(ret.begin(), ret.end(),
+            [](const std::pair<double, LineEdge*>& a,
+               const std::pair<double, LineEdge*>& b) {
+              if (a.first != b.first) return a.first > b.first;
+              if (ndLess(a.second->getFrom(), b.second->getFrom())) return true;
+              if (ndLess(b.second->getFrom(), a.second->getFrom())) return false;
+              return ndLess(a.second->getTo(), b.second->getTo());
+            });
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::vector<LineNode*> MapConstructor::sortedNds(const LineGraph& g) const {
+  std::vector<LineNode*> ret(g.getNds().begin(), g.getNds().end());
+  std::sort(ret.begin(), ret.end(), ndLess);
+  return ret;
+}
+
+// _____________________________________________________________________________
+bool MapConstructor::ndLess(const LineNode* a, const LineNode* b) {
+  // a null node is never less
+  if (!a || !b) return a && !b;
+
+  const auto& pa = *a->pl().getGeom();
+  const auto& pb = *b->pl().getGeom();
+  if (pa.getX() != pb.getX()) return pa.getX() < pb.getX();
+  if (pa.getY() != pb.getY()) return pa.getY() < pb.getY();
+  return a->getDeg() < b->getDeg();
+}
+
+// _____________________________________________________________________________
+void MapConstructor::collapseEdges(
+    const std::vector<std::pair<double, LineEdge*>>& edges, double dCut,
+    NodeGrid* grid, LineGraph* tgNew,
+    std::unordered_map<LineNode*, LineNode*>* imgNds,
+    std::set<LineNode*>* imgNdsSet) {
+  double SEGL = 5;
+
+  for (const auto& ep : edges) {
+    auto e = ep.second;
+
+    LineNode* last = 0;
+
+    std::set<LineNode*> myNds;
+
+    size_t i = 0;
+    std::vector<LineNode*> affectedNodes;
+    LineNode* front = 0;
+    LineNode* back = e->getTo();
+
+    bool imgFromCovered = false;
+    bool imgToCovered = false;
+
+    auto pl = *e->pl().getGeom();
+    pl.insert(pl.begin(), *e->getFrom()->pl().getGeom());
+    pl.insert(pl.end(), *e->getTo()->pl().getGeom());
+
+    const auto& plDense =
+        util::geo::densify(util::geo::simplify(pl, 0.5), SEGL);
+
+    for (const auto& point : plDense) {
+      if (i == plDense.size() - 1) back = 0;
+      LineNode* cur = ndCollapseCand(myNds, e->pl().getLines().size(), dCut,
+                                     point, front, back, *grid, tgNew);
+
+      if (i == 0) {
+        // this is the "FROM" node
+        if (!imgNds->count(e->getFrom())) {
+          (*imgNds)[e->getFrom()] = cur;
+          imgNdsSet->insert(cur);
+          imgFromCovered = true;
+        }
+      }
+
+      if (i == plDense.size() - 1) {
+        // this is the "TO" node
+        if (!imgNds->count(e->getTo())) {
+          (*imgNds)[e->getTo()] = cur;
+          imgNdsSet->insert(cur);
+          imgToCovered = true;
+        }
+      }
+
+      myNds.insert(cur);
+
+      // careful, increase this here, before the continue below
+      i++;
+
+      if (last == cur) continue;  // skip self-edges
+
+      if (cur == (*imgNds)[e->getFrom()]) {
+        imgFromCovered = true;
+      }
+      if (imgNds->count(e->getTo()) && cur == (*imgNds)[e->getTo()]) {
+        imgToCovered = true;
+      }
+
+      if (last) {
+        auto newE = tgNew->getEdg(last, cur);
+        if (!newE) newE = tgNew->addEdg(last, cur);
+
+        combContEdgs(newE, e);
+        mergeLines(newE, e, last, cur);
+
+        densifyEdg(newE, tgNew, SEGL);
+      }
+
+      affectedNodes.push_back(cur);
+      if (!front) front = cur;
+      last = cur;
+
+      if (imgNds->count(e->getTo()) && last == imgNds->find(e->getTo())->second)
+        break;
+    }
+
+    assert((*imgNds)[e->getFrom()]);
+    assert((*imgNds)[e->getTo()]);
+
+    if (!imgFromCovered) {
+      auto newE = tgNew->getEdg((*imgNds)[e->getFrom()], front);
+      if (!newE) newE = tgNew->addEdg((*imgNds)[e->getFrom()], front);
+
+      combContEdgs(newE, e);
+      mergeLines(newE, e, (*imgNds)[e->getFrom()], front);
+
+      densifyEdg(newE, tgNew, SEGL);
+    }
+
+    if (!imgToCovered) {
+      auto newE = tgNew->getEdg(last, (*imgNds)[e->getTo()]);
+      if (!newE) newE = tgNew->addEdg(last, (*imgNds)[e->getTo()]);
+
+      combContEdgs(newE, e);
+      mergeLines(newE, e, last, (*imgNds)[e->getTo()]);
+
+      densifyEdg(newE, tgNew, SEGL);
+    }
+
+    // now check all affected nodes for artifact edges (= edges connecting
+    // two deg != 1 nodes under the segment length, they would otherwise
+    // never be collapsed because they have to collapse into themself)
+
+    for (const auto& a : affectedNodes) {
+      if (imgNdsSet->count(a)) continue;
+
+      double dMin = SEGL;
+      LineNode* comb = 0;
+
+      // combine always with the nearest one
+      for (auto e : a->getAdjList()) {
+        auto b = e->getOtherNd(a);
+
+        if ((a->getDeg() < 3 && b->getDeg() < 3)) continue;
+        double dCur = util::geo::dist(*a->pl().getGeom(), *b->pl().getGeom());
+        if (dCur <= dMin) {
+          dMin = dCur;
+          comb = b;
+        }
+      }
+
+      // this will delete "a" and keep "comb"
+      // crucially, "to" has not yet appeared in the list, and we will
+      // see the combined node later on
+      if (comb && combineNodes(a, comb, tgNew) && a != comb) grid->remove(a);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void MapConstructor::collapseTiled(
+    const std::vector<std::pair<double, LineEdge*>>& edges, double dCut,
+    LineGraph* tgNew, std::unordered_map<LineNode*, LineNode*>* imgNds,
+    std::set<LineNode*>* imgNdsSet) {
+  // An edge belongs to a tile if its bounding box, padded by a halo of twice
+  // the snapping distance, lies inside the tile. Nodes snapped from edges of
+  // different tiles can then never come close enough to interact, and the
+  // tiles can be collapsed independently. All other edges, and edges
+  // attached to nodes already in tgNew, are seam edges, which are snapped
+  // into the stitched tiles afterwards.
+  DBox box = bbox();
+  double tileSize = _cfg->collapseTileSize;
+  double halo = 2 * dCut;
+
+  DPoint ll = box.getLowerLeft();
+  DPoint ur = box.getUpperRight();
+
+  size_t xTiles = std::max(1.0, std::ceil((ur.getX() - ll.getX()) / tileSize));
+  size_t yTiles = std::max(1.0, std::ceil((ur.getY() - ll.getY()) / tileSize));
+
+  auto tileCoord = [tileSize](double v, double orig, size_t n) -> size_t {
+    double t = std::floor((v - orig) / tileSize);
+    if (t < 0) return 0;
+    return std::min(n - 1, static_cast<size_t>(t));
+  };
+
+  std::vector<std::vector<std::pair<double, LineEdge*>>> tileEdges(xTiles *
+                                                                   yTiles);
+  std::vector<std::pair<double, LineEdge*>> seamEdges;
+
+  for (const auto& ep : edges) {
+    auto e = ep.second;
+    if (imgNds->count(e->getFrom()) || imgNds->count(e->getTo())) {
+      seamEdges.push_back(ep);
+      continue;
+    }
+
+    DBox eBox = extendBox(e->pl().getPolyline().getLine(), DBox());
+    eBox = extendBox(*e->getFrom()->pl().getGeom(), eBox);
+    eBox = extendBox(*e->getTo()->pl().getGeom(), eBox);
+    eBox = util::geo::pad(eBox, halo);
+
+    size_t xA = tileCoord(eBox.getLowerLeft().getX(), ll.getX(), xTiles);
+    size_t xB = tileCoord(eBox.getUpperRight().getX(), ll.getX(), xTiles);
+    size_t yA = tileCoord(eBox.getLowerLeft().getY(), ll.getY(), yTiles);
+    size_t yB = tileCoord(eBox.getUpperRight().getY(), ll.getY(), yTiles);
+
+    if (xA == xB && yA == yB) {
+      tileEdges[xA * yTiles + yA].push_back(ep);
+    } else {
+      seamEdges.push_back(ep);
+    }
+  }
+
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+
+  std::vector<LineGraph> tileGraphs(tileEdges.size());
+  std::vector<std::vector<OrigEdgs>> tileOrigEdgs(tileEdges.size());
+  std::vector<std::unordered_map<LineNode*, LineNode*>> tileImgNds(
+      tileEdges.size());
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+  for (size_t i = 0; i < tileEdges.size(); i++) {
+    if (tileEdges[i].empty()) continue;
+
+    DPoint tileLl(ll.getX() + (i / yTiles) * tileSize,
+                  ll.getY() + (i % yTiles) * tileSize);
+    DPoint tileUr(tileLl.getX() + tileSize, tileLl.getY() + tileSize);
+
+    // the tile only sees the freeze tracks of its own edges
+    MapConstructor tileMc(_cfg, &tileGraphs[i]);
+    tileMc._origEdgs.resize(_origEdgs.size());
+    for (size_t j = 0; j < _origEdgs.size(); j++) {
+      for (const auto& ep : tileEdges[i]) {
+        auto it = _origEdgs[j].find(ep.second);
+        if (it == _origEdgs[j].end()) continue;
+        tileMc._origEdgs[j][ep.second] = it->second;
+      }
+    }
+
+    NodeGrid grid(120, 120, DBox(tileLl, tileUr));
+    std::set<LineNode*> imgNdsSet;
+
+    tileMc.collapseEdges(tileEdges[i], dCut, &grid, &tileGraphs[i],
+                         &tileImgNds[i], &imgNdsSet);
+
+    tileOrigEdgs[i] = std::move(tileMc._origEdgs);
+  }
+
+  // stitch the tiles into tgNew
+  for (size_t i = 0; i < tileEdges.size(); i++) {
+    if (tileEdges[i].empty()) continue;
+
+    std::unordered_map<const LineNode*, LineNode*> ndMap;
+    std::unordered_map<const LineEdge*, LineEdge*> edgMap;
+
+    for (auto n : tileGraphs[i].getNds()) ndMap[n] = tgNew->addNd(n->pl());
+
+    // in node order, so the adjacency lists do not depend on addresses
+    for (auto n : sortedNds(tileGraphs[i])) {
+      for (auto e : n->getAdjList()) {
+        if (e->getFrom() != n) continue;
+        auto newE = tgNew->addEdg(ndMap[e->getFrom()], ndMap[e->getTo()],
+                                  e->pl());
+        LineGraph::nodeRpl(newE, e->getFrom(), newE->getFrom());
+        LineGraph::nodeRpl(newE, e->getTo(), newE->getTo());
+        edgMap[e] = newE;
+      }
+    }
+
+    for (auto n : tileGraphs[i].getNds()) {
+      for (auto e : n->getAdjList()) LineGraph::edgeRpl(ndMap[n], e, edgMap[e]);
+    }
+
+    for (size_t j = 0; j < _origEdgs.size(); j++) {
+      for (auto& kv : tileOrigEdgs[i][j]) {
+        auto it = edgMap.find(kv.first);
+        if (it == edgMap.end()) continue;
+        _origEdgs[j][it->second] = std::move(kv.second);
+      }
+    }
+
+    for (const auto& kv : tileImgNds[i]) {
+      if (!kv.second) continue;
+      (*imgNds)[kv.first] = ndMap[kv.second];
+      imgNdsSet->insert(ndMap[kv.second]);
+    }
+  }
+
+  // the seam edges are snapped serially into the stitched tiles
+  NodeGrid grid(120, 120, box);
+  for (auto n : tgNew->getNds()) grid.add(*n->pl().getGeom(), n);
+  grid.compact();
+
+  collapseEdges(seamEdges, dCut, &grid, tgNew, imgNds, imgNdsSet);
+}
+
+// _____________________________________________________________________________
+std::vector<std::pair<double, LineEdge*>> MapConstructor::freezeEdges(
+    const std::vector<std::pair<double, LineEdge*>>& edges,
+    const std::vector<DPoint>& moved, double d, LineGraph* tgNew,
+    std::unordered_map<LineNode*, LineNode*>* imgNds,
+    std::set<LineNode*>* imgNdsSet) {
+  FlatGrid<size_t, Point, double> grid(120, 120, util::geo::pad(bbox(), d),
+                                       false);
+  for (size_t i = 0; i < moved.size(); i++) grid.add(moved[i], i);
+  grid.compact();
+
+  std::vector<std::pair<double, LineEdge*>> ret;
+
+  for (const auto& ep : edges) {
+    auto e = ep.second;
+    const auto& geom = *e->pl().getGeom();
+
+    bool near = false;
+    grid.visit(util::geo::pad(util::geo::getBoundingBox(geom), d),
+               [&](size_t i) {
+                 if (!near && util::geo::dist(moved[i], geom) < d) near = true;
+               });
+
+    if (near) {
+      ret.push_back(ep);
+      continue;
+    }
+
+    // copy the edge unchanged, its end nodes are fixed images
+    for (auto n : {e->getFrom(), e->getTo()}) {
+      if (imgNds->count(n)) continue;
+      auto img = tgNew->addNd(*n->pl().getGeom());
+      (*imgNds)[n] = img;
+      imgNdsSet->insert(img);
+    }
+
+    auto newE = tgNew->addEdg((*imgNds)[e->getFrom()], (*imgNds)[e->getTo()],
+                              e->pl());
+    LineGraph::nodeRpl(newE, e->getFrom(), newE->getFrom());
+    LineGraph::nodeRpl(newE, e->getTo(), newE->getTo());
+    combContEdgs(newE, e);
+
+    _frozen.insert(newE);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+void MapConstructor::movedPoints(const LineGraph& a, const LineGraph& b,
+                                 double d, double step,
+                                 std::vector<DPoint>* ret) const {
+  DBox box;
+  std::vector<util::geo::LineSegment<double>> segs;
+
+  for (auto n : b.getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      const auto& geom = *e->pl().getGeom();
+      for (size_t i = 1; i < geom.size(); i++)
+        segs.push_back({geom[i - 1], geom[i]});
+      box = extendBox(geom, box);
+    }
+  }
+
+  FlatGrid<size_t, Line, double> grid(120, 120, util::geo::pad(box, d),
+                                      false);
+  for (size_t i = 0; i < segs.size(); i++)
+    grid.add(DLine{segs[i].first, segs[i].second}, i);
+  grid.compact();
+
+  for (auto n : a.getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      for (const auto& p : util::geo::densify(*e->pl().getGeom(), step)) {
+        bool found = false;
+        if (!segs.empty()) {
+          grid.visit(util::geo::pad(util::geo::getBoundingBox(p), d),
+                     [&](size_t i) {
+                       if (!found && util::geo::dist(p, segs[i]) <= d)
+                         found = true;
+                     });
+        }
+        if (!found) ret->push_back(p);
+      }
+    }
+  }
+}
+
 // _____________________________________________________________________________
 void MapConstructor::averageNodePositions() {
   for (auto n : _g->getNds()) {
@@ -669,6 +968,7 @@ void MapConstructor::delOrigEdgsFor(const LineEdge* a) {
   for (auto& oe : _origEdgs) {
     oe.erase(a);
   }
+  _frozen.erase(a);
 }
 
 // _____________________________________________________________________________
@@ -678,6 +978,7 @@ void MapConstructor::delOrigEdgsFor(const LineNode* a) {
     for (auto& oe : _origEdgs) {
       oe.erase(edg);
     }
+    _frozen.erase(edg);
   }
 }
 
@@ -707,6 +1008,7 @@ bool MapConstructor::combineNodes(LineNode* a, LineNode* b, LineGraph* g) {
     if (!newE) {
       // add a new edge going from b to the non-a node
       newE = g->addEdg(b, oldE->getTo(), oldE->pl());
+      if (_frozen.count(oldE)) _frozen.insert(newE);
 
       // update route dirs
       LineGraph::nodeRpl(newE, a, b);
@@ -731,6 +1033,7 @@ bool MapConstructor::combineNodes(LineNode* a, LineNode* b, LineGraph* g) {
 
     if (!newE) {
       newE = g->addEdg(oldE->getFrom(), b, oldE->pl());
+      if (_frozen.count(oldE)) _frozen.insert(newE);
 
       // update route dirs
       LineGraph::nodeRpl(newE, a, b);
@@ -1008,6 +1311,11 @@ void MapConstructor::supportEdge(LineEdge* ex, LineGraph* g) {
   combContEdgs(eA, ex);
   combContEdgs(eB, ex);
 
+  if (_frozen.count(ex)) {
+    _frozen.insert(eA);
+    _frozen.insert(eB);
+  }
+
   LineGraph::nodeRpl(eA, ex->getTo(), supNd);
   LineGraph::nodeRpl(eB, ex->getFrom(), supNd);
 
@@ -7,11 +7,13 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "shared/linegraph/LineGraph.h"
 #include "topo/config/TopoConfig.h"
 #include "topo/restr/RestrGraph.h"
 #include "util/geo/Geo.h"
-#include "util/geo/Grid.h"
+#include "util/geo/FlatGrid.h"
 #include "util/geo/PolyLine.h"
 #include "util/graph/Graph.h"
 
@@ -19,7 +21,7 @@ using util::geo::Box;
 using util::geo::DBox;
 using util::geo::DLine;
 using util::geo::DPoint;
-using util::geo::Grid;
+using util::geo::FlatGrid;
 using util::geo::Line;
 using util::geo::Point;
 using util::geo::PolyLine;
@@ -35,7 +37,7 @@ using shared::linegraph::LineNode;
 using shared::linegraph::LineNodePL;
 using shared::linegraph::Station;
 
-typedef Grid<LineNode*, Point, double> NodeGrid;
+typedef FlatGrid<LineNode*, Point, double> NodeGrid;
 
 typedef std::map<const LineEdge*, std::set<const LineEdge*>> OrigEdgs;
 
@@ -94,6 +96,31 @@ class MapConstructor {
                            const LineNode* spanA, const LineNode* spanB,
                            NodeGrid& grid, LineGraph* g) const;
 
+  // snap the densified geometries of edges into tgNew
+  void collapseEdges(const std::vector<std::pair<double, LineEdge*>>& edges,
+                     double dCut, NodeGrid* grid, LineGraph* tgNew,
+                     std::unordered_map<LineNode*, LineNode*>* imgNds,
+                     std::set<LineNode*>* imgNdsSet);
+
+  // like collapseEdges(), but collapses spatial tiles of
+  // cfg->collapseTileSize concurrently and stitches their seams afterwards
+  void collapseTiled(const std::vector<std::pair<double, LineEdge*>>& edges,
+                     double dCut, LineGraph* tgNew,
+                     std::unordered_map<LineNode*, LineNode*>* imgNds,
+                     std::set<LineNode*>* imgNdsSet);
+
+  // copy edges farther than d from all moved points unchanged into tgNew
+  // and mark them as frozen, returns the remaining edges
+  std::vector<std::pair<double, LineEdge*>> freezeEdges(
+      const std::vector<std::pair<double, LineEdge*>>& edges,
+      const std::vector<DPoint>& moved, double d, LineGraph* tgNew,
+      std::unordered_map<LineNode*, LineNode*>* imgNds,
+      std::set<LineNode*>* imgNdsSet);
+
+  // sample points (every step) of the edges in a farther than d from b
+  void movedPoints(const LineGraph& a, const LineGraph& b, double d,
+                   double step, std::vector<DPoint>* ret) const;
+
   double maxD(size_t lines, const LineNode* nd, double d) const;
   double maxD(size_t lines, double d) const;
   double maxD(const LineNode* ndA, const LineNode* ndB, double d) const;
@@ -127,6 +154,15 @@ class MapConstructor {
 
   DBox bbox() const;
 
+  // the edges of _g, longest first. Ties are broken by the end node
+  // positions, so the order does not depend on edge addresses
+  std::vector<std::pair<double, LineEdge*>> sortedEdges() const;
+
+  // the nodes of g ordered by position and degree, not by address
+  std::vector<LineNode*> sortedNds(const LineGraph& g) const;
+
+  static bool ndLess(const LineNode* a, const LineNode* b);
+
   LineEdgePair split(LineEdgePL& a, LineNode* fr, LineNode* to, double p);
 
   std::set<const LineEdge*> _indEdges;
@@ -134,6 +170,9 @@ class MapConstructor {
   std::map<LineEdgePair, size_t> _pEdges;
 
   std::vector<OrigEdgs> _origEdgs;
+
+  // edges copied unchanged from the last iteration
+  std::set<const LineEdge*> _frozen;
 };
 
 }  // namespace topo
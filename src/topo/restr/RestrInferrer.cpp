@@ -11,6 +11,11 @@
 #include "topo/restr/RestrInferrer.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/Dijkstra.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 
 using topo::restr::RestrInferrer;
 
@@ -74,19 +79,24 @@ size_t RestrInferrer::infer(const OrigEdgs& origEdgs) {
 
   addHndls(origEdgs);
 
-  size_t ret = 0;
-
   // debug output
   // util::geo::output::GeoGraphJsonOutput out;
   // std::ofstream outs;
   // outs.open("restr_graph.json");
   // out.print(_rg, outs);
 
+  // collect the candidate connections first, checking them is independent
+  // read-only work on _rg
+  std::vector<ConnCand> cands;
+
   for (auto nd : _tg->getNds()) {
-    for (auto edg1 : nd->getAdjList()) {
-      // check every other edge
-      for (auto edg2 : nd->getAdjList()) {
-        if (edg1 == edg2) continue;
+    const auto& adj = nd->getAdjList();
+    for (size_t i = 0; i < adj.size(); i++) {
+      auto edg1 = adj[i];
+
+      // the check is symmetric, look at every other edge only once
+      for (size_t j = i + 1; j < adj.size(); j++) {
+        auto edg2 = adj[j];
 
         for (auto ro1 : edg1->pl().getLines()) {
           if (!edg2->pl().hasLine(ro1.line)) continue;
@@ -103,15 +113,30 @@ size_t RestrInferrer::infer(const OrigEdgs& origEdgs) {
             continue;
           }
 
-          if (!check(ro1.line, edg1, edg2) && !check(ro1.line, edg2, edg1)) {
-            nd->pl().addConnExc(ro1.line, edg1, edg2);
-            ret++;
-          }
+          cands.push_back({nd, edg1, edg2, ro1.line});
         }
       }
     }
   }
 
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+  std::vector<char> restricted(cands.size(), 0);
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+  for (size_t i = 0; i < cands.size(); i++) {
+    const auto& c = cands[i];
+    restricted[i] = !check(c.line, c.a, c.b) && !check(c.line, c.b, c.a);
+  }
+
+  size_t ret = 0;
+
+  for (size_t i = 0; i < cands.size(); i++) {
+    if (!restricted[i]) continue;
+    // adds the exception in both directions
+    cands[i].nd->pl().addConnExc(cands[i].line, cands[i].a, cands[i].b);
+    ret += 2;
+  }
+
   return ret;
 }
 
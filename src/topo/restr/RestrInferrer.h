@@ -67,6 +67,14 @@ struct CostFunc : public EDijkstra::CostFunc<RestrNodePL, RestrEdgePL, double> {
   const Line* _line;
 };
 
+// a line continuing from edge a to edge b at node nd
+struct ConnCand {
+  LineNode* nd;
+  const LineEdge* a;
+  const LineEdge* b;
+  const Line* line;
+};
+
 struct HndlCmp {
   bool operator()(const Hndl& a, const Hndl& b) const {
     return a.second < b.second;
@@ -48,6 +48,8 @@ EdgeGrid StatInserter::geoIndex() {
     }
   }
 
+  grid.compact();
+
   return grid;
 }
 
@@ -10,7 +10,7 @@
 #include "shared/linegraph/LineGraph.h"
 #include "topo/config/TopoConfig.h"
 #include "util/geo/Geo.h"
-#include "util/geo/Grid.h"
+#include "util/geo/FlatGrid.h"
 #include "util/geo/PolyLine.h"
 #include "util/graph/Graph.h"
 
@@ -18,7 +18,7 @@ using util::geo::Box;
 using util::geo::DBox;
 using util::geo::DLine;
 using util::geo::DPoint;
-using util::geo::Grid;
+using util::geo::FlatGrid;
 using util::geo::Line;
 using util::geo::Point;
 using util::geo::PolyLine;
@@ -34,8 +34,8 @@ using shared::linegraph::LineNode;
 using shared::linegraph::LineNodePL;
 using shared::linegraph::Station;
 
-typedef Grid<LineNode*, Point, double> NodeGrid;
-typedef Grid<LineEdge*, Line, double> EdgeGrid;
+typedef FlatGrid<LineNode*, Point, double> NodeGrid;
+typedef FlatGrid<LineEdge*, Line, double> EdgeGrid;
 
 typedef std::map<const LineEdge*, std::set<const LineEdge*>> OrigEdgs;
 
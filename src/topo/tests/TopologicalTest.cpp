@@ -65,6 +65,61 @@ void TopologicalTest::run() {
     }
   }
   // ___________________________________________________________________________
+  {
+    //     1               3
+    // a ------> b     e ------> f
+    // c ------> d     g ------> h
+    //     2               4
+    //
+    // tiled, a-b and c-d lie inside the first tile, e-f and g-h are seam
+    // edges
+    shared::linegraph::LineGraph tg;
+    auto a = tg.addNd({{0.0, 5.0}});
+    auto b = tg.addNd({{50.0, 5.0}});
+    auto c = tg.addNd({{0.0, 0.0}});
+    auto d = tg.addNd({{50.0, 0.0}});
+    auto e = tg.addNd({{1000.0, 5.0}});
+    auto f = tg.addNd({{1500.0, 5.0}});
+    auto g = tg.addNd({{1000.0, 0.0}});
+    auto h = tg.addNd({{1500.0, 0.0}});
+
+    auto ab = tg.addEdg(a, b, {{{0.0, 5.0}, {50.0, 5.0}}});
+    auto cd = tg.addEdg(c, d, {{{0.0, 0.0}, {50.0, 0.0}}});
+    auto ef = tg.addEdg(e, f, {{{1000.0, 5.0}, {1500.0, 5.0}}});
+    auto gh = tg.addEdg(g, h, {{{1000.0, 0.0}, {1500.0, 0.0}}});
+
+    shared::linegraph::Line l1("1", "1", "red");
+    shared::linegraph::Line l2("2", "2", "blue");
+    shared::linegraph::Line l3("3", "3", "green");
+    shared::linegraph::Line l4("4", "4", "black");
+
+    ab->pl().addLine(&l1, 0);
+    cd->pl().addLine(&l2, 0);
+    ef->pl().addLine(&l3, 0);
+    gh->pl().addLine(&l4, 0);
+
+    topo::config::TopoConfig cfg;
+    cfg.maxAggrDistance = 10;
+    cfg.collapseTileSize = 600;
+    cfg.threads = 2;
+
+    topo::MapConstructor mc(&cfg, &tg);
+    mc.collapseShrdSegs();
+
+    //     1, 2            3, 4
+    // a ------> b     e ------> f
+
+    TEST(tg.getNds().size(), ==, 4);
+
+    for (auto nd : tg.getNds()) {
+      TEST(nd->getDeg(), ==, 1);
+      TEST(nd->getAdjList().front()->pl().getLines().size(), ==, 2);
+      for (auto r : nd->getAdjList().front()->pl().getLines()) {
+        TEST(r.direction, ==, 0);
+      }
+    }
+  }
+  // ___________________________________________________________________________
   {
     //      2->     1
     //     a--> b <---|
@@ -1136,4 +1191,125 @@ void TopologicalTest::run() {
       TEST(e->pl().getLines().begin()->direction, ==, 0);
     }
   }
+
+  // ___________________________________________________________________________
+  {
+    //     1
+    // a ------> b
+    // c ------> d                 e ------> f
+    //     2                            3
+    //
+    // after the first iteration, only a-b and c-d have moved, e-f is frozen
+    // and not collapsed again
+    shared::linegraph::Line l1("1", "1", "red");
+    shared::linegraph::Line l2("2", "2", "blue");
+    shared::linegraph::Line l3("3", "3", "green");
+
+    auto build = [&](shared::linegraph::LineGraph* tg) {
+      auto a = tg->addNd({{0.0, 5.0}});
+      auto b = tg->addNd({{200.0, 5.0}});
+      auto c = tg->addNd({{0.0, 0.0}});
+      auto d = tg->addNd({{200.0, 0.0}});
+      auto e = tg->addNd({{1000.0, 0.0}});
+      auto f = tg->addNd({{1500.0, 0.0}});
+
+      tg->addEdg(a, b, {{{0.0, 5.0}, {200.0, 5.0}}})->pl().addLine(&l1, 0);
+      tg->addEdg(c, d, {{{0.0, 0.0}, {200.0, 0.0}}})->pl().addLine(&l2, 0);
+      tg->addEdg(e, f, {{{1000.0, 0.0}, {1500.0, 0.0}}})
+          ->pl()
+          .addLine(&l3, 0);
+    };
+
+    {
+      shared::linegraph::LineGraph tgOld, tg;
+      build(&tgOld);
+      build(&tg);
+
+      topo::config::TopoConfig cfg;
+      cfg.maxAggrDistance = 10;
+
+      topo::MapConstructor mc(&cfg, &tg);
+      mc.collapseShrdSegs(10, 1);
+
+      // the moved points of the first iteration, as in collapseShrdSegs()
+      std::vector<util::geo::DPoint> moved;
+      mc.movedPoints(tg, tgOld, cfg.collapseMovedDist, 5, &moved);
+      mc.movedPoints(tgOld, tg, cfg.collapseMovedDist, 5, &moved);
+
+      TEST(moved.size(), >, 0);
+      for (const auto& p : moved) TEST(p.getX(), <, 500);
+
+      shared::linegraph::LineGraph tgNew;
+      std::unordered_map<LineNode*, LineNode*> imgNds;
+      std::set<LineNode*> imgNdsSet;
+      auto edges =
+          mc.freezeEdges(mc.sortedEdges(), moved, 20, &tgNew, &imgNds,
+                         &imgNdsSet);
+
+      TEST(edges.size(), >, 0);
+      for (const auto& ep : edges) TEST(!ep.second->pl().hasLine(&l3));
+
+      TEST(mc._frozen.size(), ==, 1);
+      TEST((*mc._frozen.begin())->pl().hasLine(&l3));
+      TEST(tgNew.getNds().size(), ==, 2);
+      TEST(imgNdsSet.size(), ==, 2);
+
+      mc._frozen.clear();
+    }
+
+    // the result is the same as if the whole graph is collapsed again in
+    // every iteration
+    shared::linegraph::LineGraph tgA, tgB;
+    build(&tgA);
+    build(&tgB);
+
+    topo::config::TopoConfig cfgA;
+    cfgA.maxAggrDistance = 10;
+    topo::config::TopoConfig cfgB = cfgA;
+    cfgB.collapseMovedDist = 0;
+
+    topo::MapConstructor mcA(&cfgA, &tgA);
+    topo::MapConstructor mcB(&cfgB, &tgB);
+    int itersA = mcA.collapseShrdSegs();
+    int itersB = mcB.collapseShrdSegs();
+
+    TEST(itersA, >, 1);
+    TEST(itersA, ==, itersB);
+    TEST(tgA.getNds().size(), ==, tgB.getNds().size());
+
+    size_t edgsA = 0, edgsB = 0;
+    for (auto nd : tgB.getNds()) {
+      for (auto e : nd->getAdjList()) {
+        if (e->getFrom() == nd) edgsB++;
+      }
+    }
+
+    for (auto ndA : tgA.getNds()) {
+      for (auto eA : ndA->getAdjList()) {
+        if (eA->getFrom() != ndA) continue;
+        edgsA++;
+
+        bool found = false;
+        for (auto ndB : tgB.getNds()) {
+          for (auto eB : ndB->getAdjList()) {
+            if (eB->getFrom() != ndB) continue;
+            if (eB->pl().getLines().size() != eA->pl().getLines().size())
+              continue;
+            bool sameLines = true;
+            for (const auto& lo : eA->pl().getLines()) {
+              if (!eB->pl().hasLine(lo.line)) sameLines = false;
+            }
+            if (sameLines &&
+                eA->pl().getPolyline().equals(eB->pl().getPolyline(), 1)) {
+              found = true;
+            }
+          }
+        }
+        TEST(found);
+      }
+    }
+
+    TEST(edgsA, ==, 2);
+    TEST(edgsA, ==, edgsB);
+  }
 }
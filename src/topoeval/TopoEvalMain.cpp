@@ -314,11 +314,17 @@ int main(int argc, char** argv) {
   std::ifstream ifs;
 
   ifs.open(gtPath);
-  gtGraph.readFromJson(&ifs, false);
+  if (shared::linegraph::LineGraph::isBinary(&ifs))
+    gtGraph.readFromBinary(&ifs, false);
+  else
+    gtGraph.readFromJson(&ifs, false);
   ifs.close();
 
   ifs.open(testPath);
-  testGraph.readFromJson(&ifs, false);
+  if (shared::linegraph::LineGraph::isBinary(&ifs))
+    testGraph.readFromBinary(&ifs, false);
+  else
+    testGraph.readFromJson(&ifs, false);
   ifs.close();
 
   LOG(DEBUG) << "Ground truth graph: " << gtGraph.getNds().size() << " nodes";
@@ -0,0 +1,46 @@
+// Copyright 2016
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#include <ostream>
+#include <stdexcept>
+#include "shared/rendergraph/RenderGraph.h"
+#include "transitmap/TransitMap.h"
+#include "transitmap/config/TransitMapConfig.h"
+#include "transitmap/graph/GraphBuilder.h"
+#include "transitmap/output/SvgRenderer.h"
+#include "transitmap/output/TileRenderer.h"
+#include "util/log/Log.h"
+
+using shared::rendergraph::RenderGraph;
+
+// _____________________________________________________________________________
+void transitmapper::run(const config::Config* cfg, RenderGraph* g,
+                        std::ostream* out) {
+  if (cfg->renderMethod != "svg") {
+    throw std::runtime_error("Unknown render method " + cfg->renderMethod);
+  }
+
+  transitmapper::graph::GraphBuilder b(cfg);
+
+  g->smooth();
+
+  b.writeNodeFronts(g);
+
+  b.expandOverlappinFronts(g);
+
+  // find expanded node fronts that form a node and replace them with a
+  // single node
+  g->createMetaNodes();
+
+  if (!cfg->tileDir.empty()) {
+    LOGTO(DEBUG, std::cerr) << "Outputting SVG tiles to " << cfg->tileDir
+                            << " ...";
+    transitmapper::output::TileRenderer tileOut(cfg);
+    tileOut.print(*g);
+  } else {
+    LOGTO(DEBUG, std::cerr) << "Outputting to SVG ...";
+    transitmapper::output::SvgRenderer svgOut(out, cfg);
+    svgOut.print(*g);
+  }
+}
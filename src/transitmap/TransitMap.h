@@ -0,0 +1,23 @@
+// Copyright 2016
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#ifndef TRANSITMAP_TRANSITMAP_H_
+#define TRANSITMAP_TRANSITMAP_H_
+
+#include <ostream>
+#include "shared/rendergraph/RenderGraph.h"
+#include "transitmap/config/TransitMapConfig.h"
+
+namespace transitmapper {
+
+// Renders g with the method set in cfg->renderMethod. Used by the
+// transitmap tool and by loomserver. If cfg->tileDir is set, SVG tiles are
+// written below it, otherwise a single SVG is written to out. Throws a
+// std::runtime_error on an unknown render method.
+void run(const config::Config* cfg, shared::rendergraph::RenderGraph* g,
+         std::ostream* out);
+
+}  // namespace transitmapper
+
+#endif  // TRANSITMAP_TRANSITMAP_H_
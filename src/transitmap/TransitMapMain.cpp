@@ -7,13 +7,12 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <stdexcept>
 #include <string>
-#include "shared/rendergraph/Penalties.h"
 #include "shared/rendergraph/RenderGraph.h"
-#include "transitmap/config/ConfigReader.cpp"
+#include "transitmap/TransitMap.h"
+#include "transitmap/config/ConfigReader.h"
 #include "transitmap/config/TransitMapConfig.h"
-#include "transitmap/graph/GraphBuilder.h"
-#include "transitmap/output/SvgRenderer.h"
 #include "util/log/Log.h"
 
 // _____________________________________________________________________________
@@ -31,30 +30,19 @@ int main(int argc, char** argv) {
 
   LOGTO(DEBUG, std::cerr) << "Reading graph...";
   shared::rendergraph::RenderGraph g(cfg.lineWidth, cfg.lineSpacing);
-  transitmapper::graph::GraphBuilder b(&cfg);
 
   if (cfg.fromDot) {
     g.readFromDot(&std::cin, cfg.inputSmoothing);
+  } else if (shared::linegraph::LineGraph::isBinary(&std::cin)) {
+    g.readFromBinary(&std::cin, cfg.inputSmoothing);
   } else {
     g.readFromJson(&std::cin, cfg.inputSmoothing);
   }
 
-  g.smooth();
-
-  b.writeNodeFronts(&g);
-
-  b.expandOverlappinFronts(&g);
-
-  // find expanded node fronts that form a node and replace them with a
-  // single node
-  g.createMetaNodes();
-
-  if (cfg.renderMethod == "svg") {
-    LOGTO(DEBUG, std::cerr) << "Outputting to SVG ...";
-    transitmapper::output::SvgRenderer svgOut(&std::cout, &cfg);
-    svgOut.print(g);
-  } else {
-    LOG(ERROR) << "Unknown render method " << cfg.renderMethod;
+  try {
+    transitmapper::run(&cfg, &g, &std::cout);
+  } catch (const std::runtime_error& e) {
+    LOG(ERROR) << e.what();
     exit(1);
   }
 
@@ -19,6 +19,9 @@ static const char* COPY =
     "University of Freiburg - Chair of Algorithms and Data Structures";
 static const char* AUTHORS = "Patrick Brosi <brosi@informatik.uni-freiburg.de>";
 
+// highest tile zoom level, tiles are about 2.4 web mercator meters wide here
+static const size_t MAX_TILE_ZOOM = 24;
+
 // _____________________________________________________________________________
 ConfigReader::ConfigReader() {}
 
@@ -69,7 +72,20 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(37) << "  --no-render-node-connections"
             << "don't render inner node connections\n"
             << std::setw(37) << "  --render-node-fronts"
-            << "render node fronts\n";
+            << "render node fronts\n\n"
+            << "Tiles:\n"
+            << std::setw(37) << "  --tiles arg"
+            << "write z/x/y SVG tiles into this directory\n"
+            << std::setw(37) << "  --tile-zoom-min arg (=10)"
+            << "lowest zoom level of rendered tiles\n"
+            << std::setw(37) << "  --tile-zoom-max arg (=14)"
+            << "highest zoom level of rendered tiles\n"
+            << std::setw(37) << "  --tile-buffer arg (=16)"
+            << "tile buffer in pixels\n"
+            << std::setw(37) << "  --threads arg (=0)"
+            << "number of threads for rendering,\n"
+            << std::setw(37) << " "
+            << "0 means all available cores\n";
 }
 
 // _____________________________________________________________________________
@@ -93,6 +109,11 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"padding", required_argument, 0, 13},
                          {"smoothing", required_argument, 0, 14},
                          {"render-node-fronts", no_argument, 0, 15},
+                         {"tiles", required_argument, 0, 17},
+                         {"tile-zoom-min", required_argument, 0, 18},
+                         {"tile-zoom-max", required_argument, 0, 19},
+                         {"tile-buffer", required_argument, 0, 20},
+                         {"threads", required_argument, 0, 21},
                          {0, 0, 0, 0}};
 
   char c;
@@ -152,6 +173,21 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 16:
         cfg->dontLabelDeg2 = true;
         break;
+      case 17:
+        cfg->tileDir = optarg;
+        break;
+      case 18:
+        cfg->tileZoomMin = atoi(optarg);
+        break;
+      case 19:
+        cfg->tileZoomMax = atoi(optarg);
+        break;
+      case 20:
+        cfg->tileBuffer = atof(optarg);
+        break;
+      case 21:
+        cfg->threads = atoi(optarg);
+        break;
       case 'D':
         cfg->fromDot = true;
         break;
@@ -170,6 +206,17 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
         break;
     }
   }
+  // negative values wrap around and are also caught here
+  if (cfg->tileZoomMin > MAX_TILE_ZOOM || cfg->tileZoomMax > MAX_TILE_ZOOM) {
+    std::cerr << "--tile-zoom-min and --tile-zoom-max must be between 0 and "
+              << MAX_TILE_ZOOM << std::endl;
+    exit(1);
+  }
+  if (cfg->tileZoomMin > cfg->tileZoomMax) {
+    std::cerr << "--tile-zoom-min must not be greater than --tile-zoom-max"
+              << std::endl;
+    exit(1);
+  }
   if (cfg->outputPadding < 0) {
     cfg->outputPadding = (cfg->lineWidth + cfg->lineSpacing);
   }
@@ -41,6 +41,19 @@ struct Config {
 
   bool renderDirMarkers = false;
   std::string worldFilePath;
+
+  // if not empty, z/x/y SVG tiles are written into this directory instead
+  // of a single SVG to stdout
+  std::string tileDir;
+  size_t tileZoomMin = 10;
+  size_t tileZoomMax = 14;
+
+  // tile buffer in pixels, geometries are clipped against the buffered tile
+  double tileBuffer = 16;
+
+  // number of threads for geometry generation and tile rendering, 0 means
+  // all available
+  size_t threads = 0;
 };
 
 }  // namespace config
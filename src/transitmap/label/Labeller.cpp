@@ -169,15 +169,12 @@ Overlaps Labeller::getOverlaps(const util::geo::MultiLine<double>& band,
     }
   }
 
-  std::set<size_t> labelNeighs;
-  _statLblGrid.get(band,
-                   g.getMaxLineNum() * (_cfg->lineWidth + _cfg->lineSpacing),
-                   &labelNeighs);
-
-  for (auto id : labelNeighs) {
-    auto labelNeigh = _stationLabels[id];
-    if (util::geo::dist(labelNeigh.band, band) < 1) ret.statLabelOverlaps++;
-  }
+  _statLblGrid.visit(
+      band, g.getMaxLineNum() * (_cfg->lineWidth + _cfg->lineSpacing),
+      [&](size_t id) {
+        const auto& labelNeigh = _stationLabels[id];
+        if (util::geo::dist(labelNeigh.band, band) < 1) ret.statLabelOverlaps++;
+      });
 
   return ret;
 }
@@ -228,41 +225,36 @@ void Labeller::labelLines(const RenderGraph& g) {
             }
           }
 
-          std::set<size_t> labelNeighs;
-          _statLblGrid.get(
+          _statLblGrid.visit(
               MultiLine<double>{cand.getLine()},
               g.getMaxLineNum() * (_cfg->lineWidth + _cfg->lineSpacing),
-              &labelNeighs);
-
-          for (auto neighId : labelNeighs) {
-            auto neigh = _stationLabels[neighId];
-            if (util::geo::dist(cand.getLine(), neigh.band) < (fontSize)) {
-              block = true;
-              break;
-            }
-          }
+              [&](size_t neighId) {
+                if (block) return;
+                const auto& neigh = _stationLabels[neighId];
+                if (util::geo::dist(cand.getLine(), neigh.band) < (fontSize)) {
+                  block = true;
+                }
+              });
 
           if (dir < 0) cand.reverse();
 
-          std::set<size_t> lineLabelNeighs;
-          labelGrid.get(cand.getLine(),
-                        20 * (_cfg->lineWidth + _cfg->lineSpacing),
-                        &lineLabelNeighs);
-
           std::vector<const shared::linegraph::Line*> lines;
           for (auto lo : e->pl().getLines()) {
             lines.push_back(lo.line);
           }
 
-          for (auto neighLabelId : lineLabelNeighs) {
-            auto neighLabel = _lineLabels[neighLabelId];
-            if (neighLabel.lines == lines &&
-                util::geo::dist(cand.getLine(), neighLabel.geom.getLine()) <
-                    20 * (_cfg->lineWidth + _cfg->lineSpacing)) {
-              block = true;
-              break;
-            }
-          }
+          labelGrid.visit(
+              cand.getLine(), 20 * (_cfg->lineWidth + _cfg->lineSpacing),
+              [&](size_t neighLabelId) {
+                if (block) return;
+                const auto& neighLabel = _lineLabels[neighLabelId];
+                if (neighLabel.lines == lines &&
+                    util::geo::dist(cand.getLine(),
+                                    neighLabel.geom.getLine()) <
+                        20 * (_cfg->lineWidth + _cfg->lineSpacing)) {
+                  block = true;
+                }
+              });
 
           if (!block)
             cands.push_back({cand, fabs((geomLen / 2) - (start + (labelW / 2))),
@@ -8,7 +8,7 @@
 #include "shared/linegraph/Line.h"
 #include "shared/rendergraph/RenderGraph.h"
 #include "transitmap/config/TransitMapConfig.h"
-#include "util/geo/Grid.h"
+#include "util/geo/FlatGrid.h"
 
 namespace transitmapper {
 namespace label {
@@ -75,8 +75,9 @@ inline bool operator<(const StationLabel& a, const StationLabel& b) {
   return a.getPen() < b.getPen();
 }
 
-typedef util::geo::Grid<size_t, util::geo::MultiLine, double> StatLblGrid;
-typedef util::geo::Grid<size_t, util::geo::Line, double> LineLblGrid;
+typedef util::geo::FlatGrid<size_t, util::geo::MultiLine, double>
+    StatLblGrid;
+typedef util::geo::FlatGrid<size_t, util::geo::Line, double> LineLblGrid;
 
 class Labeller {
  public:
@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <ostream>
 
@@ -15,13 +17,22 @@
 #include "util/String.h"
 #include "util/geo/PolyLine.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 
 using shared::linegraph::Line;
 using shared::linegraph::LineNode;
 using shared::rendergraph::InnerGeom;
 using shared::rendergraph::RenderGraph;
 using transitmapper::label::Labeller;
+using transitmapper::output::EdgeLinePart;
+using transitmapper::output::EndMarker;
 using transitmapper::output::InnerClique;
+using transitmapper::output::InnerLinePart;
+using transitmapper::output::PrintDelegate;
 using transitmapper::output::SvgRenderer;
 using util::geo::DPoint;
 using util::geo::DPolygon;
@@ -30,6 +41,9 @@ using util::geo::LinePointCmp;
 using util::geo::Polygon;
 using util::geo::PolyLine;
 
+// number of decimal digits of output coordinates
+const static size_t COORD_DIGITS = 2;
+
 // _____________________________________________________________________________
 SvgRenderer::SvgRenderer(std::ostream* o, const config::Config* cfg)
     : _o(o), _w(o, true), _cfg(cfg) {}
@@ -99,10 +113,8 @@ void SvgRenderer::print(const RenderGraph& outG) {
   *_o << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
          "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">";
 
-  LOGTO(DEBUG, std::cerr) << "Rendering edges...";
-  if (_cfg->renderEdges) {
-    outputEdges(outG, rparams);
-  }
+  prepare(outG);
+
   _w.openTag("svg", params);
 
   _w.openTag("defs");
@@ -132,13 +144,6 @@ void SvgRenderer::print(const RenderGraph& outG) {
 
   _w.closeTag();
 
-  LOGTO(DEBUG, std::cerr) << "Rendering nodes...";
-  for (auto n : outG.getNds()) {
-    if (_cfg->renderNodeConnections) {
-      renderNodeConnections(outG, n, rparams);
-    }
-  }
-
   LOGTO(DEBUG, std::cerr) << "Writing edges...";
   renderDelegates(outG, rparams);
 
@@ -158,26 +163,84 @@ void SvgRenderer::print(const RenderGraph& outG) {
 }
 
 // _____________________________________________________________________________
-void SvgRenderer::outputNodes(const RenderGraph& outG,
-                              const RenderParams& rparams) {
-  _w.openTag("g");
-  for (auto n : outG.getNds()) {
-    std::map<std::string, std::string> params;
+void SvgRenderer::prepare(const RenderGraph& outG) {
+  LOGTO(DEBUG, std::cerr) << "Rendering edges...";
+  if (_cfg->renderEdges) {
+    outputEdges(outG);
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Rendering nodes...";
+  std::vector<const LineNode*> nds(outG.getNds().begin(),
+                                   outG.getNds().end());
+  _nodeGeoms.clear();
+  _nodeGeoms.resize(nds.size());
+
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+
+  // the geometries of a node only depend on the graph, each thread writes
+  // into the buffer of its node
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 16)
+  for (size_t i = 0; i < nds.size(); i++) {
+    renderNodeGeoms(outG, nds[i], &_nodeGeoms[i]);
+  }
+
+  // delegates are created in node order, independent of the threads
+  for (const auto& ng : _nodeGeoms) {
+    for (const auto& c : ng.cliques) renderClique(c);
+  }
+}
 
-    if (_cfg->renderStations && n->pl().stops().size() > 0 &&
-        n->pl().fronts().size() > 0) {
-      params["stroke"] = "black";
-      params["stroke-width"] =
-          util::toString((_cfg->lineWidth / 2) * _cfg->outputResolution);
-      params["fill"] = "white";
-
-      for (const auto& geom :
-           outG.getStopGeoms(n, (_cfg->lineSpacing + _cfg->lineWidth) * 0.8,
-                             _cfg->tightStations, 32)) {
-        printPolygon(geom, params, rparams);
+// _____________________________________________________________________________
+std::vector<const PrintDelegate*> SvgRenderer::getDelegates() const {
+  // same order as in renderDelegates()
+  std::vector<const PrintDelegate*> ret;
+  for (auto& a : _delegates) {
+    for (auto& pd : a.second) {
+      if (_cfg->outlineWidth > 0) ret.push_back(&pd.back);
+      ret.push_back(&pd.front);
+    }
+  }
+
+  for (auto& a : _innerDelegates) {
+    for (auto& b : a) {
+      if (_cfg->outlineWidth > 0) {
+        for (auto& pd : b.second) ret.push_back(&pd.back);
       }
+      for (auto& pd : b.second) ret.push_back(&pd.front);
     }
   }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::vector<const Polygon<double>*> SvgRenderer::getStations() const {
+  std::vector<const Polygon<double>*> ret;
+  for (const auto& ng : _nodeGeoms) {
+    for (const auto& geom : ng.stops) ret.push_back(&geom);
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________
+const std::vector<EndMarker>& SvgRenderer::getMarkers() const {
+  return _markers;
+}
+
+// _____________________________________________________________________________
+void SvgRenderer::outputNodes(const RenderGraph& outG,
+                              const RenderParams& rparams) {
+  UNUSED(outG);
+  std::map<std::string, std::string> params;
+  params["stroke"] = "black";
+  params["stroke-width"] =
+      util::toString((_cfg->lineWidth / 2) * _cfg->outputResolution);
+  params["fill"] = "white";
+
+  _w.openTag("g");
+  for (const auto& ng : _nodeGeoms) {
+    for (const auto& geom : ng.stops) printPolygon(geom, params, rparams);
+  }
   _w.closeTag();
 }
 
@@ -212,8 +275,7 @@ void SvgRenderer::renderNodeFronts(const RenderGraph& outG,
 }
 
 // _____________________________________________________________________________
-void SvgRenderer::outputEdges(const RenderGraph& outG,
-                              const RenderParams& rparams) {
+void SvgRenderer::outputEdges(const RenderGraph& outG) {
   struct cmp {
     bool operator()(const LineNode* lhs, const LineNode* rhs) const {
       return lhs->getAdjList().size() > rhs->getAdjList().size() ||
@@ -235,28 +297,62 @@ void SvgRenderer::outputEdges(const RenderGraph& outG,
   };
 
   std::set<const LineNode*, cmp> nodesOrdered;
-  std::set<const shared::linegraph::LineEdge*, cmpEdge> edgesOrdered;
   for (auto nd : outG.getNds()) nodesOrdered.insert(nd);
 
   std::set<const shared::linegraph::LineEdge*> rendered;
+  std::vector<const shared::linegraph::LineEdge*> edges;
 
+  // edges are rendered at their first node in the above order, edges
+  // first rendered at the same node by their number of lines
   for (const auto n : nodesOrdered) {
-    edgesOrdered.insert(n->getAdjList().begin(), n->getAdjList().end());
+    std::set<const shared::linegraph::LineEdge*, cmpEdge> edgesOrdered;
+    for (auto e : n->getAdjList()) {
+      if (!rendered.count(e)) edgesOrdered.insert(e);
+    }
 
     for (const auto* e : edgesOrdered) {
-      if (rendered.insert(e).second) renderEdgeTripGeom(outG, e, rparams);
+      rendered.insert(e);
+      edges.push_back(e);
     }
   }
+
+  std::vector<std::vector<EdgeLinePart>> parts(edges.size());
+
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 16)
+  for (size_t i = 0; i < edges.size(); i++) {
+    renderEdgeTripGeom(outG, edges[i], &parts[i]);
+  }
+
+  for (const auto& edgeParts : parts) {
+    for (const auto& part : edgeParts) renderLinePart(part);
+  }
+
+  // the part rendered first is painted last
+  auto it = _delegates.find(0);
+  if (it != _delegates.end()) {
+    std::reverse(it->second.begin(), it->second.end());
+  }
 }
 
 // _____________________________________________________________________________
-void SvgRenderer::renderNodeConnections(const RenderGraph& outG,
-                                        const LineNode* n,
-                                        const RenderParams& rparams) {
-  UNUSED(rparams);
-  auto geoms = outG.innerGeoms(n, _cfg->innerGeometryPrecision);
+void SvgRenderer::renderNodeGeoms(const RenderGraph& outG, const LineNode* n,
+                                  NodeGeoms* geoms) const {
+  if (_cfg->renderNodeConnections) {
+    auto inner = outG.innerGeoms(n, _cfg->innerGeometryPrecision);
 
-  for (auto& clique : getInnerCliques(n, geoms, 9999)) renderClique(clique, n);
+    for (auto& clique : getInnerCliques(n, inner, 9999)) {
+      geoms->cliques.push_back(getCliqueGeoms(clique, n));
+    }
+  }
+
+  if (_cfg->renderStations && n->pl().stops().size() > 0 &&
+      n->pl().fronts().size() > 0) {
+    geoms->stops =
+        outG.getStopGeoms(n, (_cfg->lineSpacing + _cfg->lineWidth) * 0.8,
+                          _cfg->tightStations, 32);
+  }
 }
 
 // _____________________________________________________________________________
@@ -368,9 +464,9 @@ bool SvgRenderer::hasSameOrigin(const InnerGeom& a, const InnerGeom& b) const {
 }
 
 // _____________________________________________________________________________
-void SvgRenderer::renderClique(const InnerClique& cc, const LineNode* n) {
-  _innerDelegates.push_back(
-      std::map<uintptr_t, std::vector<OutlinePrintPair>>());
+std::vector<InnerLinePart> SvgRenderer::getCliqueGeoms(
+    const InnerClique& cc, const LineNode* n) const {
+  std::vector<InnerLinePart> ret;
   std::multiset<InnerClique> renderCliques = getInnerCliques(n, cc.geoms, 0);
   for (const auto& c : renderCliques) {
     // the longest geom will be the ref geom
@@ -408,77 +504,75 @@ void SvgRenderer::renderClique(const InnerClique& cc, const LineNode* n) {
         }
       }
 
-      std::stringstream styleOutlineCropped;
-      styleOutlineCropped << "fill:none;stroke:#000000";
-
-      styleOutlineCropped << ";stroke-linecap:butt;stroke-width:"
-                          << (_cfg->lineWidth + _cfg->outlineWidth) *
-                                 _cfg->outputResolution;
-      Params paramsOutlineCropped;
-      paramsOutlineCropped["style"] = styleOutlineCropped.str();
-      paramsOutlineCropped["class"] += " inner-geom-outline";
-      paramsOutlineCropped["class"] += " " + getLineClass(c.geoms[i].from.line->id());
-
-      std::stringstream styleStr;
-      styleStr << "fill:none;stroke:#" << c.geoms[i].from.line->color();
-
-      styleStr << ";stroke-linecap:round;stroke-opacity:1;stroke-width:"
-               << _cfg->lineWidth * _cfg->outputResolution;
-      Params params;
-      params["style"] = styleStr.str();
-      params["class"] += " inner-geom ";
-      params["class"] += " " + getLineClass(c.geoms[i].from.line->id());
-
-      _innerDelegates.back()[(uintptr_t)c.geoms[i].from.line].push_back(
-          OutlinePrintPair(PrintDelegate(params, pl),
-                           PrintDelegate(paramsOutlineCropped, pl)));
+      ret.push_back(InnerLinePart(pl, c.geoms[i].from.line));
     }
   }
+
+  return ret;
 }
 
 // _____________________________________________________________________________
-void SvgRenderer::renderLinePart(const PolyLine<double> p, double width,
-                                 const Line& line, const std::string& css,
-                                 const std::string& oCss) {
-  renderLinePart(p, width, line, css, oCss, "");
+void SvgRenderer::renderClique(const std::vector<InnerLinePart>& parts) {
+  _innerDelegates.push_back(
+      std::map<uintptr_t, std::vector<OutlinePrintPair>>());
+
+  for (const auto& part : parts) {
+    std::stringstream styleOutlineCropped;
+    styleOutlineCropped << "fill:none;stroke:#000000";
+
+    styleOutlineCropped << ";stroke-linecap:butt;stroke-width:"
+                        << (_cfg->lineWidth + _cfg->outlineWidth) *
+                               _cfg->outputResolution;
+
+    std::stringstream styleStr;
+    styleStr << "fill:none;stroke:#" << part.line->color();
+
+    styleStr << ";stroke-linecap:round;stroke-opacity:1;stroke-width:"
+             << _cfg->lineWidth * _cfg->outputResolution;
+
+    std::string lineCls = getLineClass(part.line->id());
+
+    _innerDelegates.back()[(uintptr_t)part.line].push_back(OutlinePrintPair(
+        PrintDelegate(" inner-geom  " + lineCls, styleStr.str(), part.geom),
+        PrintDelegate(" inner-geom-outline " + lineCls,
+                      styleOutlineCropped.str(), part.geom)));
+  }
 }
 
 // _____________________________________________________________________________
-void SvgRenderer::renderLinePart(const PolyLine<double> p, double width,
-                                 const Line& line, const std::string& css,
-                                 const std::string& oCss,
-                                 const std::string& endMarker) {
+void SvgRenderer::renderLinePart(const EdgeLinePart& part) {
+  double width = _cfg->lineWidth;
+
   std::stringstream styleOutline;
   styleOutline << "fill:none;stroke:#000000;stroke-linecap:round;stroke-width:"
                << (width + _cfg->outlineWidth) * _cfg->outputResolution << ";"
-               << oCss;
-  Params paramsOutline;
-  paramsOutline["style"] = styleOutline.str();
-  paramsOutline["class"] = "transit-edge-outline " + getLineClass(line.id());
+               << part.oCss;
 
   std::stringstream styleStr;
-  styleStr << "fill:none;stroke:#" << line.color() << ";" << css;
+  styleStr << "fill:none;stroke:#" << part.line->color() << ";" << part.css;
 
-  if (!endMarker.empty()) {
-    styleStr << ";marker-end:url(#" << endMarker << ")";
+  if (!part.endMarker.empty()) {
+    _markers.push_back(EndMarker(part.endMarker, "white",
+                                 getMarkerPathMale(width), width, width));
+    styleStr << ";marker-end:url(#" << part.endMarker << ")";
   }
 
   styleStr << ";stroke-linecap:round;stroke-opacity:1;stroke-width:"
            << width * _cfg->outputResolution;
-  Params params;
-  params["style"] = styleStr.str();
-  params["class"] = "transit-edge " + getLineClass(line.id());
 
-  _delegates[0].insert(_delegates[0].begin(),
-                       OutlinePrintPair(PrintDelegate(params, p),
-                                        PrintDelegate(paramsOutline, p)));
+  std::string lineCls = getLineClass(part.line->id());
+
+  _delegates[0].push_back(OutlinePrintPair(
+      PrintDelegate("transit-edge " + lineCls, styleStr.str(), part.geom,
+                    part.endMarker),
+      PrintDelegate("transit-edge-outline " + lineCls, styleOutline.str(),
+                    part.geom)));
 }
 
 // _____________________________________________________________________________
 void SvgRenderer::renderEdgeTripGeom(const RenderGraph& outG,
                                      const shared::linegraph::LineEdge* e,
-                                     const RenderParams& rparams) {
-  UNUSED(rparams);
+                                     std::vector<EdgeLinePart>* parts) const {
   const shared::linegraph::NodeFront* nfTo = e->getTo()->pl().frontFor(e);
   const shared::linegraph::NodeFront* nfFrom = e->getFrom()->pl().frontFor(e);
 
@@ -535,27 +629,22 @@ void SvgRenderer::renderEdgeTripGeom(const RenderGraph& outG,
       std::stringstream markerName;
       markerName << e << ":" << line << ":" << i;
 
-      std::string markerPathMale = getMarkerPathMale(lineW);
-      EndMarker emm(markerName.str() + "_m", "white", markerPathMale, lineW,
-                    lineW);
-
-      _markers.push_back(emm);
-
       PolyLine<double> firstPart = p.getSegmentAtDist(0, p.getLength() / 2);
       PolyLine<double> secondPart =
           p.getSegmentAtDist(p.getLength() / 2, p.getLength());
 
       if (lo.direction == e->getTo()) {
-        renderLinePart(firstPart, lineW, *line, css, oCss,
-                       markerName.str() + "_m");
-        renderLinePart(secondPart.reversed(), lineW, *line, css, oCss);
+        parts->push_back(EdgeLinePart(firstPart, line, css, oCss,
+                                      markerName.str() + "_m"));
+        parts->push_back(
+            EdgeLinePart(secondPart.reversed(), line, css, oCss, ""));
       } else {
-        renderLinePart(secondPart.reversed(), lineW, *line, css, oCss,
-                       markerName.str() + "_m");
-        renderLinePart(firstPart, lineW, *line, css, oCss);
+        parts->push_back(EdgeLinePart(secondPart.reversed(), line, css, oCss,
+                                      markerName.str() + "_m"));
+        parts->push_back(EdgeLinePart(firstPart, line, css, oCss, ""));
       }
     } else {
-      renderLinePart(p, lineW, *line, css, oCss);
+      parts->push_back(EdgeLinePart(p, line, css, oCss, ""));
     }
 
     a++;
@@ -578,9 +667,9 @@ void SvgRenderer::renderDelegates(const RenderGraph& outG,
     _w.openTag("g");
     for (auto& pd : a.second) {
       if (_cfg->outlineWidth > 0) {
-        printLine(pd.back.second, pd.back.first, rparams);
+        printLine(pd.back.geom, pd.back.cls, pd.back.style, rparams);
       }
-      printLine(pd.front.second, pd.front.first, rparams);
+      printLine(pd.front.geom, pd.front.cls, pd.front.style, rparams);
     }
     _w.closeTag();
   }
@@ -590,11 +679,11 @@ void SvgRenderer::renderDelegates(const RenderGraph& outG,
     for (auto& b : a) {
       for (auto& pd : b.second) {
         if (_cfg->outlineWidth > 0) {
-          printLine(pd.back.second, pd.back.first, rparams);
+          printLine(pd.back.geom, pd.back.cls, pd.back.style, rparams);
         }
       }
       for (auto& pd : b.second) {
-        printLine(pd.front.second, pd.front.first, rparams);
+        printLine(pd.front.geom, pd.front.cls, pd.front.style, rparams);
       }
     }
     _w.closeTag();
@@ -604,41 +693,44 @@ void SvgRenderer::renderDelegates(const RenderGraph& outG,
 // _____________________________________________________________________________
 void SvgRenderer::printPoint(const DPoint& p, const std::string& style,
                              const RenderParams& rparams) {
-  std::map<std::string, std::string> params;
-  params["cx"] =
-      std::to_string((p.getX() - rparams.xOff) * _cfg->outputResolution);
-  params["cy"] = std::to_string(rparams.height - (p.getY() - rparams.yOff) *
-                                                     _cfg->outputResolution);
-  params["r"] = "2";
-  params["style"] = style;
-  _w.openTag("circle", params);
+  _w.openTag("circle");
+  _w.attr("cx", (p.getX() - rparams.xOff) * _cfg->outputResolution,
+          COORD_DIGITS);
+  _w.attr("cy",
+          rparams.height - (p.getY() - rparams.yOff) * _cfg->outputResolution,
+          COORD_DIGITS);
+  _w.attr("r", "2");
+  _w.attr("style", style);
   _w.closeTag();
 }
 
 // _____________________________________________________________________________
 void SvgRenderer::printLine(const PolyLine<double>& l, const std::string& style,
                             const RenderParams& rparams) {
-  std::map<std::string, std::string> params;
-  params["style"] = style;
-  printLine(l, params, rparams);
+  _w.openTag("polyline");
+  _w.attr("style", style);
+  writePoints(l.getLine(), rparams);
+  _w.closeTag();
+}
+
+// _____________________________________________________________________________
+void SvgRenderer::printLine(const PolyLine<double>& l, const std::string& cls,
+                            const std::string& style,
+                            const RenderParams& rparams) {
+  _w.openTag("polyline");
+  _w.attr("class", cls);
+  _w.attr("style", style);
+  writePoints(l.getLine(), rparams);
+  _w.closeTag();
 }
 
 // _____________________________________________________________________________
 void SvgRenderer::printLine(const PolyLine<double>& l,
                             const std::map<std::string, std::string>& ps,
                             const RenderParams& rparams) {
-  std::map<std::string, std::string> params = ps;
-  std::stringstream points;
-
-  for (auto& p : l.getLine()) {
-    points << " " << (p.getX() - rparams.xOff) * _cfg->outputResolution << ","
-           << rparams.height -
-                  (p.getY() - rparams.yOff) * _cfg->outputResolution;
-  }
-
-  params["points"] = points.str();
-
-  _w.openTag("polyline", params);
+  _w.openTag("polyline");
+  for (const auto& kv : ps) _w.attr(kv.first.c_str(), kv.second);
+  writePoints(l.getLine(), rparams);
   _w.closeTag();
 }
 
@@ -646,19 +738,12 @@ void SvgRenderer::printLine(const PolyLine<double>& l,
 void SvgRenderer::printPolygon(const Polygon<double>& g,
                                const std::map<std::string, std::string>& ps,
                                const RenderParams& rparams) {
-  std::map<std::string, std::string> params = ps;
-  std::stringstream points;
-
-  for (auto& p : g.getOuter()) {
-    points << " " << (p.getX() - rparams.xOff) * _cfg->outputResolution << ","
-           << rparams.height -
-                  (p.getY() - rparams.yOff) * _cfg->outputResolution;
+  _w.openTag("polygon");
+  for (const auto& kv : ps) {
+    if (kv.first != "class") _w.attr(kv.first.c_str(), kv.second);
   }
-
-  params["points"] = points.str();
-  params["class"] = "station-poly";
-
-  _w.openTag("polygon", params);
+  _w.attr("class", "station-poly");
+  writePoints(g.getOuter(), rparams);
   _w.closeTag();
 }
 
@@ -675,17 +760,70 @@ void SvgRenderer::printCircle(const DPoint& center, double rad,
 void SvgRenderer::printCircle(const DPoint& center, double rad,
                               const std::map<std::string, std::string>& ps,
                               const RenderParams& rparams) {
-  std::map<std::string, std::string> params = ps;
-  std::stringstream points;
+  _w.openTag("circle");
+  for (const auto& kv : ps) {
+    if (kv.first != "cx" && kv.first != "cy" && kv.first != "r") {
+      _w.attr(kv.first.c_str(), kv.second);
+    }
+  }
+  _w.attr("cx", (center.getX() - rparams.xOff) * _cfg->outputResolution,
+          COORD_DIGITS);
+  _w.attr("cy",
+          rparams.height -
+              (center.getY() - rparams.yOff) * _cfg->outputResolution,
+          COORD_DIGITS);
+  _w.attr("r", rad * _cfg->outputResolution, COORD_DIGITS);
+  _w.closeTag();
+}
 
-  params["cx"] =
-      std::to_string((center.getX() - rparams.xOff) * _cfg->outputResolution);
-  params["cy"] = std::to_string(
-      rparams.height - (center.getY() - rparams.yOff) * _cfg->outputResolution);
-  params["r"] = std::to_string(rad * _cfg->outputResolution);
+// _____________________________________________________________________________
+void SvgRenderer::writePoints(const util::geo::Line<double>& l,
+                              const RenderParams& rparams) {
+  _w.openAttr("points");
+  for (size_t i = 0; i < l.size(); i++) {
+    if (i) _w.writeAttrVal(' ');
+    _w.writeFloat((l[i].getX() - rparams.xOff) * _cfg->outputResolution,
+                  COORD_DIGITS);
+    _w.writeAttrVal(',');
+    _w.writeFloat(rparams.height -
+                      (l[i].getY() - rparams.yOff) * _cfg->outputResolution,
+                  COORD_DIGITS);
+  }
+  _w.closeAttr();
+}
 
-  _w.openTag("circle", params);
-  _w.closeTag();
+// _____________________________________________________________________________
+void SvgRenderer::writePath(const util::geo::Line<double>& l,
+                            const RenderParams& rparams) {
+  // offsets are taken between the rounded absolute coordinates, so rounding
+  // errors do not accumulate along the path
+  double m = pow(10, COORD_DIGITS);
+  double prevX = 0, prevY = 0;
+
+  _w.openAttr("d");
+  for (size_t i = 0; i < l.size(); i++) {
+    double x =
+        std::round((l[i].getX() - rparams.xOff) * _cfg->outputResolution * m) /
+        m;
+    double y = std::round((rparams.height - (l[i].getY() - rparams.yOff) *
+                                                _cfg->outputResolution) *
+                          m) /
+               m;
+
+    if (i == 0) {
+      _w.writeAttrVal('M');
+    } else {
+      _w.writeAttrVal(i == 1 ? " l" : " ");
+    }
+
+    _w.writeFloat(x - prevX, COORD_DIGITS);
+    _w.writeAttrVal(' ');
+    _w.writeFloat(y - prevY, COORD_DIGITS);
+
+    prevX = x;
+    prevY = y;
+  }
+  _w.closeAttr();
 }
 
 // _____________________________________________________________________________
@@ -720,30 +858,13 @@ void SvgRenderer::renderStationLabels(const Labeller& labeller,
       textPath.reverse();
     }
 
-    std::stringstream points;
-    std::map<std::string, std::string> pathPars;
-
-    points << "M"
-           << (textPath.front().getX() - rparams.xOff) * _cfg->outputResolution
-           << " "
-           << rparams.height - (textPath.front().getY() - rparams.yOff) *
-                                   _cfg->outputResolution;
-
-    for (auto& p : textPath.getLine()) {
-      points << " L" << (p.getX() - rparams.xOff) * _cfg->outputResolution
-             << " "
-             << rparams.height -
-                    (p.getY() - rparams.yOff) * _cfg->outputResolution;
-    }
-
     std::string idStr = "stlblp" + util::toString(id);
-
-    pathPars["d"] = points.str();
-    pathPars["id"] = idStr;
     id++;
 
     _w.openTag("defs");
-    _w.openTag("path", pathPars);
+    _w.openTag("path");
+    _w.attr("id", idStr);
+    writePath(textPath.getLine(), rparams);
     _w.closeTag();
     _w.closeTag();
 
@@ -783,30 +904,13 @@ void SvgRenderer::renderLineLabels(const Labeller& labeller,
       textPath.reverse();
     }
 
-    std::stringstream points;
-    std::map<std::string, std::string> pathPars;
-
-    points << "M"
-           << (textPath.front().getX() - rparams.xOff) * _cfg->outputResolution
-           << " "
-           << rparams.height - (textPath.front().getY() - rparams.yOff) *
-                                   _cfg->outputResolution;
-
-    for (auto& p : textPath.getLine()) {
-      points << " L" << (p.getX() - rparams.xOff) * _cfg->outputResolution
-             << " "
-             << rparams.height -
-                    (p.getY() - rparams.yOff) * _cfg->outputResolution;
-    }
-
     std::string idStr = "textp" + util::toString(id);
-
-    pathPars["d"] = points.str();
-    pathPars["id"] = idStr;
     id++;
 
     _w.openTag("defs");
-    _w.openTag("path", pathPars);
+    _w.openTag("path");
+    _w.attr("id", idStr);
+    writePath(textPath.getLine(), rparams);
     _w.closeTag();
     _w.closeTag();
 
@@ -67,7 +67,23 @@ struct EndMarker {
 };
 
 typedef std::map<std::string, std::string> Params;
-typedef std::pair<Params, util::geo::PolyLine<double>> PrintDelegate;
+
+struct PrintDelegate {
+  PrintDelegate(const std::string& cls, const std::string& style,
+                const util::geo::PolyLine<double>& geom)
+      : cls(cls), style(style), geom(geom) {}
+  PrintDelegate(const std::string& cls, const std::string& style,
+                const util::geo::PolyLine<double>& geom,
+                const std::string& marker)
+      : cls(cls), style(style), geom(geom), marker(marker) {}
+
+  std::string cls;
+  std::string style;
+  util::geo::PolyLine<double> geom;
+
+  // name of the end marker referenced in style, if any
+  std::string marker;
+};
 
 struct OutlinePrintPair {
   OutlinePrintPair(PrintDelegate front, PrintDelegate back)
@@ -77,6 +93,35 @@ struct OutlinePrintPair {
   PrintDelegate back;
 };
 
+// a single line of an edge, generated in the geometry phase
+struct EdgeLinePart {
+  EdgeLinePart(const util::geo::PolyLine<double>& geom,
+               const shared::linegraph::Line* line, const std::string& css,
+               const std::string& oCss, const std::string& endMarker)
+      : geom(geom), line(line), css(css), oCss(oCss), endMarker(endMarker) {}
+  util::geo::PolyLine<double> geom;
+  const shared::linegraph::Line* line;
+  std::string css;
+  std::string oCss;
+  std::string endMarker;
+};
+
+// a single inner connection geometry of a node
+struct InnerLinePart {
+  InnerLinePart(const util::geo::PolyLine<double>& geom,
+                const shared::linegraph::Line* line)
+      : geom(geom), line(line) {}
+  util::geo::PolyLine<double> geom;
+  const shared::linegraph::Line* line;
+};
+
+// the geometries of a single node, generated in the geometry phase
+struct NodeGeoms {
+  // inner connections, grouped by clique
+  std::vector<std::vector<InnerLinePart>> cliques;
+  std::vector<util::geo::Polygon<double>> stops;
+};
+
 class SvgRenderer : public Renderer {
  public:
   SvgRenderer(std::ostream* o, const config::Config* cfg);
@@ -84,11 +129,25 @@ class SvgRenderer : public Renderer {
 
   virtual void print(const shared::rendergraph::RenderGraph& outputGraph);
 
+  // generate the edge and inner node connection geometries of outputGraph
+  // without writing anything
+  void prepare(const shared::rendergraph::RenderGraph& outputGraph);
+
+  // the geometries generated by prepare(), in painting order
+  std::vector<const PrintDelegate*> getDelegates() const;
+
+  // the station polygons generated by prepare(), in painting order
+  std::vector<const util::geo::Polygon<double>*> getStations() const;
+
+  const std::vector<EndMarker>& getMarkers() const;
+
   void printLine(const util::geo::PolyLine<double>& l,
                  const std::map<std::string, std::string>& ps,
                  const RenderParams& params);
   void printLine(const util::geo::PolyLine<double>& l, const std::string& style,
                  const RenderParams& params);
+  void printLine(const util::geo::PolyLine<double>& l, const std::string& cls,
+                 const std::string& style, const RenderParams& params);
   void printPoint(const util::geo::DPoint& p, const std::string& style,
                   const RenderParams& params);
   void printPolygon(const util::geo::Polygon<double>& g,
@@ -110,32 +169,23 @@ class SvgRenderer : public Renderer {
   std::vector<std::map<uintptr_t, std::vector<OutlinePrintPair>>>
       _innerDelegates;
   std::vector<EndMarker> _markers;
+  std::vector<NodeGeoms> _nodeGeoms;
   mutable std::map<std::string, int> lineClassIds;
   mutable int lineClassId = 0;
 
   void outputNodes(const shared::rendergraph::RenderGraph& outputGraph,
                    const RenderParams& params);
-  void outputEdges(const shared::rendergraph::RenderGraph& outputGraph,
-                   const RenderParams& params);
+  void outputEdges(const shared::rendergraph::RenderGraph& outputGraph);
 
   void renderEdgeTripGeom(const shared::rendergraph::RenderGraph& outG,
                           const shared::linegraph::LineEdge* e,
-                          const RenderParams& params);
-
-  void renderNodeConnections(const shared::rendergraph::RenderGraph& outG,
-                             const shared::linegraph::LineNode* n,
-                             const RenderParams& params);
+                          std::vector<EdgeLinePart>* parts) const;
 
-  void renderLinePart(const util::geo::PolyLine<double> p, double width,
-                      const shared::linegraph::Line& line,
-                      const std::string& css,
-                      const std::string& oCss);
+  void renderNodeGeoms(const shared::rendergraph::RenderGraph& outG,
+                       const shared::linegraph::LineNode* n,
+                       NodeGeoms* geoms) const;
 
-  void renderLinePart(const util::geo::PolyLine<double> p, double width,
-                      const shared::linegraph::Line& line,
-                      const std::string& css,
-                      const std::string& oCss,
-                      const std::string& endMarker);
+  void renderLinePart(const EdgeLinePart& part);
 
   void renderDelegates(const shared::rendergraph::RenderGraph& outG,
                        const RenderParams& params);
@@ -153,8 +203,10 @@ class SvgRenderer : public Renderer {
       const shared::linegraph::LineNode* n,
       std::vector<shared::rendergraph::InnerGeom> geoms, size_t level) const;
 
-  void renderClique(const InnerClique& c,
-                    const shared::linegraph::LineNode* node);
+  std::vector<InnerLinePart> getCliqueGeoms(
+      const InnerClique& c, const shared::linegraph::LineNode* node) const;
+
+  void renderClique(const std::vector<InnerLinePart>& parts);
 
   bool isNextTo(const shared::rendergraph::InnerGeom& a,
                 const shared::rendergraph::InnerGeom& b) const;
@@ -167,6 +219,13 @@ class SvgRenderer : public Renderer {
 
   std::string getLineClass(const std::string& id) const;
 
+  // write the "points" attribute of a polyline or polygon
+  void writePoints(const util::geo::Line<double>& l,
+                   const RenderParams& params);
+
+  // write the "d" attribute of a path, in relative coordinates
+  void writePath(const util::geo::Line<double>& l, const RenderParams& params);
+
   std::string getMarkerPathMale(double w) const;
   std::string getMarkerPathFemale(double w) const;
 };
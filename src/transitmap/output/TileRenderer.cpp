@@ -0,0 +1,325 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include "shared/rendergraph/RenderGraph.h"
+#include "transitmap/output/SvgRenderer.h"
+#include "transitmap/output/TileRenderer.h"
+#include "util/String.h"
+#include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+
+using shared::rendergraph::RenderGraph;
+using transitmapper::output::EndMarker;
+using transitmapper::output::PrintDelegate;
+using transitmapper::output::SvgRenderer;
+using transitmapper::output::SvgRendererException;
+using transitmapper::output::TileFeature;
+using transitmapper::output::TilePart;
+using transitmapper::output::TileRenderer;
+using util::geo::DBox;
+using util::geo::DLine;
+using util::geo::DPoint;
+
+// half the width of the web mercator world
+const static double WEB_MERC_EXT = 20037508.342789244;
+
+// tile width and height in pixels
+const static double TILE_PX = 256;
+
+// number of decimal digits of output coordinates
+const static size_t COORD_DIGITS = 2;
+
+// _____________________________________________________________________________
+TileRenderer::TileRenderer(const config::Config* cfg) : _cfg(cfg) {}
+
+// _____________________________________________________________________________
+void TileRenderer::print(const RenderGraph& outG) {
+  if (_cfg->renderLabels) {
+    LOG(WARN) << "Labels are not rendered into tiles.";
+  }
+
+  // prepare() only generates the geometries, nothing is written to the
+  // stream
+  SvgRenderer svg(0, _cfg);
+  svg.prepare(outG);
+
+  // all features in painting order, stations are painted above the lines
+  std::vector<TileFeature> feats;
+  for (auto d : svg.getDelegates()) {
+    if (d->geom.getLine().size() < 2) continue;
+    feats.push_back(
+        TileFeature(d, 0, util::geo::getBoundingBox(d->geom.getLine())));
+  }
+  for (auto st : svg.getStations()) {
+    feats.push_back(TileFeature(0, st, util::geo::getBoundingBox(*st)));
+  }
+
+  if (feats.empty()) return;
+
+  std::map<std::string, const EndMarker*> markers;
+  for (const auto& m : svg.getMarkers()) markers[m.name] = &m;
+
+  DBox box;
+  for (const auto& f : feats) box = util::geo::extendBox(f.box, box);
+
+  // index the features once, the cell size is that of the highest zoom
+  // level tiles, but the grid is kept reasonably small
+  double cellSize =
+      std::max(getTileSize(_cfg->tileZoomMax),
+               std::max(box.getUpperRight().getX() - box.getLowerLeft().getX(),
+                        box.getUpperRight().getY() -
+                            box.getLowerLeft().getY()) /
+                   512);
+  TileGrid grid(cellSize, cellSize, box, false);
+  for (size_t i = 0; i < feats.size(); i++) grid.add(feats[i].box, i);
+
+  mkdir(_cfg->tileDir.c_str(), 0755);
+
+  struct TileId {
+    size_t z, x, y;
+  };
+  std::vector<TileId> tiles;
+
+  for (size_t z = _cfg->tileZoomMin; z <= _cfg->tileZoomMax; z++) {
+    mkdir((_cfg->tileDir + "/" + util::toString(z)).c_str(), 0755);
+
+    double size = getTileSize(z);
+    double maxT = (size_t(1) << z) - 1;
+
+    // only tiles which may contain any geometry after buffering
+    DBox bbox = util::geo::pad(box, _cfg->tileBuffer * size / TILE_PX +
+                                        _cfg->lineWidth + _cfg->outlineWidth);
+
+    size_t xFrom = std::max(
+        0.0, floor((bbox.getLowerLeft().getX() + WEB_MERC_EXT) / size));
+    size_t xTo = std::min(
+        maxT, floor((bbox.getUpperRight().getX() + WEB_MERC_EXT) / size));
+    size_t yFrom = std::max(
+        0.0, floor((WEB_MERC_EXT - bbox.getUpperRight().getY()) / size));
+    size_t yTo = std::min(
+        maxT, floor((WEB_MERC_EXT - bbox.getLowerLeft().getY()) / size));
+
+    for (size_t x = xFrom; x <= xTo; x++) {
+      for (size_t y = yFrom; y <= yTo; y++) tiles.push_back({z, x, y});
+    }
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Rendering " << feats.size() << " features into "
+                          << "up to " << tiles.size() << " tiles...";
+
+  size_t threads = _cfg->threads ? _cfg->threads : omp_get_max_threads();
+  size_t written = 0;
+  std::exception_ptr err;
+
+  // tiles are independent and only read the features and the index
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 16) \
+    reduction(+ : written)
+  for (size_t i = 0; i < tiles.size(); i++) {
+    try {
+      written += renderTile(tiles[i].z, tiles[i].x, tiles[i].y, feats, grid,
+                            markers);
+    } catch (...) {
+#pragma omp critical(transitmap_tile_err)
+      if (!err) err = std::current_exception();
+    }
+  }
+
+  if (err) std::rethrow_exception(err);
+
+  LOGTO(DEBUG, std::cerr) << "Wrote " << written << " tiles.";
+}
+
+// _____________________________________________________________________________
+double TileRenderer::getTileSize(size_t z) const {
+  return 2 * WEB_MERC_EXT / (size_t(1) << z);
+}
+
+// _____________________________________________________________________________
+DBox TileRenderer::getTileBox(size_t z, size_t x, size_t y) const {
+  double size = getTileSize(z);
+  return DBox(DPoint(-WEB_MERC_EXT + x * size, WEB_MERC_EXT - (y + 1) * size),
+              DPoint(-WEB_MERC_EXT + (x + 1) * size, WEB_MERC_EXT - y * size));
+}
+
+// _____________________________________________________________________________
+std::vector<DLine> TileRenderer::clip(const DLine& l, const DBox& box) const {
+  std::vector<DLine> ret;
+  DLine cur;
+
+  for (size_t i = 1; i < l.size(); i++) {
+    if (util::geo::intersects(util::geo::LineSegment<double>(l[i - 1], l[i]),
+                              box)) {
+      if (cur.empty()) cur.push_back(l[i - 1]);
+      cur.push_back(l[i]);
+    } else if (!cur.empty()) {
+      ret.push_back(cur);
+      cur.clear();
+    }
+  }
+
+  if (!cur.empty()) ret.push_back(cur);
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+bool TileRenderer::renderTile(
+    size_t z, size_t x, size_t y, const std::vector<TileFeature>& feats,
+    const TileGrid& grid,
+    const std::map<std::string, const EndMarker*>& markers) const {
+  double size = getTileSize(z);
+
+  // half a pixel at this zoom level
+  double simplTol = size / TILE_PX / 2;
+
+  DBox tileBox = getTileBox(z, x, y);
+  DBox clipBox = util::geo::pad(tileBox, _cfg->tileBuffer * size / TILE_PX +
+                                             _cfg->lineWidth +
+                                             _cfg->outlineWidth);
+
+  // ordered by feature id, so the painting order is kept
+  std::set<size_t> ids;
+  grid.get(clipBox, &ids);
+
+  std::vector<TilePart> parts;
+
+  for (size_t id : ids) {
+    const auto& f = feats[id];
+    if (!util::geo::intersects(f.box, clipBox)) continue;
+
+    if (f.poly) {
+      parts.push_back(TilePart(id, f.poly->getOuter()));
+      continue;
+    }
+
+    for (auto& part : clip(f.del->geom.getLine(), clipBox)) {
+      if (part.size() > 2) part = util::geo::simplify(part, simplTol);
+      parts.push_back(TilePart(id, part));
+    }
+  }
+
+  if (parts.empty()) return false;
+
+  std::string dir =
+      _cfg->tileDir + "/" + util::toString(z) + "/" + util::toString(x);
+  if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw SvgRendererException("Could not create tile directory " + dir);
+  }
+
+  std::string path = dir + "/" + util::toString(y) + ".svg";
+  std::ofstream out(path);
+  if (!out) throw SvgRendererException("Could not write tile " + path);
+
+  writeTile(&out, z, x, y, parts, feats, markers);
+
+  return true;
+}
+
+// _____________________________________________________________________________
+void TileRenderer::writeTile(
+    std::ostream* out, size_t z, size_t x, size_t y,
+    const std::vector<TilePart>& parts, const std::vector<TileFeature>& feats,
+    const std::map<std::string, const EndMarker*>& markers) const {
+  DBox tileBox = getTileBox(z, x, y);
+
+  // coordinates are in the units of the single SVG output, so the styles
+  // of the delegates can be used unchanged
+  std::string dim = util::toString(getTileSize(z) * _cfg->outputResolution);
+
+  *out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  *out << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
+          "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">";
+
+  util::xml::XmlWriter w(out);
+
+  w.openTag("svg");
+  w.attr("width", TILE_PX, 0);
+  w.attr("height", TILE_PX, 0);
+  w.attr("viewBox", "0 0 " + dim + " " + dim);
+  w.attr("xmlns", "http://www.w3.org/2000/svg");
+  w.attr("xmlns:xlink", "http://www.w3.org/1999/xlink");
+
+  std::set<std::string> usedMarkers;
+  for (const auto& p : parts) {
+    const auto& f = feats[p.feature];
+    if (f.del && !f.del->marker.empty()) usedMarkers.insert(f.del->marker);
+  }
+
+  if (usedMarkers.size()) {
+    w.openTag("defs");
+    for (const auto& name : usedMarkers) {
+      auto m = markers.find(name);
+      if (m == markers.end()) continue;
+
+      w.openTag("marker");
+      w.attr("id", m->second->name);
+      w.attr("markerHeight", "4");
+      w.attr("markerWidth", "20");
+      w.attr("orient", "auto");
+      w.attr("refX", "0");
+      w.attr("refY", "0.5");
+      w.openTag("path");
+      w.attr("d", m->second->path);
+      w.attr("fill", m->second->color);
+      w.closeTag();
+      w.closeTag();
+    }
+    w.closeTag();
+  }
+
+  std::string stWidth =
+      util::toString((_cfg->lineWidth / 2) * _cfg->outputResolution);
+
+  for (const auto& p : parts) {
+    const auto& f = feats[p.feature];
+    if (f.poly) {
+      w.openTag("polygon");
+      w.attr("fill", "white");
+      w.attr("stroke", "black");
+      w.attr("stroke-width", stWidth);
+      w.attr("class", "station-poly");
+    } else {
+      w.openTag("polyline");
+      w.attr("class", f.del->cls);
+      w.attr("style", f.del->style);
+    }
+    writePoints(&w, p.geom, tileBox);
+    w.closeTag();
+  }
+
+  w.closeTags();
+}
+
+// _____________________________________________________________________________
+void TileRenderer::writePoints(util::xml::XmlWriter* w, const DLine& l,
+                               const DBox& tileBox) const {
+  double xOff = tileBox.getLowerLeft().getX();
+  double yOff = tileBox.getUpperRight().getY();
+
+  w->openAttr("points");
+  for (size_t i = 0; i < l.size(); i++) {
+    if (i) w->writeAttrVal(' ');
+    w->writeFloat((l[i].getX() - xOff) * _cfg->outputResolution,
+                  COORD_DIGITS);
+    w->writeAttrVal(',');
+    w->writeFloat((yOff - l[i].getY()) * _cfg->outputResolution,
+                  COORD_DIGITS);
+  }
+  w->closeAttr();
+}
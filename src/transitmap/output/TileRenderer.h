@@ -0,0 +1,83 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef TRANSITMAP_OUTPUT_TILERENDERER_H_
+#define TRANSITMAP_OUTPUT_TILERENDERER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Renderer.h"
+#include "shared/rendergraph/RenderGraph.h"
+#include "transitmap/config/TransitMapConfig.h"
+#include "transitmap/output/SvgRenderer.h"
+#include "util/geo/Geo.h"
+#include "util/geo/Grid.h"
+#include "util/xml/XmlWriter.h"
+
+namespace transitmapper {
+namespace output {
+
+// a single geometry to be painted into tiles, either a line delegate or a
+// station polygon
+struct TileFeature {
+  TileFeature(const PrintDelegate* del, const util::geo::DPolygon* poly,
+              const util::geo::DBox& box)
+      : del(del), poly(poly), box(box) {}
+  const PrintDelegate* del;
+  const util::geo::DPolygon* poly;
+  util::geo::DBox box;
+};
+
+// a feature clipped to a single tile
+struct TilePart {
+  TilePart(size_t feature, const util::geo::DLine& geom)
+      : feature(feature), geom(geom) {}
+  size_t feature;
+  util::geo::DLine geom;
+};
+
+typedef util::geo::Grid<size_t, util::geo::Box, double> TileGrid;
+
+// Renders web mercator z/x/y SVG tiles. The geometries are generated and
+// indexed only once, each tile then only contains the geometries clipped
+// to its buffered extent, simplified to the tile's pixel size.
+class TileRenderer : public Renderer {
+ public:
+  explicit TileRenderer(const config::Config* cfg);
+  virtual ~TileRenderer(){};
+
+  virtual void print(const shared::rendergraph::RenderGraph& outputGraph);
+
+ private:
+  const config::Config* _cfg;
+
+  // width and height of a tile at zoom level z, in web mercator units
+  double getTileSize(size_t z) const;
+
+  // extent of tile x, y at zoom level z
+  util::geo::DBox getTileBox(size_t z, size_t x, size_t y) const;
+
+  // the parts of l which intersect box, segments crossing the box border
+  // are kept whole
+  std::vector<util::geo::DLine> clip(const util::geo::DLine& l,
+                                     const util::geo::DBox& box) const;
+
+  // render tile x, y at zoom level z, returns false if the tile is empty
+  bool renderTile(size_t z, size_t x, size_t y,
+                  const std::vector<TileFeature>& feats, const TileGrid& grid,
+                  const std::map<std::string, const EndMarker*>& markers) const;
+
+  void writeTile(std::ostream* out, size_t z, size_t x, size_t y,
+                 const std::vector<TilePart>& parts,
+                 const std::vector<TileFeature>& feats,
+                 const std::map<std::string, const EndMarker*>& markers) const;
+
+  void writePoints(util::xml::XmlWriter* w, const util::geo::DLine& l,
+                   const util::geo::DBox& tileBox) const;
+};
+}  // namespace output
+}  // namespace transitmapper
+
+#endif  // TRANSITMAP_OUTPUT_TILERENDERER_H_
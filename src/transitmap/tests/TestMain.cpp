@@ -1,12 +1,15 @@
 // Copyright 2016
 // Author: Patrick Brosi
 
+#include "transitmap/tests/TileRendererTest.h"
+
 #include "util/Misc.h"
 
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
+  TileRendererTest trt;
 
-  return 0;
+  trt.run();
 }
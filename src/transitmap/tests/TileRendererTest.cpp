@@ -0,0 +1,97 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "shared/rendergraph/RenderGraph.h"
+#include "transitmap/TransitMap.h"
+#include "transitmap/config/TransitMapConfig.h"
+#include "transitmap/tests/TileRendererTest.h"
+#include "util/Misc.h"
+#include "util/String.h"
+
+namespace {
+
+// a single edge from (1000, 1000) to (7000, 7000), just north east of the
+// web mercator origin
+const char* GRAPH =
+    "{\"type\":\"FeatureCollection\",\"features\":["
+    "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\","
+    "\"coordinates\":[1000,1000]},\"properties\":{\"id\":\"a\","
+    "\"station_id\":\"a\",\"station_label\":\"A\"}},"
+    "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\","
+    "\"coordinates\":[7000,7000]},\"properties\":{\"id\":\"b\","
+    "\"station_id\":\"b\",\"station_label\":\"B\"}},"
+    "{\"type\":\"Feature\",\"geometry\":{\"type\":\"LineString\","
+    "\"coordinates\":[[1000,1000],[7000,7000]]},\"properties\":{"
+    "\"from\":\"a\",\"to\":\"b\",\"id\":\"1\",\"lines\":["
+    "{\"id\":\"1\",\"color\":\"ff0000\",\"label\":\"1\"},"
+    "{\"id\":\"2\",\"color\":\"00ff00\",\"label\":\"2\"}]}}]}";
+
+// _____________________________________________________________________________
+bool exists(const std::string& path) { return access(path.c_str(), F_OK) == 0; }
+
+// _____________________________________________________________________________
+std::string read(const std::string& path) {
+  std::ifstream f(path);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+}  // namespace
+
+// _____________________________________________________________________________
+void TileRendererTest::run() {
+  std::string dir = util::getTmpDir() + "/transitmapTest.XXXXXX";
+  TEST(mkdtemp(&dir[0]) != 0);
+
+  transitmapper::config::Config cfg;
+  cfg.tileDir = dir;
+  cfg.tileZoomMin = 12;
+  cfg.tileZoomMax = 13;
+
+  std::stringstream ss(GRAPH);
+  shared::rendergraph::RenderGraph g(cfg.lineWidth, cfg.lineSpacing);
+  g.readFromJson(&ss, cfg.inputSmoothing);
+
+  std::stringstream out;
+  transitmapper::run(&cfg, &g, &out);
+
+  // nothing is written to the stream in tile mode
+  TEST(out.str().size(), ==, 0);
+
+  // at zoom level 12, the edge and its buffer lie in a single tile
+  TEST(exists(dir + "/12/2048/2047.svg"));
+  TEST(!exists(dir + "/12/2047/2047.svg"));
+  TEST(!exists(dir + "/12/2048/2048.svg"));
+  TEST(!exists(dir + "/12/2047/2048.svg"));
+
+  // at zoom level 13, the edge crosses the shared corner of 4 tiles
+  TEST(exists(dir + "/13/4096/4095.svg"));
+  TEST(exists(dir + "/13/4097/4094.svg"));
+  TEST(exists(dir + "/13/4096/4094.svg"));
+  TEST(exists(dir + "/13/4097/4095.svg"));
+  TEST(!exists(dir + "/13/4098/4094.svg"));
+  TEST(!exists(dir + "/13/4095/4095.svg"));
+
+  // the view box covers the tile in the units of the single SVG output
+  double size = 2 * 20037508.342789244 / 4096;
+  std::string dim = util::toString(size * cfg.outputResolution);
+  std::string tile = read(dir + "/12/2048/2047.svg");
+  TEST(tile.find("viewBox=\"0 0 " + dim + " " + dim + "\"") !=
+       std::string::npos);
+  TEST(tile.find("width=\"256\"") != std::string::npos);
+  TEST(tile.find("<polyline") != std::string::npos);
+  TEST(tile.find("station-poly") != std::string::npos);
+
+  std::string tiles[] = {"12/2048/2047", "13/4096/4095", "13/4097/4094",
+                         "13/4096/4094", "13/4097/4095"};
+  for (const auto& t : tiles) unlink((dir + "/" + t + ".svg").c_str());
+  for (const auto& d : {"12/2048", "13/4096", "13/4097", "12", "13", ""}) {
+    rmdir((dir + "/" + d).c_str());
+  }
+}
@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef TRANSITMAP_TESTS_TILERENDERERTEST_H_
+#define TRANSITMAP_TESTS_TILERENDERERTEST_H_
+
+class TileRendererTest {
+ public:
+  void run();
+};
+
+#endif  // TRANSITMAP_TESTS_TILERENDERERTEST_H_
@@ -5,6 +5,7 @@
 #include <assert.h>
 #include <math.h>
 #include <cmath>
+#include <cstring>
 
 #if defined(_MSC_VER)
 #include <intrin.h>
@@ -0,0 +1,127 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Author: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef UTIL_GEO_FLATGRID_H_
+#define UTIL_GEO_FLATGRID_H_
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "util/geo/Geo.h"
+#include "util/geo/Grid.h"
+
+namespace util {
+namespace geo {
+
+// Drop-in alternative to Grid with flat cell storage. Values are mapped to
+// dense integer ids, the cells hold these ids in a single compressed (CSR)
+// array, filled by compact(), plus a small per-cell bucket for values added
+// after the last compact(). Values must be hashable.
+//
+// Apart from the std::set based queries of Grid, visit() calls a function
+// once for each value in the query area without building a result set.
+// Duplicates are filtered with per-value epoch stamps, so visit() must not be
+// called concurrently on the same grid.
+template <typename V, template <typename> class G, typename T>
+class FlatGrid {
+ public:
+  // initialization of a point grid with cell width w and cell height h
+  // that covers the area of bounding box bbox
+  FlatGrid(double w, double h, const Box<T>& bbox);
+
+  // initialization of a point grid with cell width w and cell height h
+  // that covers the area of bounding box bbox
+  // optional parameters specifies whether a value->cell index
+  // should be kept (true by default!)
+  FlatGrid(double w, double h, const Box<T>& bbox, bool buildValIdx);
+
+  // the empty grid
+  FlatGrid();
+  // the empty grid
+  FlatGrid(bool buildValIdx);
+
+  // add object t to this grid
+  void add(G<T> geom, V val);
+  void add(size_t x, size_t y, V val);
+
+  void get(const Box<T>& btbox, std::set<V>* s) const;
+  void get(const G<T>& geom, double d, std::set<V>* s) const;
+  void get(size_t x, size_t y, std::set<V>* s) const;
+  void remove(V val);
+
+  // call f(val) once for every value in the cells covered by box
+  template <typename F>
+  void visit(const Box<T>& box, F f) const;
+  template <typename F>
+  void visit(const G<T>& geom, double d, F f) const;
+
+  void getNeighbors(const V& val, double d, std::set<V>* s) const;
+  void getCellNeighbors(const V& val, size_t d, std::set<V>* s) const;
+  void getCellNeighbors(size_t x, size_t y, size_t xPerm, size_t yPerm,
+                        std::set<V>* s) const;
+
+  std::set<std::pair<size_t, size_t> > getCells(const V& val) const;
+
+  // move all cell buckets into the compressed cell array, should be called
+  // once a grid is (mostly) filled
+  void compact();
+
+  size_t getXWidth() const;
+  size_t getYHeight() const;
+
+  size_t getCellXFromX(double lon) const;
+  size_t getCellYFromY(double lat) const;
+
+ private:
+  typedef uint32_t ValId;
+
+  double _width;
+  double _height;
+
+  double _cellWidth;
+  double _cellHeight;
+
+  Box<T> _bb;
+
+  size_t _xWidth;
+  size_t _yHeight;
+
+  bool _hasValIdx;
+
+  // compressed cells, the ids of cell i are at _csr[_beg[i]] to
+  // _csr[_end[i] - 1]
+  std::vector<size_t> _beg;
+  std::vector<size_t> _end;
+  std::vector<ValId> _csr;
+
+  // values added since the last compact()
+  std::vector<std::vector<ValId> > _bucks;
+
+  std::unordered_map<V, ValId> _ids;
+  std::vector<V> _vals;
+
+  // cells of each value, only kept with a value index
+  std::vector<std::vector<size_t> > _valCells;
+
+  // values removed from a grid without value index are only flagged
+  std::vector<bool> _removed;
+
+  mutable std::vector<size_t> _stamps;
+  mutable size_t _epoch;
+
+  ValId getId(const V& val);
+  void removeFromCell(size_t cell, ValId id);
+  Box<T> getBox(size_t x, size_t y) const;
+
+  template <typename F>
+  void visitCell(size_t cell, F f) const;
+};
+
+#include "util/geo/FlatGrid.tpp"
+
+}  // namespace geo
+}  // namespace util
+
+#endif  // UTIL_GEO_FLATGRID_H_
@@ -0,0 +1,335 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Author: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+FlatGrid<V, G, T>::FlatGrid(bool bldIdx)
+    : _width(0),
+      _height(0),
+      _cellWidth(0),
+      _cellHeight(0),
+      _xWidth(0),
+      _yHeight(0),
+      _hasValIdx(bldIdx),
+      _epoch(0) {}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+FlatGrid<V, G, T>::FlatGrid() : FlatGrid<V, G, T>(true) {}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+FlatGrid<V, G, T>::FlatGrid(double w, double h, const Box<T>& bbox)
+    : FlatGrid<V, G, T>(w, h, bbox, true) {}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+FlatGrid<V, G, T>::FlatGrid(double w, double h, const Box<T>& bbox,
+                            bool bValIdx)
+    : _cellWidth(fabs(w)),
+      _cellHeight(fabs(h)),
+      _bb(bbox),
+      _hasValIdx(bValIdx),
+      _epoch(0) {
+  _width = bbox.getUpperRight().getX() - bbox.getLowerLeft().getX();
+  _height = bbox.getUpperRight().getY() - bbox.getLowerLeft().getY();
+
+  if (_width < 0 || _height < 0) {
+    _width = 0;
+    _height = 0;
+    _xWidth = 0;
+    _yHeight = 0;
+    return;
+  }
+
+  _xWidth = ceil(_width / _cellWidth);
+  _yHeight = ceil(_height / _cellHeight);
+
+  _beg.resize(_xWidth * _yHeight + 1, 0);
+  _end.resize(_xWidth * _yHeight, 0);
+  _bucks.resize(_xWidth * _yHeight);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::add(G<T> geom, V val) {
+  Box<T> box = getBoundingBox(geom);
+  size_t swX = getCellXFromX(box.getLowerLeft().getX());
+  size_t swY = getCellYFromY(box.getLowerLeft().getY());
+
+  size_t neX = getCellXFromX(box.getUpperRight().getX());
+  size_t neY = getCellYFromY(box.getUpperRight().getY());
+
+  for (size_t x = swX; x <= neX && x < _xWidth; x++) {
+    for (size_t y = swY; y <= neY && y < _yHeight; y++) {
+      if (intersects(geom, getBox(x, y))) {
+        add(x, y, val);
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::add(size_t x, size_t y, V val) {
+  ValId id = getId(val);
+  size_t cell = x * _yHeight + y;
+
+  if (_hasValIdx) {
+    // a value is stored at most once per cell
+    for (auto c : _valCells[id]) {
+      if (c == cell) return;
+    }
+    _valCells[id].push_back(cell);
+  }
+
+  _bucks[cell].push_back(id);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::get(const Box<T>& box, std::set<V>* s) const {
+  size_t swX = getCellXFromX(box.getLowerLeft().getX());
+  size_t swY = getCellYFromY(box.getLowerLeft().getY());
+
+  size_t neX = getCellXFromX(box.getUpperRight().getX());
+  size_t neY = getCellYFromY(box.getUpperRight().getY());
+
+  for (size_t x = swX; x <= neX && x < _xWidth; x++)
+    for (size_t y = swY; y <= neY && y < _yHeight; y++) get(x, y, s);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::get(const G<T>& geom, double d, std::set<V>* s) const {
+  Box<T> a = getBoundingBox(geom);
+  Box<T> b(
+      Point<T>(a.getLowerLeft().getX() - d, a.getLowerLeft().getY() - d),
+      Point<T>(a.getUpperRight().getX() + d, a.getUpperRight().getY() + d));
+  return get(b, s);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::get(size_t x, size_t y, std::set<V>* s) const {
+  visitCell(x * _yHeight + y, [&](ValId id) {
+    if (!_removed[id]) s->insert(_vals[id]);
+  });
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+template <typename F>
+void FlatGrid<V, G, T>::visit(const Box<T>& box, F f) const {
+  size_t swX = getCellXFromX(box.getLowerLeft().getX());
+  size_t swY = getCellYFromY(box.getLowerLeft().getY());
+
+  size_t neX = getCellXFromX(box.getUpperRight().getX());
+  size_t neY = getCellYFromY(box.getUpperRight().getY());
+
+  _epoch++;
+
+  for (size_t x = swX; x <= neX && x < _xWidth; x++) {
+    for (size_t y = swY; y <= neY && y < _yHeight; y++) {
+      visitCell(x * _yHeight + y, [&](ValId id) {
+        if (_stamps[id] == _epoch || _removed[id]) return;
+        _stamps[id] = _epoch;
+        f(_vals[id]);
+      });
+    }
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+template <typename F>
+void FlatGrid<V, G, T>::visit(const G<T>& geom, double d, F f) const {
+  Box<T> a = getBoundingBox(geom);
+  Box<T> b(
+      Point<T>(a.getLowerLeft().getX() - d, a.getLowerLeft().getY() - d),
+      Point<T>(a.getUpperRight().getX() + d, a.getUpperRight().getY() + d));
+  visit(b, f);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+template <typename F>
+void FlatGrid<V, G, T>::visitCell(size_t cell, F f) const {
+  for (size_t i = _beg[cell]; i < _end[cell]; i++) f(_csr[i]);
+  for (auto id : _bucks[cell]) f(id);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::remove(V val) {
+  if (_hasValIdx) {
+    auto i = _ids.find(val);
+    if (i == _ids.end()) return;
+
+    for (auto cell : _valCells[i->second]) removeFromCell(cell, i->second);
+
+    _valCells[i->second].clear();
+  } else {
+    _removed[getId(val)] = true;
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::removeFromCell(size_t cell, ValId id) {
+  for (size_t i = _beg[cell]; i < _end[cell]; i++) {
+    if (_csr[i] == id) {
+      _csr[i] = _csr[--_end[cell]];
+      return;
+    }
+  }
+
+  auto& buck = _bucks[cell];
+  for (size_t i = 0; i < buck.size(); i++) {
+    if (buck[i] == id) {
+      buck[i] = buck.back();
+      buck.pop_back();
+      return;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+typename FlatGrid<V, G, T>::ValId FlatGrid<V, G, T>::getId(const V& val) {
+  auto i = _ids.find(val);
+  if (i != _ids.end()) return i->second;
+
+  ValId id = _vals.size();
+  _ids[val] = id;
+  _vals.push_back(val);
+  _removed.push_back(false);
+  _stamps.push_back(0);
+  if (_hasValIdx) _valCells.resize(_vals.size());
+
+  return id;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::compact() {
+  size_t numCells = _xWidth * _yHeight;
+  std::vector<size_t> beg(numCells + 1, 0);
+
+  for (size_t i = 0; i < numCells; i++) {
+    beg[i + 1] = beg[i] + (_end[i] - _beg[i]) + _bucks[i].size();
+  }
+
+  std::vector<ValId> csr(beg[numCells]);
+
+  for (size_t i = 0; i < numCells; i++) {
+    size_t p = beg[i];
+    for (size_t j = _beg[i]; j < _end[i]; j++) csr[p++] = _csr[j];
+    for (auto id : _bucks[i]) csr[p++] = id;
+    _end[i] = p;
+    std::vector<ValId>().swap(_bucks[i]);
+  }
+
+  _beg.swap(beg);
+  _csr.swap(csr);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::getNeighbors(const V& val, double d,
+                                     std::set<V>* s) const {
+  if (!_hasValIdx) throw GridException("No value index build!");
+  auto it = _ids.find(val);
+  if (it == _ids.end()) return;
+
+  size_t xPerm = ceil(d / _cellWidth);
+  size_t yPerm = ceil(d / _cellHeight);
+
+  for (auto cell : _valCells[it->second]) {
+    getCellNeighbors(cell / _yHeight, cell % _yHeight, xPerm, yPerm, s);
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::getCellNeighbors(const V& val, size_t d,
+                                         std::set<V>* s) const {
+  if (!_hasValIdx) throw GridException("No value index build!");
+  auto it = _ids.find(val);
+  if (it == _ids.end()) return;
+
+  for (auto cell : _valCells[it->second]) {
+    getCellNeighbors(cell / _yHeight, cell % _yHeight, d, d, s);
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void FlatGrid<V, G, T>::getCellNeighbors(size_t cx, size_t cy, size_t xPerm,
+                                         size_t yPerm, std::set<V>* s) const {
+  size_t swX = xPerm > cx ? 0 : cx - xPerm;
+  size_t swY = yPerm > cy ? 0 : cy - yPerm;
+
+  size_t neX = xPerm + cx + 1 > _xWidth ? _xWidth : cx + xPerm + 1;
+  size_t neY = yPerm + cy + 1 > _yHeight ? _yHeight : cy + yPerm + 1;
+
+  for (size_t x = swX; x < neX; x++) {
+    for (size_t y = swY; y < neY; y++) {
+      get(x, y, s);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+std::set<std::pair<size_t, size_t> > FlatGrid<V, G, T>::getCells(
+    const V& val) const {
+  if (!_hasValIdx) throw GridException("No value index build!");
+  std::set<std::pair<size_t, size_t> > ret;
+  auto it = _ids.find(val);
+  if (it == _ids.end()) return ret;
+
+  for (auto cell : _valCells[it->second]) {
+    ret.insert({cell / _yHeight, cell % _yHeight});
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+Box<T> FlatGrid<V, G, T>::getBox(size_t x, size_t y) const {
+  Point<T> sw(_bb.getLowerLeft().getX() + x * _cellWidth,
+              _bb.getLowerLeft().getY() + y * _cellHeight);
+  Point<T> ne(_bb.getLowerLeft().getX() + (x + 1) * _cellWidth,
+              _bb.getLowerLeft().getY() + (y + 1) * _cellHeight);
+  return Box<T>(sw, ne);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+size_t FlatGrid<V, G, T>::getCellXFromX(double x) const {
+  float dist = x - _bb.getLowerLeft().getX();
+  if (dist < 0) dist = 0;
+  return floor(dist / _cellWidth);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+size_t FlatGrid<V, G, T>::getCellYFromY(double y) const {
+  float dist = y - _bb.getLowerLeft().getY();
+  if (dist < 0) dist = 0;
+  return floor(dist / _cellHeight);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+size_t FlatGrid<V, G, T>::getXWidth() const {
+  return _xWidth;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+size_t FlatGrid<V, G, T>::getYHeight() const {
+  return _yHeight;
+}
@@ -5,6 +5,7 @@
 #ifndef UTIL_GEO_POLYLINE_H_
 #define UTIL_GEO_POLYLINE_H_
 
+#include <algorithm>
 #include <cfloat>
 #include <ostream>
 #include <iomanip>
@@ -49,6 +50,9 @@ struct SharedSegments {
   std::vector<SharedSegment<T>> segments;
 };
 
+// Polyline which keeps the length of the line up to each of its points, so
+// the length is O(1) and the point at some distance is found with a binary
+// search. The lengths are updated on every modification of the line.
 template <typename T>
 class PolyLine {
  public:
@@ -129,7 +133,20 @@ class PolyLine {
  private:
   std::set<LinePoint<T>, LinePointCmp<T>> getIntersections(const PolyLine& p,
                                                      size_t a, size_t b) const;
+
+  // point at [0..1], the index of the first point after it is searched
+  // linearly from *i on and written back to *i
+  LinePoint<T> getPointAt(double at, size_t* i) const;
+
+  // point at dist on the segment ending in point i
+  LinePoint<T> interpolateAt(double dist, size_t i) const;
+
+  void updateLens();
+
   Line<T> _line;
+
+  // _lens[i] is the length of the line up to point i
+  std::vector<double> _lens;
 };
 
 #include "util/geo/PolyLine.tpp"
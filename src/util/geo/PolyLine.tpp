@@ -14,12 +14,19 @@ PolyLine<T>::PolyLine(const Point<T>& from, const Point<T>& to) {
 
 // _____________________________________________________________________________
 template <typename T>
-PolyLine<T>::PolyLine(const Line<T>& l) : _line(l) {}
+PolyLine<T>::PolyLine(const Line<T>& l) : _line(l) {
+  updateLens();
+}
 
 // _____________________________________________________________________________
 template <typename T>
 PolyLine<T>& PolyLine<T>::operator<<(const Point<T>& p) {
   _line.push_back(p);
+  if (_lens.empty()) {
+    _lens.push_back(0);
+  } else {
+    _lens.push_back(_lens.back() + dist(_line[_line.size() - 2], p));
+  }
   return *this;
 }
 
@@ -27,6 +34,7 @@ PolyLine<T>& PolyLine<T>::operator<<(const Point<T>& p) {
 template <typename T>
 PolyLine<T>& PolyLine<T>::operator>>(const Point<T>& p) {
   _line.insert(_line.begin(), p);
+  updateLens();
   return *this;
 }
 
@@ -34,6 +42,7 @@ PolyLine<T>& PolyLine<T>::operator>>(const Point<T>& p) {
 template <typename T>
 void PolyLine<T>::reverse() {
   std::reverse(_line.begin(), _line.end());
+  updateLens();
 }
 
 // _____________________________________________________________________________
@@ -177,22 +186,29 @@ PolyLine<T> PolyLine<T>::getSegment(const Point<T>& a,
 template <typename T>
 PolyLine<T> PolyLine<T>::getSegment(const LinePoint<T>& start,
                                     const LinePoint<T>& end) const {
-  PolyLine ret;
-
-  ret << start.p;
-
-  if (start.lastIndex + 1 <= end.lastIndex) {
-    ret._line.insert(ret._line.end(), _line.begin() + start.lastIndex + 1,
-                     _line.begin() + end.lastIndex + 1);
+  Line<T> ret;
+  if (end.lastIndex > start.lastIndex) {
+    ret.reserve(end.lastIndex - start.lastIndex + 2);
   }
-  ret << end.p;
 
-  // find a more performant way to clear the result of above
-  ret.simplify(0);
+  // skip repeated points (start and end may coincide with points of the
+  // line) and drop points lying on the straight line between their
+  // neighbors, as simplify(0) did
+  auto add = [&ret](const Point<T>& p) {
+    if (ret.size() && ret.back() == p) return;
+    while (ret.size() > 1 &&
+           distToSegment(ret[ret.size() - 2], p, ret.back()) == 0) {
+      ret.pop_back();
+    }
+    ret.push_back(p);
+  };
 
-  assert(ret.getLine().size());
+  add(start.p);
+  for (size_t i = start.lastIndex + 1; i <= end.lastIndex; i++) add(_line[i]);
+  add(end.p);
+  if (ret.size() == 1) ret.push_back(end.p);
 
-  return ret;
+  return PolyLine(ret);
 }
 
 // _____________________________________________________________________________
@@ -211,33 +227,52 @@ LinePoint<T> PolyLine<T>::getPointAtDist(double atDist) const {
     return LinePoint<T>(_line.size() - 1, 1, _line.back());
   }
 
-  double dist = 0;
+  size_t i = std::upper_bound(_lens.begin(), _lens.end(), atDist) -
+             _lens.begin();
 
-  if (_line.size() == 1) return LinePoint<T>(0, 0, _line[0]);
+  return interpolateAt(atDist, i);
+}
 
-  const Point<T>* last = &_line[0];
+// _____________________________________________________________________________
+template <typename T>
+LinePoint<T> PolyLine<T>::getPointAt(double at) const {
+  at *= getLength();
+  return getPointAtDist(at);
+}
 
-  for (size_t i = 1; i < _line.size(); i++) {
-    const Point<T>& cur = _line[i];
-    double d = geo::dist(*last, cur);
-    dist += d;
+// _____________________________________________________________________________
+template <typename T>
+LinePoint<T> PolyLine<T>::getPointAt(double at, size_t* i) const {
+  double l = getLength();
+  double atDist = at * l;
+  if (atDist > l) atDist = l;
+  if (atDist < 0) atDist = 0;
 
-    if (dist > atDist) {
-      double p = (d - (dist - atDist));
-      return LinePoint<T>(i - 1, atDist / l, interpolate(*last, cur, p));
-    }
+  // shortcuts
+  if (atDist == 0) {
+    return LinePoint<T>(0, 0, _line.front());
+  }
 
-    last = &_line[i];
+  if (atDist == l) {
+    return LinePoint<T>(_line.size() - 1, 1, _line.back());
   }
 
-  return LinePoint<T>(_line.size() - 1, 1, _line.back());
+  while (*i < _lens.size() && _lens[*i] <= atDist) (*i)++;
+
+  return interpolateAt(atDist, *i);
 }
 
 // _____________________________________________________________________________
 template <typename T>
-LinePoint<T> PolyLine<T>::getPointAt(double at) const {
-  at *= getLength();
-  return getPointAtDist(at);
+LinePoint<T> PolyLine<T>::interpolateAt(double atDist, size_t i) const {
+  if (i >= _line.size()) {
+    return LinePoint<T>(_line.size() - 1, 1, _line.back());
+  }
+
+  double d = geo::dist(_line[i - 1], _line[i]);
+  double p = (d - (_lens[i] - atDist));
+  return LinePoint<T>(i - 1, atDist / getLength(),
+                      interpolate(_line[i - 1], _line[i], p));
 }
 
 // _____________________________________________________________________________
@@ -268,7 +303,19 @@ double PolyLine<T>::distTo(const Point<T>& p) const {
 // _____________________________________________________________________________
 template <typename T>
 double PolyLine<T>::getLength() const {
-  return len(_line);
+  if (_lens.empty()) return 0;
+  return _lens.back();
+}
+
+// _____________________________________________________________________________
+template <typename T>
+void PolyLine<T>::updateLens() {
+  _lens.resize(_line.size());
+  double l = 0;
+  for (size_t i = 0; i < _line.size(); i++) {
+    if (i > 0) l += dist(_line[i - 1], _line[i]);
+    _lens[i] = l;
+  }
 }
 
 // _____________________________________________________________________________
@@ -299,6 +346,11 @@ PolyLine<T> PolyLine<T>::average(const std::vector<const PolyLine<T>*>& lines,
 
   stepSize = AVERAGING_STEP / longestLength;
   bool end = false;
+
+  // the sample positions only increase, so the points on each line are found
+  // in a single pass over it
+  std::vector<size_t> idx(lines.size(), 1);
+
   for (double a = 0; !end; a += stepSize) {
     if (a > 1) {
       a = 1;
@@ -308,7 +360,7 @@ PolyLine<T> PolyLine<T>::average(const std::vector<const PolyLine<T>*>& lines,
 
     for (size_t i = 0; i < lines.size(); ++i) {
       const PolyLine* pl = lines[i];
-      Point<T> p = pl->getPointAt(a).p;
+      Point<T> p = pl->getPointAt(a, &idx[i]).p;
       if (weighted) {
         x += p.getX() * weights[i];
         y += p.getY() * weights[i];
@@ -403,6 +455,7 @@ LinePoint<T> PolyLine<T>::projectOnAfter(const Point<T>& p, size_t a) const {
 template <typename T>
 void PolyLine<T>::simplify(double d) {
   _line = geo::simplify(_line, d);
+  updateLens();
 }
 
 // _____________________________________________________________________________
@@ -418,6 +471,7 @@ void PolyLine<T>::smoothenOutliers(double d) {
       }
     }
   }
+  updateLens();
 }
 
 // _____________________________________________________________________________
@@ -476,6 +530,7 @@ void PolyLine<T>::move(double vx, double vy) {
     _line[i].setX(_line[i].getX() + vx);
     _line[i].setY(_line[i].getY() + vy);
   }
+  updateLens();
 }
 
 // _____________________________________________________________________________
@@ -596,6 +651,7 @@ void PolyLine<T>::fixTopology(double maxl) {
     }
     distA += dist(_line[i - 1], _line[i]);
   }
+  updateLens();
 }
 
 // _____________________________________________________________________________
@@ -621,6 +677,7 @@ void PolyLine<T>::applyChaikinSmooth(size_t depth) {
     smooth.push_back(_line.back());
     _line = smooth;
   }
+  updateLens();
 }
 
 // _____________________________________________________________________________
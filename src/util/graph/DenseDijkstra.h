@@ -0,0 +1,95 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef UTIL_GRAPH_DENSEDIJKSTRA_H_
+#define UTIL_GRAPH_DENSEDIJKSTRA_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+#include "util/graph/Edge.h"
+#include "util/graph/Node.h"
+#include "util/graph/ShortestPath.h"
+
+namespace util {
+namespace graph {
+
+// dijkstras algorithm for util graphs whose node payloads carry a dense
+// integer id (N::getId()). Distances, parents and the priority queue
+// positions are held in flat arrays indexed by that id. The arrays are kept
+// between queries and invalidated by an epoch counter, so a query only
+// touches the nodes it actually reaches.
+//
+// The cost and heuristic functions are template parameters and are called
+// directly. They have to provide the same interface as
+// util::graph::CostFunc and util::graph::HeurFunc.
+//
+// An instance must not be used by multiple threads at the same time.
+template <typename N, typename E, typename C>
+class DenseDijkstra {
+ public:
+  typedef std::vector<Edge<N, E>*> EList;
+  typedef std::vector<Node<N, E>*> NList;
+
+  DenseDijkstra() : _epoch(0), _iters(0) {}
+
+  template <typename CF, typename HF>
+  C shortestPath(const std::set<Node<N, E>*>& from,
+                 const std::set<Node<N, E>*>& to, const CF& costFunc,
+                 const HF& heurFunc, EList* resEdges, NList* resNodes);
+
+  template <typename CF, typename HF>
+  C shortestPath(Node<N, E>* from, const std::set<Node<N, E>*>& to,
+                 const CF& costFunc, const HF& heurFunc, EList* resEdges,
+                 NList* resNodes);
+
+  // number of settled nodes over all queries
+  size_t iters() const { return _iters; }
+
+ private:
+  static const size_t ARITY = 4;
+  static const size_t NONE = std::numeric_limits<size_t>::max();
+
+  struct Entry {
+    // node reached in epoch
+    uint32_t reached;
+    // node is a target in epoch
+    uint32_t target;
+
+    // position in heap, or NONE
+    size_t heapPos;
+
+    // the cost so far
+    C d;
+
+    // the heuristical remaining cost + the cost so far
+    C h;
+
+    Node<N, E>* n;
+    Edge<N, E>* parent;
+  };
+
+  std::vector<Entry> _entries;
+  std::vector<size_t> _heap;
+  uint32_t _epoch;
+  size_t _iters;
+
+  void newEpoch();
+  Entry& entry(const Node<N, E>* n);
+
+  void push(size_t id);
+  size_t pop();
+  void siftUp(size_t pos);
+  void siftDown(size_t pos);
+
+  void buildPath(size_t id, EList* resEdges, NList* resNodes) const;
+};
+
+#include "util/graph/DenseDijkstra.tpp"
+}  // namespace graph
+}  // namespace util
+
+#endif  // UTIL_GRAPH_DENSEDIJKSTRA_H_
@@ -0,0 +1,208 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+template <typename CF, typename HF>
+C DenseDijkstra<N, E, C>::shortestPath(Node<N, E>* from,
+                                       const std::set<Node<N, E>*>& to,
+                                       const CF& costFunc, const HF& heurFunc,
+                                       EList* resEdges, NList* resNodes) {
+  if (from->getOutDeg() == 0) return costFunc.inf();
+
+  std::set<Node<N, E>*> froms;
+  froms.insert(from);
+
+  return shortestPath(froms, to, costFunc, heurFunc, resEdges, resNodes);
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+template <typename CF, typename HF>
+C DenseDijkstra<N, E, C>::shortestPath(const std::set<Node<N, E>*>& from,
+                                       const std::set<Node<N, E>*>& to,
+                                       const CF& costFunc, const HF& heurFunc,
+                                       EList* resEdges, NList* resNodes) {
+  newEpoch();
+
+  for (auto n : to) entry(n).target = _epoch;
+
+  for (auto n : from) {
+    Entry& e = entry(n);
+    if (e.reached == _epoch) continue;
+    e.reached = _epoch;
+    e.d = C();
+    e.h = C();
+    e.n = n;
+    e.parent = 0;
+    push(n->pl().getId());
+  }
+
+  while (!_heap.empty()) {
+    if (costFunc.inf() <= _entries[_heap.front()].h) return costFunc.inf();
+
+    size_t curId = pop();
+    _iters++;
+
+    if (_entries[curId].target == _epoch) {
+      buildPath(curId, resEdges, resNodes);
+      return _entries[curId].d;
+    }
+
+    // entry() may grow the entries, so dont hold a reference to cur
+    Node<N, E>* curNd = _entries[curId].n;
+    C curD = _entries[curId].d;
+
+    for (auto edge : curNd->getAdjListOut()) {
+      auto toNd = edge->getOtherNd(curNd);
+
+      C newC = costFunc(curNd, edge, toNd);
+      newC = curD + newC;
+      if (newC < curD) continue;  // cost overflow!
+      if (costFunc.inf() <= newC) continue;
+
+      Entry& next = entry(toNd);
+
+      // only improvements are queued. Already settled nodes are reopened,
+      // to allow non-consistent heuristics
+      if (next.reached == _epoch && next.d <= newC) continue;
+
+      // addition done here to avoid it in the PQ
+      auto h = heurFunc(toNd, to);
+      if (costFunc.inf() <= h) continue;
+
+      const C& newH = newC + h;
+
+      if (newH < newC) continue;  // cost overflow!
+
+      size_t toId = toNd->pl().getId();
+
+      if (next.reached != _epoch) {
+        next.reached = _epoch;
+        next.heapPos = NONE;
+        next.n = toNd;
+      }
+
+      next.d = newC;
+      next.h = newH;
+      next.parent = edge;
+
+      if (next.heapPos == NONE) {
+        push(toId);
+      } else {
+        siftUp(next.heapPos);
+      }
+    }
+  }
+
+  return costFunc.inf();
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+void DenseDijkstra<N, E, C>::newEpoch() {
+  for (auto id : _heap) _entries[id].heapPos = NONE;
+  _heap.clear();
+
+  if (++_epoch == 0) {
+    // epoch overflow, invalidate all entries explicitly
+    for (auto& e : _entries) e.reached = e.target = 0;
+    _epoch = 1;
+  }
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+typename DenseDijkstra<N, E, C>::Entry& DenseDijkstra<N, E, C>::entry(
+    const Node<N, E>* n) {
+  size_t id = n->pl().getId();
+  if (id >= _entries.size()) {
+    _entries.resize(id + 1, {0, 0, NONE, C(), C(), 0, 0});
+  }
+  return _entries[id];
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+void DenseDijkstra<N, E, C>::push(size_t id) {
+  _entries[id].heapPos = _heap.size();
+  _heap.push_back(id);
+  siftUp(_heap.size() - 1);
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+size_t DenseDijkstra<N, E, C>::pop() {
+  size_t ret = _heap.front();
+  _entries[ret].heapPos = NONE;
+
+  _heap.front() = _heap.back();
+  _heap.pop_back();
+
+  if (!_heap.empty()) {
+    _entries[_heap.front()].heapPos = 0;
+    siftDown(0);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+void DenseDijkstra<N, E, C>::siftUp(size_t pos) {
+  size_t id = _heap[pos];
+  C h = _entries[id].h;
+
+  while (pos > 0) {
+    size_t parent = (pos - 1) / ARITY;
+    if (!(h < _entries[_heap[parent]].h)) break;
+    _heap[pos] = _heap[parent];
+    _entries[_heap[pos]].heapPos = pos;
+    pos = parent;
+  }
+
+  _heap[pos] = id;
+  _entries[id].heapPos = pos;
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+void DenseDijkstra<N, E, C>::siftDown(size_t pos) {
+  size_t id = _heap[pos];
+  C h = _entries[id].h;
+
+  while (true) {
+    size_t first = pos * ARITY + 1;
+    if (first >= _heap.size()) break;
+
+    size_t last = std::min(first + ARITY, _heap.size());
+    size_t min = first;
+    for (size_t c = first + 1; c < last; c++) {
+      if (_entries[_heap[c]].h < _entries[_heap[min]].h) min = c;
+    }
+
+    if (!(_entries[_heap[min]].h < h)) break;
+
+    _heap[pos] = _heap[min];
+    _entries[_heap[pos]].heapPos = pos;
+    pos = min;
+  }
+
+  _heap[pos] = id;
+  _entries[id].heapPos = pos;
+}
+
+// _____________________________________________________________________________
+template <typename N, typename E, typename C>
+void DenseDijkstra<N, E, C>::buildPath(size_t id, EList* resEdges,
+                                       NList* resNodes) const {
+  while (resNodes || resEdges) {
+    const Entry& cur = _entries[id];
+    if (resNodes) resNodes->push_back(cur.n);
+    if (!cur.parent) break;
+
+    if (resEdges) resEdges->push_back(cur.parent);
+    id = cur.parent->getOtherNd(cur.n)->pl().getId();
+  }
+}
@@ -4,4 +4,4 @@
 
 #include "util/graph/EDijkstra.h"
 
-size_t util::graph::EDijkstra::ITERS = 0;
+thread_local size_t util::graph::EDijkstra::ITERS = 0;
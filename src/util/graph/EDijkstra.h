@@ -230,7 +230,8 @@ class EDijkstra : public ShortestPath<EDijkstra> {
                        const util::graph::CostFunc<N, E, C>& costFunc,
                        PQ<N, E, C>& pq);
 
-  static size_t ITERS;
+  // per thread, searches may run concurrently on the same graph
+  static thread_local size_t ITERS;
 };
 
 #include "util/graph/EDijkstra.tpp"
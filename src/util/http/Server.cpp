@@ -236,9 +236,11 @@ Req HttpServer::getReq(int connection) {
 
     rcvd += curRcvd;
 
+    // header complete, the buffer may already hold parts of the payload
+    if (brk) break;
+
     // buffer is full
     if (rcvd == BSIZE) throw HttpErr("431 Request Header Fields Too Large");
-    if (brk) break;
   }
 
   // POST payload
@@ -260,10 +262,11 @@ Req HttpServer::getReq(int connection) {
       rcvd = 0;
 
       if (rem < size) {
-        while ((curRcvd = read(connection, postBuf + rcvd + rem, size - rem))) {
+        while ((curRcvd = read(connection, postBuf + rcvd + rem,
+                               size - rem - rcvd))) {
           if (curRcvd == -1 && (errno == EAGAIN || errno == EINTR)) continue;
           if (curRcvd == -1) {
-            postBuf[rcvd + 1] = 0;
+            postBuf[rcvd + rem] = 0;
             break;
           }
           rcvd += curRcvd;
@@ -0,0 +1,128 @@
+// Copyright 2016
+// Author: Patrick Brosi
+//
+// Microbenchmark comparing the set based Grid with the flat FlatGrid. Usage:
+// utilGridBench [<number of lines>] [<number of queries>]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "util/geo/FlatGrid.h"
+#include "util/geo/Grid.h"
+
+using util::geo::DBox;
+using util::geo::DLine;
+using util::geo::DPoint;
+using util::geo::FlatGrid;
+using util::geo::Grid;
+using util::geo::Line;
+
+namespace {
+
+const double EXTENT = 100000;
+const double CELL = 200;
+
+// _____________________________________________________________________________
+double msSince(std::chrono::high_resolution_clock::time_point t) {
+  auto d = std::chrono::high_resolution_clock::now() - t;
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// _____________________________________________________________________________
+template <typename GRID>
+void build(GRID* g, const std::vector<DLine>& lines) {
+  for (size_t i = 0; i < lines.size(); i++) g->add(lines[i], i);
+}
+
+// _____________________________________________________________________________
+template <typename GRID>
+size_t querySet(const GRID& g, const std::vector<DBox>& qs) {
+  size_t found = 0;
+  for (const auto& q : qs) {
+    std::set<size_t> res;
+    g.get(q, &res);
+    found += res.size();
+  }
+  return found;
+}
+
+// _____________________________________________________________________________
+size_t queryVisit(const FlatGrid<size_t, Line, double>& g,
+                  const std::vector<DBox>& qs) {
+  size_t found = 0;
+  for (const auto& q : qs) g.visit(q, [&found](size_t) { found++; });
+  return found;
+}
+
+// _____________________________________________________________________________
+template <typename GRID>
+void removeAll(GRID* g, size_t n) {
+  for (size_t i = 0; i < n; i += 2) g->remove(i);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  size_t numLines = argc > 1 ? atol(argv[1]) : 200000;
+  size_t numQueries = argc > 2 ? atol(argv[2]) : 200000;
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> pos(0, EXTENT);
+  std::uniform_real_distribution<double> off(-1000, 1000);
+
+  std::vector<DLine> lines;
+  for (size_t i = 0; i < numLines; i++) {
+    DPoint a(pos(rng), pos(rng));
+    lines.push_back(DLine{a, DPoint(a.getX() + off(rng), a.getY() + off(rng))});
+  }
+
+  std::vector<DBox> qs;
+  for (size_t i = 0; i < numQueries; i++) {
+    DPoint a(pos(rng), pos(rng));
+    qs.push_back(DBox(a, DPoint(a.getX() + 500, a.getY() + 500)));
+  }
+
+  DBox bbox(DPoint(-1000, -1000), DPoint(EXTENT + 1000, EXTENT + 1000));
+
+  auto t = std::chrono::high_resolution_clock::now();
+  Grid<size_t, Line, double> grid(CELL, CELL, bbox);
+  build(&grid, lines);
+  std::cout << "Grid      build:        " << msSince(t) << " ms" << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  size_t a = querySet(grid, qs);
+  std::cout << "Grid      set queries:  " << msSince(t) << " ms (" << a
+            << " results)" << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  removeAll(&grid, numLines);
+  std::cout << "Grid      removal:      " << msSince(t) << " ms" << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  FlatGrid<size_t, Line, double> flat(CELL, CELL, bbox);
+  build(&flat, lines);
+  flat.compact();
+  std::cout << "FlatGrid  build:        " << msSince(t) << " ms" << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  size_t b = querySet(flat, qs);
+  std::cout << "FlatGrid  set queries:  " << msSince(t) << " ms (" << b
+            << " results)" << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  size_t c = queryVisit(flat, qs);
+  std::cout << "FlatGrid  visit:        " << msSince(t) << " ms (" << c
+            << " results)" << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  removeAll(&flat, numLines);
+  std::cout << "FlatGrid  removal:      " << msSince(t) << " ms" << std::endl;
+
+  if (a != b || a != c) {
+    std::cerr << "Result mismatch!" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
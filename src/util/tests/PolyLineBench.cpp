@@ -0,0 +1,107 @@
+// Copyright 2016
+// Author: Patrick Brosi
+//
+// Microbenchmark for the positional queries of PolyLine on shapes of
+// realistic sizes, compared against a walk over the line from its start.
+// Usage: utilPolyLineBench [<number of queries per shape>]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "util/geo/PolyLine.h"
+
+using util::geo::DLine;
+using util::geo::DPoint;
+using util::geo::PolyLine;
+
+namespace {
+
+// _____________________________________________________________________________
+double msSince(std::chrono::high_resolution_clock::time_point t) {
+  auto d = std::chrono::high_resolution_clock::now() - t;
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// _____________________________________________________________________________
+DPoint walkPointAt(const DLine& l, double at) {
+  double len = util::geo::len(l);
+  double atDist = at * len;
+  double d = 0;
+  for (size_t i = 1; i < l.size(); i++) {
+    double segLen = util::geo::dist(l[i - 1], l[i]);
+    if (d + segLen > atDist) {
+      double p = (atDist - d) / segLen;
+      return DPoint(l[i - 1].getX() + (l[i].getX() - l[i - 1].getX()) * p,
+                    l[i - 1].getY() + (l[i].getY() - l[i - 1].getY()) * p);
+    }
+    d += segLen;
+  }
+  return l.back();
+}
+
+// _____________________________________________________________________________
+PolyLine<double> randomShape(size_t n, std::mt19937* rng) {
+  std::uniform_real_distribution<double> step(5, 50);
+  std::uniform_real_distribution<double> turn(-0.3, 0.3);
+
+  PolyLine<double> ret;
+  DPoint cur(0, 0);
+  double ang = 0;
+  for (size_t i = 0; i < n; i++) {
+    ret << cur;
+    ang += turn(*rng);
+    double s = step(*rng);
+    cur = DPoint(cur.getX() + cos(ang) * s, cur.getY() + sin(ang) * s);
+  }
+  return ret;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  size_t numQueries = argc > 1 ? atol(argv[1]) : 10000;
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> pos(0, 1);
+
+  for (size_t n : {100, 1000, 10000}) {
+    auto a = randomShape(n, &rng);
+    auto b = randomShape(n, &rng);
+
+    std::vector<double> qs;
+    for (size_t i = 0; i < numQueries; i++) qs.push_back(pos(rng));
+
+    auto t = std::chrono::high_resolution_clock::now();
+    double sumWalk = 0;
+    for (double q : qs) sumWalk += walkPointAt(a.getLine(), q).getX();
+    std::cout << n << " points, walk getPointAt:  " << msSince(t) << " ms"
+              << std::endl;
+
+    t = std::chrono::high_resolution_clock::now();
+    double sum = 0;
+    for (double q : qs) sum += a.getPointAt(q).p.getX();
+    std::cout << n << " points, getPointAt:       " << msSince(t) << " ms"
+              << std::endl;
+
+    t = std::chrono::high_resolution_clock::now();
+    double segLen = 0;
+    for (size_t i = 0; i + 1 < qs.size(); i += 2) {
+      segLen += a.getSegment(qs[i], qs[i + 1]).getLength();
+    }
+    std::cout << n << " points, getSegment:       " << msSince(t) << " ms"
+              << std::endl;
+
+    t = std::chrono::high_resolution_clock::now();
+    auto avg = PolyLine<double>::average({&a, &b});
+    std::cout << n << " points, average:          " << msSince(t) << " ms ("
+              << avg.getLine().size() << " points)" << std::endl;
+
+    if (fabs(sum - sumWalk) > 0.001 * numQueries || segLen <= 0) {
+      std::cerr << "Result mismatch!" << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -8,14 +8,18 @@
 #include "util/String.h"
 #include "util/tests/QuadTreeTest.h"
 #include "util/geo/Geo.h"
+#include "util/geo/FlatGrid.h"
 #include "util/geo/Grid.h"
+#include "util/geo/PolyLine.h"
 #include "util/graph/Algorithm.h"
 #include "util/graph/Dijkstra.h"
 #include "util/graph/BiDijkstra.h"
+#include "util/graph/DenseDijkstra.h"
 #include "util/graph/DirGraph.h"
 #include "util/graph/EDijkstra.h"
 #include "util/graph/UndirGraph.h"
 #include "util/json/Writer.h"
+#include "util/xml/XmlWriter.h"
 
 using namespace util;
 using namespace util::geo;
@@ -152,6 +156,59 @@ int main(int argc, char** argv) {
             ss.str() == "[1,[2.13,{\"B\":2.12,\"a\":1},4],0]"));
   }
 
+  // ___________________________________________________________________________
+  {
+    std::stringstream ss;
+    {
+      util::xml::XmlWriter w(&ss);
+      w.openTag("svg", "id", "a\"b");
+      w.openTag("polyline");
+      w.attr("class", "x<y");
+      w.attr("r", 2.0, 2);
+      w.openAttr("points");
+      w.writeFloat(1.005, 2);
+      w.writeAttrVal(',');
+      w.writeFloat(-0.001, 2);
+      w.writeAttrVal(' ');
+      w.writeFloat(123456.789, 2);
+      w.writeAttrVal(',');
+      w.writeFloat(0.5, 0);
+      w.closeAttr();
+      w.closeTag();
+      w.openTag("text");
+      w.writeText("a&b");
+
+      // output is buffered until flushed
+      TEST(ss.str(), ==, "");
+    }
+
+    TEST(ss.str(), ==,
+         "<svg id=\"a&quot;b\"><polyline class=\"x&lt;y\" r=\"2\" "
+         "points=\"1,0 123456.79,1\" /><text>a&amp;b");
+
+    ss.str("");
+    util::xml::XmlWriter w(&ss);
+    bool thrown = false;
+    try {
+      w.attr("a", "b");
+    } catch (const util::xml::XmlWriterException&) {
+      thrown = true;
+    }
+    TEST(thrown);
+
+    w.openTag("a");
+    w.writeText("b");
+    thrown = false;
+    try {
+      w.attr("a", "b");
+    } catch (const util::xml::XmlWriterException&) {
+      thrown = true;
+    }
+    TEST(thrown);
+    w.closeTags();
+    TEST(ss.str(), ==, "<a>b</a>");
+  }
+
   // ___________________________________________________________________________
   {
     DirGraph<int, int> g;
@@ -269,6 +326,78 @@ int main(int argc, char** argv) {
     // TODO: more test cases
   }
 
+  // ___________________________________________________________________________
+  {
+    FlatGrid<int, Line, double> g(
+        .5, .5, Box<double>(Point<double>(0, 0), Point<double>(3, 3)));
+
+    Line<double> l;
+    l.push_back(Point<double>(0, 0));
+    l.push_back(Point<double>(1.5, 2));
+
+    Line<double> l2;
+    l2.push_back(Point<double>(2.5, 1));
+    l2.push_back(Point<double>(2.5, 2));
+
+    g.add(l, 1);
+    g.compact();
+    g.add(l2, 2);
+
+    std::set<int> ret;
+
+    Box<double> req(Point<double>(.5, 1), Point<double>(1, 1.5));
+    g.get(req, &ret);
+    TEST(ret.size(), ==, (size_t)1);
+
+    ret.clear();
+    g.getNeighbors(1, 0, &ret);
+    TEST(ret.size(), ==, (size_t)1);
+
+    ret.clear();
+    g.getNeighbors(1, 0.55, &ret);
+    TEST(ret.size(), ==, (size_t)2);
+
+    // every value is visited once, although it spans multiple cells
+    std::vector<int> visited;
+    Box<double> all(Point<double>(0, 0), Point<double>(3, 3));
+    g.visit(all, [&](int v) { visited.push_back(v); });
+    TEST(visited.size(), ==, (size_t)2);
+
+    visited.clear();
+    g.visit(all, [&](int v) { visited.push_back(v); });
+    TEST(visited.size(), ==, (size_t)2);
+
+    TEST(g.getCells(2).size(), ==, (size_t)3);
+
+    g.remove(1);
+    ret.clear();
+    g.get(all, &ret);
+    TEST(ret.size(), ==, (size_t)1);
+    TEST(*ret.begin(), ==, 2);
+
+    g.compact();
+    g.remove(2);
+    ret.clear();
+    g.get(all, &ret);
+    TEST(ret.size(), ==, (size_t)0);
+
+    g.add(l, 1);
+    ret.clear();
+    g.get(req, &ret);
+    TEST(ret.size(), ==, (size_t)1);
+
+    FlatGrid<int, Line, double> h(
+        .5, .5, Box<double>(Point<double>(0, 0), Point<double>(3, 3)), false);
+    h.add(l, 1);
+    h.add(l2, 2);
+    h.remove(1);
+
+    visited.clear();
+    h.visit(all, [&](int v) { visited.push_back(v); });
+    TEST(visited.size(), ==, (size_t)1);
+    TEST(visited[0], ==, 2);
+  }
+
   // ___________________________________________________________________________
   {
     Line<double> a;
@@ -297,6 +426,68 @@ int main(int argc, char** argv) {
     TEST(dense.size(), ==, (size_t)3);
   }
 
+  // ___________________________________________________________________________
+  {
+    PolyLine<double> pl;
+    pl << Point<double>(0, 0) << Point<double>(10, 0) << Point<double>(10, 10);
+
+    TEST(pl.getLength(), ==, approx(20));
+    TEST(pl.getPointAtDist(5).p.getX(), ==, approx(5));
+    TEST(pl.getPointAtDist(5).lastIndex, ==, (size_t)0);
+    TEST(pl.getPointAtDist(15).p.getY(), ==, approx(5));
+    TEST(pl.getPointAtDist(15).lastIndex, ==, (size_t)1);
+    TEST(pl.getPointAt(0.75).p.getY(), ==, approx(5));
+    TEST(pl.getPointAtDist(10).p.getX(), ==, approx(10));
+    TEST(pl.getPointAtDist(30).p.getY(), ==, approx(10));
+
+    // the lengths follow modifications of the line
+    pl >> Point<double>(0, -10);
+    TEST(pl.getLength(), ==, approx(30));
+    TEST(pl.getPointAtDist(15).p.getX(), ==, approx(5));
+
+    pl.reverse();
+    TEST(pl.getPointAtDist(5).p.getY(), ==, approx(5));
+    TEST(pl.getPointAtDist(25).p.getY(), ==, approx(-5));
+
+    pl.move(5, 5);
+    TEST(pl.getPointAtDist(25).p.getY(), ==, approx(0));
+
+    pl.simplify(0);
+    TEST(pl.getLength(), ==, approx(30));
+
+    auto seg = pl.getSegment(0.25, 0.75);
+    TEST(seg.getLength(), ==, approx(15));
+    TEST(seg.getLine().size(), ==, (size_t)4);
+    TEST(seg.getPointAtDist(7.5).p.getX(), ==, approx(10));
+
+    // segments drop collinear points, but keep points where the line turns
+    // back on itself
+    PolyLine<double> col;
+    col << Point<double>(0, 0) << Point<double>(5, 0) << Point<double>(10, 0)
+        << Point<double>(10, 0) << Point<double>(10, 10)
+        << Point<double>(10, 5);
+    seg = col.getSegmentAtDist(1, 24);
+    TEST(seg.getLine().size(), ==, (size_t)4);
+    TEST(seg.getLine()[1].getX(), ==, approx(10));
+    TEST(seg.getLine()[1].getY(), ==, approx(0));
+    TEST(seg.getLine()[2].getY(), ==, approx(10));
+    TEST(seg.getLength(), ==, approx(23));
+
+    PolyLine<double> simple(col.getLine());
+    simple.simplify(0);
+    TEST(col.getSegment(0, 1).getLine().size(), ==, simple.getLine().size());
+
+    seg = col.getSegmentAtDist(2, 2);
+    TEST(seg.getLine().size(), ==, (size_t)2);
+
+    PolyLine<double> a(Point<double>(0, 0), Point<double>(100, 0));
+    PolyLine<double> b(Point<double>(0, 10), Point<double>(100, 10));
+    b >> Point<double>(0, 10);
+    auto avg = PolyLine<double>::average({&a, &b});
+    TEST(avg.getLength(), ==, approx(100));
+    TEST(avg.getPointAt(0.5).p.getY(), ==, approx(5));
+  }
+
   // ___________________________________________________________________________
   {
     Line<double> a;
@@ -1081,6 +1272,81 @@ int main(int argc, char** argv) {
     TEST(costs[x], ==, 999);
   }
 
+  // ___________________________________________________________________________
+  {
+    struct IdPl {
+      size_t id;
+      size_t getId() const { return id; }
+    };
+
+    // a 10x10 grid with pseudo-random edge costs in both directions
+    DirGraph<IdPl, int> g;
+    std::vector<Node<IdPl, int>*> nds;
+    for (size_t i = 0; i < 100; i++) nds.push_back(g.addNd(IdPl{i}));
+
+    for (size_t i = 0; i < 100; i++) {
+      if (i % 10 != 9) {
+        g.addEdg(nds[i], nds[i + 1], (i * 7) % 5 + 1);
+        g.addEdg(nds[i + 1], nds[i], (i * 3) % 4 + 1);
+      }
+      if (i < 90) {
+        g.addEdg(nds[i], nds[i + 10], (i * 11) % 6 + 1);
+        g.addEdg(nds[i + 10], nds[i], (i * 5) % 3 + 1);
+      }
+    }
+
+    struct CostFunc : public Dijkstra::CostFunc<IdPl, int, int> {
+      int operator()(const Node<IdPl, int>* fr, const Edge<IdPl, int>* e,
+                     const Node<IdPl, int>* to) const {
+        UNUSED(fr);
+        UNUSED(to);
+        return e->pl();
+      };
+      int inf() const { return 999; };
+    };
+
+    CostFunc cFunc;
+    ZeroHeurFunc<IdPl, int, int> hFunc;
+
+    // the same instance is re-used for all queries
+    DenseDijkstra<IdPl, int, int> dense;
+
+    for (size_t i = 0; i < 100; i += 7) {
+      for (size_t j = 0; j < 100; j += 3) {
+        std::set<Node<IdPl, int>*> from{nds[i]};
+        std::set<Node<IdPl, int>*> to{nds[j], nds[99 - j]};
+
+        Dijkstra::EList<IdPl, int> resE;
+        DenseDijkstra<IdPl, int, int>::EList resEDense;
+        DenseDijkstra<IdPl, int, int>::NList resNDense;
+
+        int cost = Dijkstra::shortestPath(from, to, cFunc, hFunc, &resE,
+                                          (Dijkstra::NList<IdPl, int>*)0);
+        int costDense =
+            dense.shortestPath(from, to, cFunc, hFunc, &resEDense, &resNDense);
+
+        TEST(costDense, ==, cost);
+        TEST(resNDense.size(), ==, resEDense.size() + 1);
+        TEST(resNDense.back(), ==, nds[i]);
+
+        int pathCost = 0;
+        for (auto e : resEDense) pathCost += e->pl();
+        TEST(pathCost, ==, cost);
+      }
+    }
+
+    // a cutoff below the shortest path cost
+    struct CutCostFunc : public CostFunc {
+      int inf() const { return 3; };
+    };
+
+    std::set<Node<IdPl, int>*> from{nds[0]};
+    std::set<Node<IdPl, int>*> to{nds[99]};
+    DenseDijkstra<IdPl, int, int>::NList res;
+    TEST(dense.shortestPath(from, to, CutCostFunc(), hFunc, 0, &res), ==, 3);
+    TEST(res.size(), ==, (size_t)0);
+  }
+
   // ___________________________________________________________________________
   {{util::Nullable<std::string> nullable;
   TEST(nullable.isNull());
@@ -3,11 +3,15 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
 #include <map>
 #include <ostream>
 #include <stack>
 #include <string>
 #include "XmlWriter.h"
+#include "util/3rdparty/dtoa_milo.h"
 
 using namespace util;
 using namespace xml;
@@ -16,17 +20,22 @@ using std::ostream;
 using std::string;
 using std::map;
 
+const static size_t BUF_SIZE = 1 << 20;
+const static double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                               1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
 // _____________________________________________________________________________
-XmlWriter::XmlWriter(std::ostream* out)
-    : _out(out), _pretty(false), _indent(4) {}
+XmlWriter::XmlWriter(std::ostream* out) : XmlWriter(out, false, 4) {}
 
 // _____________________________________________________________________________
 XmlWriter::XmlWriter(std::ostream* out, bool pret)
-    : _out(out), _pretty(pret), _indent(4) {}
+    : XmlWriter(out, pret, 4) {}
 
 // _____________________________________________________________________________
 XmlWriter::XmlWriter(std::ostream* out, bool pret, size_t indent)
-    : _out(out), _pretty(pret), _indent(indent) {}
+    : _out(out), _inAttr(false), _pretty(pret), _indent(indent) {
+  _buf.reserve(BUF_SIZE + BUF_SIZE / 4);
+}
 
 // _____________________________________________________________________________
 void XmlWriter::openTag(const string& tag, const map<string, string>& attrs) {
@@ -36,21 +45,97 @@ void XmlWriter::openTag(const string& tag, const map<string, string>& attrs) {
 
   checkTagName(tag);
   closeHanging();
+  checkFlush();
   doIndent();
 
-  *_out << "<" << tag;
+  _buf += '<';
+  _buf += tag;
 
-  for (auto kv : attrs) {
-    *_out << " ";
-    putEsced(_out, kv.first, '"');
-    *_out << "=\"";
-    putEsced(_out, kv.second, '"');
-    *_out << "\"";
+  for (const auto& kv : attrs) {
+    _buf += ' ';
+    putEsced(kv.first, '"');
+    _buf += "=\"";
+    putEsced(kv.second, '"');
+    _buf += '"';
   }
 
   _nstack.push(XmlNode(TAG, tag, true));
 }
 
+// _____________________________________________________________________________
+void XmlWriter::attr(const char* key, const std::string& val) {
+  openAttr(key);
+  putEsced(val, '"');
+  closeAttr();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::attr(const char* key, double val, size_t digits) {
+  openAttr(key);
+  writeFloat(val, digits);
+  closeAttr();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::openAttr(const char* key) {
+  checkAttr();
+  _buf += ' ';
+  _buf += key;
+  _buf += "=\"";
+  _inAttr = true;
+}
+
+// _____________________________________________________________________________
+void XmlWriter::writeAttrVal(const std::string& val) {
+  if (!_inAttr) throw XmlWriterException("No attribute opened.");
+  putEsced(val, '"');
+}
+
+// _____________________________________________________________________________
+void XmlWriter::writeAttrVal(char c) {
+  if (!_inAttr) throw XmlWriterException("No attribute opened.");
+  if (c == '"' || c == '<' || c == '>' || c == '&') {
+    putEsced(std::string(1, c), '"');
+  } else {
+    _buf += c;
+  }
+}
+
+// _____________________________________________________________________________
+void XmlWriter::closeAttr() {
+  if (!_inAttr) throw XmlWriterException("No attribute opened.");
+  _buf += '"';
+  _inAttr = false;
+}
+
+// _____________________________________________________________________________
+void XmlWriter::writeFloat(double val, size_t digits) {
+  if (!_inAttr) throw XmlWriterException("No attribute opened.");
+  assert(digits < sizeof(POW10) / sizeof(POW10[0]));
+
+  // shortest representation of the rounded value, which has at most the
+  // requested number of decimal digits
+  if (!std::isfinite(val)) {
+    _buf += std::to_string(val);
+    return;
+  }
+
+  // values too large to carry the requested decimal digits are exact anyway
+  if (std::fabs(val) < POW10[15] / POW10[digits]) {
+    val = std::round(val * POW10[digits]) / POW10[digits];
+  }
+
+  char buf[32];
+  util::dtoa_milo(val, buf);
+
+  size_t l = strlen(buf);
+
+  // integral values are written as x.0
+  if (l > 2 && buf[l - 2] == '.' && buf[l - 1] == '0') l -= 2;
+
+  _buf.append(buf, l);
+}
+
 // _____________________________________________________________________________
 void XmlWriter::openTag(const string& tag) {
   openTag(tag, map<string, string>());
@@ -71,7 +156,7 @@ void XmlWriter::openComment() {
   closeHanging();
   doIndent();
 
-  *_out << "<!-- ";
+  _buf += "<!-- ";
 
   _nstack.push(XmlNode(COMMENT, "", false));
 }
@@ -82,8 +167,9 @@ void XmlWriter::writeText(const string& text) {
     throw XmlWriterException("Text content not allowed in prolog / trailing.");
   }
   closeHanging();
+  checkFlush();
   doIndent();
-  putEsced(_out, text, ' ');
+  putEsced(text, ' ');
 }
 
 // _____________________________________________________________________________
@@ -95,16 +181,18 @@ void XmlWriter::closeTag() {
   if (_nstack.top().t == COMMENT) {
     _nstack.pop();
     doIndent();
-    *_out << " -->";
+    _buf += " -->";
   } else if (_nstack.top().t == TAG) {
     if (_nstack.top().hanging) {
-      *_out << " />";
+      _buf += " />";
       _nstack.pop();
     } else {
       string tag = _nstack.top().pload;
       _nstack.pop();
       doIndent();
-      *_out << "</" << tag << ">";
+      _buf += "</";
+      _buf += tag;
+      _buf += '>';
     }
   }
 }
@@ -112,13 +200,35 @@ void XmlWriter::closeTag() {
 // _____________________________________________________________________________
 void XmlWriter::closeTags() {
   while (!_nstack.empty()) closeTag();
+  flush();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::flush() {
+  if (_buf.empty()) return;
+  _out->write(_buf.data(), _buf.size());
+  _buf.clear();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::checkFlush() {
+  if (_buf.size() > BUF_SIZE) flush();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::checkAttr() const {
+  if (_inAttr) throw XmlWriterException("Attribute not closed.");
+  if (_nstack.empty() || _nstack.top().t != TAG || !_nstack.top().hanging) {
+    throw XmlWriterException(
+        "Attributes only allowed directly after opening a tag.");
+  }
 }
 
 // _____________________________________________________________________________
 void XmlWriter::doIndent() {
   if (_pretty) {
-    *_out << std::endl;
-    for (size_t i = 0; i < _nstack.size() * _indent; i++) *_out << " ";
+    _buf += '\n';
+    _buf.append(_nstack.size() * _indent, ' ');
   }
 }
 
@@ -126,8 +236,10 @@ void XmlWriter::doIndent() {
 void XmlWriter::closeHanging() {
   if (_nstack.empty()) return;
 
+  if (_inAttr) throw XmlWriterException("Attribute not closed.");
+
   if (_nstack.top().hanging) {
-    *_out << ">";
+    _buf += '>';
     _nstack.top().hanging = false;
   } else if (_nstack.top().t == TEXT) {
     _nstack.pop();
@@ -135,25 +247,25 @@ void XmlWriter::closeHanging() {
 }
 
 // _____________________________________________________________________________
-void XmlWriter::putEsced(ostream* out, const string& str, char quot) {
+void XmlWriter::putEsced(const string& str, char quot) {
   if (!_nstack.empty() && _nstack.top().t == COMMENT) {
-    *out << str;
+    _buf += str;
     return;
   }
 
   for (const char& c : str) {
     if (quot == '"' && c == '"')
-      *out << "&quot;";
+      _buf += "&quot;";
     else if (quot == '\'' && c == '\'')
-      *out << "&apos;";
+      _buf += "&apos;";
     else if (c == '<')
-      *out << "&lt;";
+      _buf += "&lt;";
     else if (c == '>')
-      *out << "&gt;";
+      _buf += "&gt;";
     else if (c == '&')
-      *out << "&amp;";
+      _buf += "&amp;";
     else
-      *out << c;
+      _buf += c;
   }
 }
 
@@ -24,13 +24,14 @@ class XmlWriterException : public std::exception {
   std::string _msg;
 };
 
-// simple XML writer class without much overhead
+// simple XML writer class without much overhead, output is collected in a
+// reusable buffer which is written to the stream in large chunks
 class XmlWriter {
  public:
   explicit XmlWriter(std::ostream* out);
   XmlWriter(std::ostream* out, bool pretty);
   XmlWriter(std::ostream* out, bool pretty, size_t indent);
-  ~XmlWriter(){};
+  ~XmlWriter() { flush(); };
 
   // open tag without attributes
   void openTag(const std::string& tag);
@@ -43,6 +44,22 @@ class XmlWriter {
   void openTag(const std::string& tag,
                const std::map<std::string, std::string>& attrs);
 
+  // add an attribute to the tag opened last, only allowed before any content
+  // of this tag was written
+  void attr(const char* key, const std::string& val);
+  void attr(const char* key, double val, size_t digits);
+
+  // write an attribute value piece by piece, between openAttr() and
+  // closeAttr() only writeAttrVal() and writeFloat() are allowed
+  void openAttr(const char* key);
+  void writeAttrVal(const std::string& val);
+  void writeAttrVal(char c);
+  void closeAttr();
+
+  // write val rounded to the given number of decimal digits, trailing zeros
+  // are omitted
+  void writeFloat(double val, size_t digits);
+
   // open comment
   void openComment();
 
@@ -55,6 +72,9 @@ class XmlWriter {
   // close all open tags, essentially closing the document
   void closeTags();
 
+  // write the buffered output to the stream
+  void flush();
+
  private:
   enum XML_NODE_T { TAG, TEXT, COMMENT };
 
@@ -69,6 +89,9 @@ class XmlWriter {
   std::ostream* _out;
   std::stack<XmlNode> _nstack;
 
+  std::string _buf;
+  bool _inAttr;
+
   bool _pretty;
   size_t _indent;
 
@@ -78,8 +101,14 @@ class XmlWriter {
   // close "hanging" tags
   void closeHanging();
 
-  // pushes XML escaped text to stream
-  void putEsced(std::ostream* out, const std::string& str, char quot);
+  // pushes XML escaped text to the buffer
+  void putEsced(const std::string& str, char quot);
+
+  // flushes the buffer if it is full
+  void checkFlush();
+
+  // throws if no attribute can be added
+  void checkAttr() const;
 
   // checks tag names for validiy
   void checkTagName(const std::string& str) const;